@@ -0,0 +1,613 @@
+/*
+ * Copyright (C) 2014 LNLS (www.lnls.br)
+ * Author: Lucas Russo <lucas.russo@lnls.br>
+ *
+ * Released according to the GNU GPL, version 3 or any later version.
+ */
+
+/* Description: End-to-end benchmark of a running HALCS instance, through
+ * the broker. Results are written as JSON */
+
+#include <getopt.h>
+#include <czmq.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <halcs_client.h>
+
+#define DFLT_BIND_FOLDER            "/tmp/halcs"
+
+#define DFLT_HALCS_NUMBER           0
+#define MAX_HALCS_NUMBER            1
+
+#define DFLT_BOARD_NUMBER           1
+
+#define DFLT_NUM_THREADS            4
+#define MAX_NUM_THREADS             64
+#define DFLT_NUM_ITER               1000
+#define DFLT_NUM_SAMPLES            16384
+#define MIN_NUM_SAMPLES             4
+/* Arbitrary hard limits */
+#define MAX_NUM_SAMPLES             (1 << 24)
+#define DFLT_NUM_CURVES             10
+
+#define BENCH_TIMEOUT               50000       /* in ms */
+#define NSECS_PER_SEC               1000000000ULL
+
+/* Operations measured from the client threads */
+typedef enum {
+    BENCH_PARAM_READ = 0,                       /* param_client_read () on a register */
+    BENCH_PARAM_WRITE,                          /* param_client_write () on a register */
+    BENCH_PARAM_LOCAL_READ,                     /* param_client_read (), no register access */
+    BENCH_FUNC_EXEC,                            /* halcs_func_exec () */
+    END_BENCH_OP
+} bench_op_e;
+
+static const char *bench_op_names [END_BENCH_OP] = {
+    [BENCH_PARAM_READ]          = "param_client_read",
+    [BENCH_PARAM_WRITE]         = "param_client_write",
+    [BENCH_PARAM_LOCAL_READ]    = "param_client_read_local",
+    [BENCH_FUNC_EXEC]           = "halcs_func_exec",
+};
+
+/* Latency statistics, in ns */
+typedef struct {
+    uint64_t num_ops;
+    uint64_t num_errors;
+    double ops_per_sec;
+    uint64_t min;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+} bench_stats_t;
+
+/* Per-thread state */
+typedef struct {
+    char *broker_endp;
+    char *service;
+    bench_op_e op;
+    uint32_t num_iter;
+    uint64_t *latencies;                        /* One per iteration */
+    uint64_t num_errors;
+    int err;                                    /* Could not run at all */
+} bench_thread_t;
+
+static struct option long_options[] =
+{
+    {"help",                no_argument,         NULL, 'h'},
+    {"brokerendp",          required_argument,   NULL, 'b'},
+    {"verbose",             no_argument,         NULL, 'v'},
+    {"halcsnumber",         required_argument,   NULL, 's'},
+    {"boardslot",           required_argument,   NULL, 'o'},
+    {"threads",             required_argument,   NULL, 't'},
+    {"iterations",          required_argument,   NULL, 'n'},
+    {"numsamples",          required_argument,   NULL, 'c'},
+    {"curves",              required_argument,   NULL, 'r'},
+    {"brokerpid",           required_argument,   NULL, 'p'},
+    {"output",              required_argument,   NULL, 'j'},
+    {NULL, 0, NULL, 0}
+};
+
+static const char* shortopt = "hb:vs:o:t:n:c:r:p:j:";
+
+void print_help (char *program_name)
+{
+    fprintf (stdout, "HALCSD Benchmark Utility\n"
+            "Usage: %s [options]\n"
+            "\n"
+            "  -h  --help                           Display this usage information\n"
+            "  -b  --brokerendp <Broker endpoint>   Broker endpoint\n"
+            "  -v  --verbose                        Verbose output\n"
+            "  -o  --boardslot <Board slot number = [1-12]> \n"
+            "                                       Board slot number\n"
+            "  -s  --halcsnumber <HALCS number = [0|1]> HALCS number\n"
+            "  -t  --threads <Number of threads>    Client threads (default: %u)\n"
+            "  -n  --iterations <Iterations>        Operations per thread (default: %u)\n"
+            "  -c  --numsamples <Number of samples> Samples per curve (default: %u)\n"
+            "  -r  --curves <Number of curves>      Curves read per channel (default: %u)\n"
+            "  -p  --brokerpid <PID>                Broker PID, to report its CPU usage\n"
+            "  -j  --output <JSON file>             Results file (default: stdout)\n",
+            program_name, DFLT_NUM_THREADS, DFLT_NUM_ITER, DFLT_NUM_SAMPLES,
+            DFLT_NUM_CURVES);
+}
+
+static uint64_t _now_ns (void)
+{
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * NSECS_PER_SEC + now.tv_nsec;
+}
+
+/* Broker user + system CPU time, in ns. Returns 0 if not available */
+static uint64_t _proc_cpu_ns (int pid)
+{
+    char path [64];
+    snprintf (path, sizeof (path), "/proc/%d/stat", pid);
+    FILE *fp = fopen (path, "r");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    unsigned long utime = 0;
+    unsigned long stime = 0;
+    /* Fields 14 and 15. The process name (field 2) has no spaces
+     * for the broker */
+    int matches = fscanf (fp, "%*d %*s %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+            &utime, &stime);
+    fclose (fp);
+
+    if (matches != 2) {
+        return 0;
+    }
+
+    return (uint64_t) (utime + stime) * (NSECS_PER_SEC / sysconf (_SC_CLK_TCK));
+}
+
+static int _cmp_u64 (const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+/* Sorts latencies */
+static void _compute_stats (uint64_t *latencies, uint64_t num_ops,
+        uint64_t num_errors, uint64_t elapsed_ns, bench_stats_t *stats)
+{
+    memset (stats, 0, sizeof (*stats));
+    stats->num_ops = num_ops;
+    stats->num_errors = num_errors;
+
+    if (num_ops == 0) {
+        return;
+    }
+
+    qsort (latencies, num_ops, sizeof (*latencies), _cmp_u64);
+    stats->ops_per_sec = (double) num_ops * NSECS_PER_SEC / elapsed_ns;
+    stats->min = latencies [0];
+    stats->p50 = latencies [num_ops*50/100];
+    stats->p90 = latencies [num_ops*90/100];
+    stats->p99 = latencies [num_ops*99/100];
+    stats->p999 = latencies [num_ops*999/1000];
+    stats->max = latencies [num_ops-1];
+}
+
+static halcs_client_err_e _run_op (halcs_client_t *client, char *service,
+        bench_op_e op, const disp_op_t *func)
+{
+    uint32_t value = 0;
+
+    switch (op) {
+        case BENCH_PARAM_READ:
+            return halcs_get_acq_trig (client, service, &value);
+
+        case BENCH_PARAM_WRITE:
+            /* Skip trigger, i.e., the current one */
+            return halcs_set_acq_trig (client, service, 0);
+
+        case BENCH_PARAM_LOCAL_READ:
+            /* Served from the SMIO memory, with no THSAFE access */
+            return halcs_get_acq_cache_size (client, service, &value);
+
+        case BENCH_FUNC_EXEC:
+            return halcs_func_exec (client, func, service, NULL, NULL);
+
+        default:
+            return HALCS_CLIENT_ERR_INV_FUNCTION;
+    }
+}
+
+static void *_bench_thread (void *arg)
+{
+    bench_thread_t *th = (bench_thread_t *) arg;
+
+    halcs_client_t *client = halcs_client_new_time (th->broker_endp, 0, NULL,
+            BENCH_TIMEOUT);
+    if (client == NULL) {
+        th->err = -1;
+        return NULL;
+    }
+
+    /* Translate once, as a real client issuing the same function would */
+    const disp_op_t *func = halcs_func_translate (ACQ_NAME_CHECK_DATA_ACQUIRE);
+
+    for (uint32_t i = 0; i < th->num_iter && !zsys_interrupted; ++i) {
+        uint64_t start = _now_ns ();
+        halcs_client_err_e err = _run_op (client, th->service, th->op, func);
+        th->latencies [i] = _now_ns () - start;
+
+        if (err != HALCS_CLIENT_SUCCESS) {
+            th->num_errors++;
+        }
+    }
+
+    halcs_client_destroy (&client);
+    return NULL;
+}
+
+/* Run op from num_threads clients at once */
+static int _bench_op (char *broker_endp, char *service, bench_op_e op,
+        uint32_t num_threads, uint32_t num_iter, bench_stats_t *stats)
+{
+    int err = 0;
+    bench_thread_t threads [MAX_NUM_THREADS];
+    pthread_t tids [MAX_NUM_THREADS];
+    uint64_t *latencies = (uint64_t *) zmalloc ((size_t) num_threads*num_iter*
+            sizeof (*latencies));
+    if (latencies == NULL) {
+        fprintf (stderr, "[client:bench]: Could not allocate latencies\n");
+        return -1;
+    }
+
+    uint64_t start = _now_ns ();
+    uint32_t i;
+    for (i = 0; i < num_threads; ++i) {
+        threads [i] = (bench_thread_t) {
+            .broker_endp = broker_endp,
+            .service = service,
+            .op = op,
+            .num_iter = num_iter,
+            .latencies = latencies + (size_t) i*num_iter,
+        };
+
+        if (pthread_create (&tids [i], NULL, _bench_thread, &threads [i]) != 0) {
+            fprintf (stderr, "[client:bench]: Could not create thread\n");
+            err = -1;
+            break;
+        }
+    }
+
+    uint64_t num_errors = 0;
+    uint32_t num_started = i;
+    for (i = 0; i < num_started; ++i) {
+        pthread_join (tids [i], NULL);
+        num_errors += threads [i].num_errors;
+        if (threads [i].err != 0) {
+            err = -1;
+        }
+    }
+    uint64_t elapsed = _now_ns () - start;
+
+    if (err == 0) {
+        _compute_stats (latencies, (uint64_t) num_threads*num_iter,
+                num_errors, elapsed, stats);
+    }
+
+    free (latencies);
+    return err;
+}
+
+/* MB/s of halcs_acq_get_curve () for chan. Returns a negative value on
+ * error */
+static double _bench_curve (halcs_client_t *client, char *service,
+        uint32_t chan, uint32_t num_samples, uint32_t num_curves)
+{
+    uint32_t data_size = num_samples*acq_chan[chan].sample_size;
+    uint32_t *data = (uint32_t *) zmalloc (data_size);
+    if (data == NULL) {
+        return -1;
+    }
+
+    double mbps = -1;
+    acq_trans_t acq_trans = {.req =   {
+                                        .num_samples_pre = num_samples,
+                                        .num_samples_post = 0,
+                                        .num_shots = 1,
+                                        .chan = chan,
+                                      },
+                             .block = {
+                                        .data = data,
+                                        .data_size = data_size,
+                                      }
+                            };
+
+    halcs_client_err_e err = halcs_acq_start (client, service, &acq_trans.req);
+    if (err != HALCS_CLIENT_SUCCESS) {
+        fprintf (stderr, "[client:bench]: halcs_acq_start failed for channel %u\n", chan);
+        goto err_exit;
+    }
+
+    err = halcs_acq_check_timed (client, service, BENCH_TIMEOUT);
+    if (err != HALCS_CLIENT_SUCCESS) {
+        fprintf (stderr, "[client:bench]: Acquisition timed out for channel %u\n", chan);
+        goto err_exit;
+    }
+
+    /* Same acquisition read over and over, so only the readout is timed */
+    uint64_t bytes = 0;
+    uint64_t start = _now_ns ();
+    for (uint32_t i = 0; i < num_curves && !zsys_interrupted; ++i) {
+        err = halcs_acq_get_curve (client, service, &acq_trans);
+        if (err != HALCS_CLIENT_SUCCESS) {
+            fprintf (stderr, "[client:bench]: halcs_acq_get_curve failed for channel %u\n", chan);
+            goto err_exit;
+        }
+        bytes += acq_trans.block.bytes_read;
+    }
+    uint64_t elapsed = _now_ns () - start;
+
+    mbps = (elapsed == 0)? 0 : (double) bytes * 1000 / elapsed;
+
+err_exit:
+    free (data);
+    return mbps;
+}
+
+static void _print_stats (FILE *fp, const char *name, bench_stats_t *stats,
+        bool last)
+{
+    fprintf (fp, "    \"%s\": {\"ops\": %"PRIu64", \"errors\": %"PRIu64", "
+            "\"ops_per_sec\": %.1f, \"latency_ns\": {\"min\": %"PRIu64", "
+            "\"p50\": %"PRIu64", \"p90\": %"PRIu64", \"p99\": %"PRIu64", "
+            "\"p999\": %"PRIu64", \"max\": %"PRIu64"}}%s\n",
+            name, stats->num_ops, stats->num_errors, stats->ops_per_sec,
+            stats->min, stats->p50, stats->p90, stats->p99, stats->p999,
+            stats->max, last? "" : ",");
+}
+
+int main (int argc, char *argv [])
+{
+    int verbose = 0;
+    char *broker_endp = NULL;
+    char *board_number_str = NULL;
+    char *halcs_number_str = NULL;
+    char *num_threads_str = NULL;
+    char *num_iter_str = NULL;
+    char *num_samples_str = NULL;
+    char *num_curves_str = NULL;
+    char *broker_pid_str = NULL;
+    char *output_str = NULL;
+    int opt;
+
+    while ((opt = getopt_long (argc, argv, shortopt, long_options, NULL)) != -1) {
+        /* Get the user selected options */
+        switch (opt) {
+            /* Display Help */
+            case 'h':
+                print_help (argv [0]);
+                exit (1);
+                break;
+
+            case 'b':
+                broker_endp = strdup (optarg);
+                break;
+
+            case 'v':
+                verbose = 1;
+                break;
+
+            case 'o':
+                board_number_str = strdup (optarg);
+                break;
+
+            case 's':
+                halcs_number_str = strdup (optarg);
+                break;
+
+            case 't':
+                num_threads_str = strdup (optarg);
+                break;
+
+            case 'n':
+                num_iter_str = strdup (optarg);
+                break;
+
+            case 'c':
+                num_samples_str = strdup (optarg);
+                break;
+
+            case 'r':
+                num_curves_str = strdup (optarg);
+                break;
+
+            case 'p':
+                broker_pid_str = strdup (optarg);
+                break;
+
+            case 'j':
+                output_str = strdup (optarg);
+                break;
+
+            case '?':
+                fprintf (stderr, "[client:bench] Option not recognized or missing argument\n");
+                print_help (argv [0]);
+                exit (1);
+                break;
+
+            default:
+                fprintf (stderr, "[client:bench] Could not parse options\n");
+                print_help (argv [0]);
+                exit (1);
+         }
+    }
+
+    /* Set default broker address */
+    if (broker_endp == NULL) {
+        fprintf (stderr, "[client:bench]: Setting default broker endpoint: %s\n",
+                "ipc://"DFLT_BIND_FOLDER);
+        broker_endp = strdup ("ipc://"DFLT_BIND_FOLDER);
+    }
+
+    uint32_t board_number = (board_number_str == NULL)? DFLT_BOARD_NUMBER :
+        strtoul (board_number_str, NULL, 10);
+
+    uint32_t halcs_number = (halcs_number_str == NULL)? DFLT_HALCS_NUMBER :
+        strtoul (halcs_number_str, NULL, 10);
+    if (halcs_number > MAX_HALCS_NUMBER) {
+        fprintf (stderr, "[client:bench]: HALCS number too big! Defaulting to: %u\n",
+                MAX_HALCS_NUMBER);
+        halcs_number = MAX_HALCS_NUMBER;
+    }
+
+    uint32_t num_threads = (num_threads_str == NULL)? DFLT_NUM_THREADS :
+        strtoul (num_threads_str, NULL, 10);
+    if (num_threads == 0 || num_threads > MAX_NUM_THREADS) {
+        fprintf (stderr, "[client:bench]: Invalid number of threads! Defaulting to: %u\n",
+                DFLT_NUM_THREADS);
+        num_threads = DFLT_NUM_THREADS;
+    }
+
+    uint32_t num_iter = (num_iter_str == NULL)? DFLT_NUM_ITER :
+        strtoul (num_iter_str, NULL, 10);
+    if (num_iter == 0) {
+        num_iter = DFLT_NUM_ITER;
+    }
+
+    uint32_t num_samples = (num_samples_str == NULL)? DFLT_NUM_SAMPLES :
+        strtoul (num_samples_str, NULL, 10);
+    if (num_samples < MIN_NUM_SAMPLES) {
+        fprintf (stderr, "[client:bench]: Number of samples too small! Defaulting to: %u\n",
+                MIN_NUM_SAMPLES);
+        num_samples = MIN_NUM_SAMPLES;
+    }
+    else if (num_samples > MAX_NUM_SAMPLES) {
+        fprintf (stderr, "[client:bench]: Number of samples too big! Defaulting to: %u\n",
+                MAX_NUM_SAMPLES);
+        num_samples = MAX_NUM_SAMPLES;
+    }
+
+    uint32_t num_curves = (num_curves_str == NULL)? DFLT_NUM_CURVES :
+        strtoul (num_curves_str, NULL, 10);
+
+    int broker_pid = (broker_pid_str == NULL)? 0 : atoi (broker_pid_str);
+
+    char service[50];
+    snprintf (service, sizeof (service), "HALCS%u:DEVIO:ACQ%u", board_number, halcs_number);
+
+    int ret = 1;
+    FILE *out = stdout;
+    if (output_str != NULL) {
+        out = fopen (output_str, "w");
+        if (out == NULL) {
+            fprintf (stderr, "[client:bench]: Could not open %s\n", output_str);
+            goto err_output_open;
+        }
+    }
+
+    halcs_client_t *halcs_client = halcs_client_new_time (broker_endp, verbose,
+            NULL, BENCH_TIMEOUT);
+    if (halcs_client == NULL) {
+        fprintf (stderr, "[client:bench]: halcs_client could be created\n");
+        goto err_halcs_client_new;
+    }
+
+    /* Set trigger to skip */
+    halcs_client_err_e err = halcs_set_acq_trig (halcs_client, service, 0);
+    if (err != HALCS_CLIENT_SUCCESS){
+        fprintf (stderr, "[client:bench]: halcs_set_acq_trig failed. Is %s up?\n",
+                service);
+        goto err_halcs_set_acq_trig;
+    }
+
+    uint64_t broker_cpu_start = (broker_pid > 0)? _proc_cpu_ns (broker_pid) : 0;
+    uint64_t bench_start = _now_ns ();
+
+    /* Acquisition throughput, one channel at a time */
+    double curve_mbps [END_CHAN_ID];
+    for (uint32_t chan = 0; chan < END_CHAN_ID; ++chan) {
+        fprintf (stderr, "[client:bench]: Reading curves from channel %u\n", chan);
+        curve_mbps [chan] = _bench_curve (halcs_client, service, chan, num_samples,
+                num_curves);
+    }
+
+    /* Request/reply latency. An acquisition is done by now, so
+     * acq_check_data_acquire succeeds */
+    bench_stats_t stats [END_BENCH_OP];
+    for (uint32_t op = 0; op < END_BENCH_OP; ++op) {
+        fprintf (stderr, "[client:bench]: Running %s on %u threads\n",
+                bench_op_names [op], num_threads);
+        if (_bench_op (broker_endp, service, op, num_threads, num_iter,
+                    &stats [op]) != 0) {
+            fprintf (stderr, "[client:bench]: Could not run %s\n", bench_op_names [op]);
+            goto err_bench_op;
+        }
+    }
+
+    uint64_t bench_elapsed = _now_ns () - bench_start;
+    uint64_t broker_cpu = (broker_pid > 0)?
+        _proc_cpu_ns (broker_pid) - broker_cpu_start : 0;
+
+    /* Both reads take the same path, except for the SMIO to DEVIO
+     * round trip on the register access. Subtracting percentiles of two
+     * distributions only estimates the percentiles of that round trip */
+    int64_t thsafe_p50 = (int64_t) stats [BENCH_PARAM_READ].p50 -
+        (int64_t) stats [BENCH_PARAM_LOCAL_READ].p50;
+    int64_t thsafe_p99 = (int64_t) stats [BENCH_PARAM_READ].p99 -
+        (int64_t) stats [BENCH_PARAM_LOCAL_READ].p99;
+
+    fprintf (out, "{\n");
+    fprintf (out, "  \"service\": \"%s\",\n", service);
+    fprintf (out, "  \"threads\": %u,\n", num_threads);
+    fprintf (out, "  \"iterations\": %u,\n", num_iter);
+    fprintf (out, "  \"ops\": {\n");
+    for (uint32_t op = 0; op < END_BENCH_OP; ++op) {
+        _print_stats (out, bench_op_names [op], &stats [op], op == END_BENCH_OP-1);
+    }
+    fprintf (out, "  },\n");
+    fprintf (out, "  \"thsafe_round_trip_estimate_ns\": {\"p50\": %"PRId64", \"p99\": %"PRId64"},\n",
+            thsafe_p50, thsafe_p99);
+    fprintf (out, "  \"acq_get_curve\": {\n");
+    fprintf (out, "    \"num_samples\": %u,\n", num_samples);
+    fprintf (out, "    \"curves\": %u,\n", num_curves);
+    fprintf (out, "    \"channels\": [\n");
+    for (uint32_t chan = 0; chan < END_CHAN_ID; ++chan) {
+        fprintf (out, "      {\"chan\": %u, \"sample_size\": %u, ", chan,
+                acq_chan[chan].sample_size);
+        if (curve_mbps [chan] < 0) {
+            fprintf (out, "\"mb_per_sec\": null}");
+        }
+        else {
+            fprintf (out, "\"mb_per_sec\": %.2f}", curve_mbps [chan]);
+        }
+        fprintf (out, "%s\n", (chan == END_CHAN_ID-1)? "" : ",");
+    }
+    fprintf (out, "    ]\n");
+    fprintf (out, "  },\n");
+    if (broker_pid > 0) {
+        fprintf (out, "  \"broker_cpu\": {\"cpu_sec\": %.3f, \"percent\": %.1f},\n",
+                (double) broker_cpu / NSECS_PER_SEC,
+                (double) broker_cpu * 100 / bench_elapsed);
+    }
+    else {
+        fprintf (out, "  \"broker_cpu\": null,\n");
+    }
+    fprintf (out, "  \"elapsed_sec\": %.3f\n", (double) bench_elapsed / NSECS_PER_SEC);
+    fprintf (out, "}\n");
+
+    ret = 0;
+
+err_bench_op:
+err_halcs_set_acq_trig:
+    halcs_client_destroy (&halcs_client);
+err_halcs_client_new:
+    if (out != stdout) {
+        fclose (out);
+    }
+err_output_open:
+    free (output_str);
+    output_str = NULL;
+    free (broker_pid_str);
+    broker_pid_str = NULL;
+    free (num_curves_str);
+    num_curves_str = NULL;
+    free (num_samples_str);
+    num_samples_str = NULL;
+    free (num_iter_str);
+    num_iter_str = NULL;
+    free (num_threads_str);
+    num_threads_str = NULL;
+    free (halcs_number_str);
+    halcs_number_str = NULL;
+    free (board_number_str);
+    board_number_str = NULL;
+    free (broker_endp);
+    broker_endp = NULL;
+
+    return ret;
+}
@@ -0,0 +1,81 @@
+#!/usr/bin/env bash
+
+# Start a Malamute broker and a BE halcsd on a simulated device, run
+# halcs_bench against them and write the results as JSON.
+#
+# Environment variables override the tools used:
+#   HALCSD      halcsd binary (default: ../halcsd)
+#   MALAMUTE    broker binary (default: malamute)
+#   HALCS_CFG   halcsd configuration file
+#               (default: ../cfg/crude_defconfig/halcs.cfg)
+
+set -euo pipefail
+
+SCRIPTPATH="$(cd "$(dirname "$0")" && pwd)"
+
+HALCSD=${HALCSD:-${SCRIPTPATH}/../halcsd}
+MALAMUTE=${MALAMUTE:-malamute}
+HALCS_CFG=${HALCS_CFG:-${SCRIPTPATH}/../cfg/crude_defconfig/halcs.cfg}
+
+OUTPUT=${SCRIPTPATH}/bench_results.json
+LATENCY_NS=0
+THROUGHPUT_MBPS=0
+DEV_ID=1
+
+function usage {
+    echo "Usage: $0 [-o <JSON file>] [-l <access latency ns>] [-m <block MB/s>]"
+    echo "          [-i <Device ID>] [-- <halcs_bench options>]"
+}
+
+while getopts ":o:l:m:i:h" opt; do
+    case $opt in
+        o) OUTPUT=$OPTARG ;;
+        l) LATENCY_NS=$OPTARG ;;
+        m) THROUGHPUT_MBPS=$OPTARG ;;
+        i) DEV_ID=$OPTARG ;;
+        h) usage; exit 0 ;;
+        *) usage; exit 1 ;;
+    esac
+done
+shift $((OPTIND-1))
+
+WORK_DIR=$(mktemp -d /tmp/halcs-bench.XXXXXX)
+BROKER_ENDP="ipc://${WORK_DIR}/broker"
+BROKER_PID=
+HALCSD_PID=
+
+function cleanup {
+    [ -n "${HALCSD_PID}" ] && kill ${HALCSD_PID} 2>/dev/null || true
+    [ -n "${BROKER_PID}" ] && kill ${BROKER_PID} 2>/dev/null || true
+    wait 2>/dev/null || true
+    rm -rf "${WORK_DIR}"
+}
+trap cleanup EXIT
+
+cat > "${WORK_DIR}/malamute.cfg" <<EOF
+server
+    background = 0
+mlm_server
+    security
+        mechanism = null
+    bind
+        endpoint = ${BROKER_ENDP}
+EOF
+
+echo "Starting broker at ${BROKER_ENDP}" >&2
+"${MALAMUTE}" "${WORK_DIR}/malamute.cfg" > "${WORK_DIR}/malamute.log" 2>&1 &
+BROKER_PID=$!
+
+echo "Starting halcsd on sim:${LATENCY_NS}:${THROUGHPUT_MBPS}" >&2
+"${HALCSD}" -f "${HALCS_CFG}" -n be -t sim -i ${DEV_ID} \
+    -e "sim:${LATENCY_NS}:${THROUGHPUT_MBPS}" -b "${BROKER_ENDP}" \
+    -l "${WORK_DIR}" &
+HALCSD_PID=$!
+
+# Give the SMIOs time to register their services
+sleep 2
+
+"${SCRIPTPATH}/halcs_bench" -b "${BROKER_ENDP}" -o ${DEV_ID} -s 0 \
+    -p ${BROKER_PID} -j "${OUTPUT}" "$@"
+
+echo "Results written to ${OUTPUT}" >&2
@@ -0,0 +1,86 @@
+#!/usr/bin/env bash
+
+# Start a Malamute broker and a BE halcsd on a simulated device, and check
+# that one acquisition of the ADC channel returns all requested samples.
+#
+# Environment variables override the tools used:
+#   HALCSD      halcsd binary (default: ../halcsd)
+#   MALAMUTE    broker binary (default: malamute)
+#   ACQ         acquisition client (default: ../examples/acq)
+#   HALCS_CFG   halcsd configuration file
+#               (default: ../cfg/crude_defconfig/halcs.cfg)
+
+set -euo pipefail
+
+SCRIPTPATH="$(cd "$(dirname "$0")" && pwd)"
+
+HALCSD=${HALCSD:-${SCRIPTPATH}/../halcsd}
+MALAMUTE=${MALAMUTE:-malamute}
+ACQ=${ACQ:-${SCRIPTPATH}/../examples/acq}
+HALCS_CFG=${HALCS_CFG:-${SCRIPTPATH}/../cfg/crude_defconfig/halcs.cfg}
+
+DEV_ID=1
+# ADC channel, printed as one line per sample
+ACQ_CHAN=0
+NUM_SAMPLES=4096
+
+function usage {
+    echo "Usage: $0 [-i <Device ID>] [-n <Number of samples>]"
+}
+
+while getopts ":i:n:h" opt; do
+    case $opt in
+        i) DEV_ID=$OPTARG ;;
+        n) NUM_SAMPLES=$OPTARG ;;
+        h) usage; exit 0 ;;
+        *) usage; exit 1 ;;
+    esac
+done
+shift $((OPTIND-1))
+
+WORK_DIR=$(mktemp -d /tmp/halcs-smoke.XXXXXX)
+BROKER_ENDP="ipc://${WORK_DIR}/broker"
+BROKER_PID=
+HALCSD_PID=
+
+function cleanup {
+    [ -n "${HALCSD_PID}" ] && kill ${HALCSD_PID} 2>/dev/null || true
+    [ -n "${BROKER_PID}" ] && kill ${BROKER_PID} 2>/dev/null || true
+    wait 2>/dev/null || true
+    rm -rf "${WORK_DIR}"
+}
+trap cleanup EXIT
+
+cat > "${WORK_DIR}/malamute.cfg" <<CFG
+server
+    background = 0
+mlm_server
+    security
+        mechanism = null
+    bind
+        endpoint = ${BROKER_ENDP}
+CFG
+
+echo "Starting broker at ${BROKER_ENDP}" >&2
+"${MALAMUTE}" "${WORK_DIR}/malamute.cfg" > "${WORK_DIR}/malamute.log" 2>&1 &
+BROKER_PID=$!
+
+echo "Starting halcsd on sim" >&2
+"${HALCSD}" -f "${HALCS_CFG}" -n be -t sim -i ${DEV_ID} -e sim \
+    -b "${BROKER_ENDP}" -l "${WORK_DIR}" &
+HALCSD_PID=$!
+
+# Give the SMIOs time to register their services
+sleep 2
+
+echo "Acquiring ${NUM_SAMPLES} samples from channel ${ACQ_CHAN}" >&2
+"${ACQ}" -b "${BROKER_ENDP}" -o ${DEV_ID} -s 0 -c ${ACQ_CHAN} \
+    -n ${NUM_SAMPLES} -f 0 > "${WORK_DIR}/acq.txt"
+
+NUM_LINES=$(wc -l < "${WORK_DIR}/acq.txt")
+if [ "${NUM_LINES}" -ne "${NUM_SAMPLES}" ]; then
+    echo "FAIL: got ${NUM_LINES} of ${NUM_SAMPLES} samples" >&2
+    exit 1
+fi
+
+echo "PASS: got ${NUM_SAMPLES} samples" >&2
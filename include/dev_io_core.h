@@ -82,6 +82,25 @@ devio_err_e devio_do_smio_op (devio_t *self, void *msg);
 devio_err_e devio_set_llio (devio_t *self, llio_t *llio);
 /* Get LLIO instance from DEVIO */
 llio_t *devio_get_llio (devio_t *self);
+/* Set the thsafe client operations used by the SMIOs of this DEVIO. Must be
+ * called before any SMIO is registered */
+devio_err_e devio_set_thsafe_client_ops (devio_t *self,
+        const smio_thsafe_client_ops_t *thsafe_client_ops);
+/* Get the thsafe client operations used by the SMIOs of this DEVIO */
+const smio_thsafe_client_ops_t *devio_get_thsafe_client_ops (devio_t *self);
+/* Lock/Unlock the LLIO for accessing the address offs. All of the
+ * accesses to the same PCIe BAR are serialized. All of the accesses to
+ * non-PCIe endpoints are serialized */
+void devio_lock_llio (devio_t *self, uint64_t offs);
+void devio_unlock_llio (devio_t *self, uint64_t offs);
+/* Lock/Unlock the LLIO for a DMA transfer to/from the address offs. This
+ * also serializes with the accesses to BAR0, where the DMA engine lives */
+void devio_lock_llio_dma (devio_t *self, uint64_t offs);
+void devio_unlock_llio_dma (devio_t *self, uint64_t offs);
+/* Execute a transaction of LLIO operations atomically. Read values are
+ * returned in place. Returns the number of bytes of ops processed or a
+ * negative number on error */
+ssize_t devio_llio_txn (devio_t *self, smio_thsafe_txn_op_t *ops, uint32_t num_ops);
 
 /* Register signals to Device Manager instance */
 devio_err_e devio_set_sig_handler (devio_t *self, devio_sig_handler_t *sig_handler);
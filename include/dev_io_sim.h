@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2014 LNLS (www.lnls.br)
+ * Author: Lucas Russo <lucas.russo@lnls.br>
+ *
+ * Released according to the GNU GPL, version 3 or any later version.
+ */
+
+#ifndef _DEV_IO_SIM_H_
+#define _DEV_IO_SIM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Base address of the first simulated ACQ core. The others follow, each
+ * DEVIO_SIM_ACQ_CORE_SIZE bytes apart */
+#define DEVIO_SIM_ACQ_CORE_BASE             0x00310000
+#define DEVIO_SIM_ACQ_CORE_SIZE             0x00001000
+
+/* Fill a simulated device (see ll_io_sim.h) with the SDB ROM and the
+ * register models needed to run the ACQ SMIOs without hardware. llio
+ * must be opened already */
+devio_err_e devio_sim_model_init (llio_t *llio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -98,6 +98,8 @@ typedef struct _smch_si57x_t smch_si57x_t;
 typedef struct _smch_rffe_t smch_rffe_t;
 /* Opaque sm_ch_isla216p_t structure */
 typedef struct _smch_isla216p_t smch_isla216p_t;
+/* Opaque sm_ch_shadow_t structure */
+typedef struct _smch_shadow_t smch_shadow_t;
 
 
 /* Forward declaration smio_mod_dispatch_t declaration structure */
@@ -106,6 +108,10 @@ typedef struct _smio_mod_dispatch_t smio_mod_dispatch_t;
 typedef enum _smio_err_e smio_err_e;
 /* Opaque smio_t structure */
 typedef struct _smio_t smio_t;
+/* Forward smio_thsafe_client_ops_t declaration structure */
+typedef struct _smio_thsafe_client_ops_t smio_thsafe_client_ops_t;
+/* Forward smio_thsafe_txn_op_t declaration structure */
+typedef struct _smio_thsafe_txn_op_t smio_thsafe_txn_op_t;
 
 /* Forward msg_err_e declaration enumeration */
 typedef enum _msg_err_e msg_err_e;
@@ -126,6 +132,7 @@ typedef struct _zmq_server_args_t zmq_server_args_t;
 #include "dev_io_utils.h"
 #include "dev_io_exports.h"
 #include "dev_io_core.h"
+#include "dev_io_sim.h"
 #include "dev_io.h"
 
 /* SM_PR */
@@ -144,6 +151,7 @@ typedef struct _zmq_server_args_t zmq_server_args_t;
 
 /* SM_CH */
 #include "sm_ch_err.h"
+#include "sm_ch_shadow.h"
 #include "sm_ch_24aa64.h"
 #include "chips/e24aa64_regs.h"
 #include "sm_ch_ad9510.h"
@@ -177,6 +185,7 @@ typedef struct _zmq_server_args_t zmq_server_args_t;
 /* MSG SMIO THSAFE ops */
 #include "smio_thsafe_zmq_server.h"
 #include "smio_thsafe_zmq_client.h"
+#include "smio_thsafe_direct_client.h"
 /* General MSG */
 #include "thsafe_msg_zmq.h"
 #include "msg.h"
@@ -110,10 +110,12 @@ typedef int (*rw_param_format_fp) (uint32_t *param);
         err;                                                                    \
      })
 
+/* Default accessors read through the SMIO register shadow, which falls back
+ * to the device for registers not shadowed. See smio_shadow_init () */
 #define GET_PARAM(self, module, base_addr, prefix, reg, field, single_bit, var, \
         fmt_funcp)                                                              \
             GET_PARAM_GEN(self, module, base_addr, prefix, reg, field, single_bit, var, \
-               fmt_funcp, smio_thsafe_client_read_32)
+               fmt_funcp, smio_thsafe_client_read_32_shadow)
 
 /* SET or CLEAR parameter based on the last macro parameter "clr_field" */
 #define SET_PARAM_GEN(self, module, base_addr, prefix, reg, field, single_bit, value, \
@@ -181,8 +183,8 @@ typedef int (*rw_param_format_fp) (uint32_t *param);
 #define SET_PARAM(self, module, base_addr, prefix, reg, field, single_bit, value, \
         min, max, chk_funcp, clr_field)                                         \
             SET_PARAM_GEN(self, module, base_addr, prefix, reg, field, single_bit, value, \
-                min, max, chk_funcp, clr_field, smio_thsafe_client_read_32,     \
-                    smio_thsafe_client_write_32)
+                min, max, chk_funcp, clr_field,                                 \
+                    smio_thsafe_client_read_32_shadow, smio_thsafe_client_write_32)
 
 /* zmq message in SET_GET_PARAM macro is:
  * frame 0: operation code
@@ -224,8 +226,8 @@ typedef int (*rw_param_format_fp) (uint32_t *param);
 #define SET_GET_PARAM(module, base_addr, prefix, reg, field, single_bit, min,   \
         max, chk_funcp, fmt_funcp, clr_field)                                   \
             SET_GET_PARAM_GEN(module, base_addr, prefix, reg, field, single_bit, min,   \
-                max, chk_funcp, fmt_funcp, clr_field, smio_thsafe_client_read_32, \
-                    smio_thsafe_client_write_32)
+                max, chk_funcp, fmt_funcp, clr_field,                           \
+                    smio_thsafe_client_read_32_shadow, smio_thsafe_client_write_32)
 
 /* zmq message in SET_GET_PARAM_CHANNEL macro is:
  * frame 0: operation code
@@ -277,7 +279,7 @@ typedef int (*rw_param_format_fp) (uint32_t *param);
         chan_num, single_bit, min, max, chk_funcp, fmt_funcp, clr_field)        \
             SET_GET_PARAM_CHANNEL_GEN(module, base_addr, prefix, reg, field,    \
                     chan_offset, chan_num, single_bit, min, max, chk_funcp,     \
-                    fmt_funcp, clr_field, smio_thsafe_client_read_32,           \
+                    fmt_funcp, clr_field, smio_thsafe_client_read_32_shadow,    \
                     smio_thsafe_client_write_32)
 
 uint32_t check_param_limits (uint32_t value, uint32_t min, uint32_t max);
@@ -34,6 +34,8 @@ smch_err_e smch_ad9510_read_8_update (smch_ad9510_t *self, uint8_t addr,
 
 /* Update AD9510 registers */
 smch_err_e smch_ad9510_reg_update (smch_ad9510_t *self);
+/* Read the register shadow back from the chip. Use after an external reset */
+smch_err_e smch_ad9510_resync (smch_ad9510_t *self);
 
 /* Simple test for configuring a few AD9510 registers */
 smch_err_e smch_ad9510_cfg_defaults (smch_ad9510_t *self);
@@ -25,6 +25,8 @@ smch_err_e smch_isla216p_write_8 (smch_isla216p_t *self, uint8_t addr,
         const uint8_t *data);
 smch_err_e smch_isla216p_read_8 (smch_isla216p_t *self, uint8_t addr,
         uint8_t *data);
+/* Read the register shadow back from the chip. Use after an external reset */
+smch_err_e smch_isla216p_resync (smch_isla216p_t *self);
 
 /* ISLA216P Test functions */
 smch_err_e smch_isla216p_set_test_mode (smch_isla216p_t *self, uint8_t mode);
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2014 LNLS (www.lnls.br)
+ * Author: Lucas Russo <lucas.russo@lnls.br>
+ *
+ * Released according to the GNU GPL, version 3 or any later version.
+ */
+
+#ifndef _SM_CH_SHADOW_H_
+#define _SM_CH_SHADOW_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Chips handled here have 8-bit register addresses */
+#define SMCH_SHADOW_NUM_REGS                    256
+
+/* Read/Write a single register from/to the device */
+typedef smch_err_e (*smch_shadow_read_fp) (void *owner, uint8_t addr,
+        uint8_t *data);
+typedef smch_err_e (*smch_shadow_write_fp) (void *owner, uint8_t addr,
+        const uint8_t *data);
+
+/***************** Our methods *****************/
+
+/* Creates a new register shadow. owner is passed back to read_fp and
+ * write_fp, which access the device directly */
+smch_shadow_t * smch_shadow_new (void *owner, smch_shadow_read_fp read_fp,
+        smch_shadow_write_fp write_fp);
+/* Destroy a register shadow */
+smch_err_e smch_shadow_destroy (smch_shadow_t **self_p);
+
+/* Mark num_regs registers starting at addr as changed by the device itself.
+ * These are never cached */
+smch_err_e smch_shadow_set_volatile (smch_shadow_t *self, uint8_t addr,
+        size_t num_regs);
+/* Add registers to the set read back by smch_shadow_resync () */
+smch_err_e smch_shadow_track (smch_shadow_t *self, const uint8_t *addrs,
+        size_t num_addrs);
+/* Drop every cached value. Use after the device state changed behind our
+ * back, e.g., a soft reset */
+void smch_shadow_invalidate (smch_shadow_t *self);
+/* Drop every cached value and read the tracked registers back from the
+ * device. Use after an external reset */
+smch_err_e smch_shadow_resync (smch_shadow_t *self);
+
+/* Read register, from the shadow if it holds a valid copy */
+smch_err_e smch_shadow_read_8 (smch_shadow_t *self, uint8_t addr, uint8_t *data);
+/* Write register. Nothing is sent to the device if the shadow says it
+ * already holds data */
+smch_err_e smch_shadow_write_8 (smch_shadow_t *self, uint8_t addr,
+        const uint8_t *data);
+/* Change only the bits set in mask, going through the shadow for the read */
+smch_err_e smch_shadow_rmw_8 (smch_shadow_t *self, uint8_t addr, uint8_t mask,
+        uint8_t data);
+
+/* Copy size registers starting at addr out of the shadow. Returns false
+ * if any of them is not cached */
+bool smch_shadow_get (smch_shadow_t *self, uint8_t addr, uint8_t *data,
+        size_t size);
+/* Record size registers starting at addr written to or read from the
+ * device by other means, e.g., a block transfer */
+void smch_shadow_update (smch_shadow_t *self, uint8_t addr, const uint8_t *data,
+        size_t size);
+/* Find the smallest span of data that differs from the shadow. first is the
+ * offset into data of the first differing register. Returns the span size,
+ * 0 if the device already holds data */
+size_t smch_shadow_diff (smch_shadow_t *self, uint8_t addr, const uint8_t *data,
+        size_t size, size_t *first);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -29,6 +29,8 @@ smch_err_e smch_si57x_read_8 (smch_si57x_t *self, uint8_t addr,
         uint8_t *data);
 smch_err_e smch_si57x_read_block (smch_si57x_t *self, uint8_t addr,
         uint8_t *data, size_t size);
+/* Read the register shadow back from the chip. Use after an external reset */
+smch_err_e smch_si57x_resync (smch_si57x_t *self);
 
 /* Get Si57X divider values */
 smch_err_e smch_si57x_get_divs (smch_si57x_t *self, uint64_t *rfreq,
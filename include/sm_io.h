@@ -51,6 +51,9 @@ typedef smio_err_e (*export_ops_fp)(smio_t *self, const disp_op_t** smio_exp_ops
 typedef smio_err_e (*unexport_ops_fp)(smio_t *self);
 /* Generic wrapper for receiving opcodes and arguments to specific funtions function pointer */
 typedef smio_err_e (*do_op_fp)(void *owner, void *msg);
+/* Periodic handler function pointer. This is called by the SMIO reactor,
+ * so it runs in the same thread as the exported operations */
+typedef smio_err_e (*smio_timer_fp)(smio_t *self);
 
 typedef struct {
     attach_fp attach;                   /* Attach sm_io instance to dev_io */
@@ -82,8 +85,20 @@ typedef ssize_t (*thsafe_client_read_dma_fp) (smio_t *self, uint64_t offs, size_
 typedef ssize_t (*thsafe_client_write_dma_fp) (smio_t *self, uint64_t offs, size_t size, const uint32_t *data);
 /* Read device information */
 /* typedef int (*thsafe_client_read_info_fp) (smio_t *self, llio_dev_info_t *dev_info); Moved to dev_io */
+/* Execute a transaction of register operations, atomically. Read values
+ * are returned in place */
+typedef ssize_t (*thsafe_client_txn_fp) (smio_t *self, smio_thsafe_txn_op_t *ops,
+        uint32_t num_ops);
+/* Read data block from device, size in bytes, into a frame owned by the
+ * caller. This avoids copying the block out of the received message */
+typedef ssize_t (*thsafe_client_read_block_frame_fp) (smio_t *self, uint64_t offs,
+        size_t size, zframe_t **data_frame);
+/* Read data block via DMA from device, size in bytes, into a frame owned by
+ * the caller */
+typedef ssize_t (*thsafe_client_read_dma_frame_fp) (smio_t *self, uint64_t offs,
+        size_t size, zframe_t **data_frame);
 
-typedef struct {
+struct _smio_thsafe_client_ops_t {
     thsafe_client_open_fp thsafe_client_open;                   /* Open device */
     thsafe_client_release_fp thsafe_client_release;             /* Release device */
     thsafe_client_read_16_fp thsafe_client_read_16;             /* Read 16-bit data */
@@ -101,7 +116,37 @@ typedef struct {
     thsafe_client_write_dma_fp thsafe_client_write_dma;         /* Write arbitrary block size data via DMA,
                                                      parameter size in bytes */
     /*thsafe_client_read_info_fp thsafe_client_read_info; Moved to dev_io */         /* Read device information data */
-} smio_thsafe_client_ops_t;
+    thsafe_client_txn_fp thsafe_client_txn;                     /* Execute a transaction of register
+                                                     operations atomically */
+    thsafe_client_read_block_frame_fp thsafe_client_read_block_frame;
+                                                /* Read arbitrary block size data
+                                                     into a frame, parameter size in bytes */
+    thsafe_client_read_dma_frame_fp thsafe_client_read_dma_frame;
+                                                /* Read arbitrary block size data via DMA
+                                                     into a frame, parameter size in bytes */
+};
+
+/* Single transaction operation. This is sent as is to DEVIO, so
+ * keep it free of pointers */
+struct _smio_thsafe_txn_op_t {
+    uint64_t offs;                      /* Register address */
+    uint32_t type;                      /* THSAFE_TXN_OP_* */
+    uint32_t mask;                      /* Bits modified by THSAFE_TXN_OP_RMW_32 */
+    uint32_t data;                      /* Value to be written. On return, value
+                                           read for THSAFE_TXN_OP_READ_32 and
+                                           previous value for THSAFE_TXN_OP_RMW_32 */
+    uint32_t rsvd;                      /* Padding */
+};
+
+/* Transaction builder. Operations are executed in the order they were
+ * added. Meant to be allocated on the stack and reused after
+ * smio_thsafe_txn_init () */
+typedef struct {
+    uint32_t num_ops;                                   /* Number of operations added */
+    bool overflow;                                      /* An operation did not fit */
+    smio_thsafe_txn_op_t ops [THSAFE_TXN_MAX_OPS];      /* Operations */
+    uint32_t *dest [THSAFE_TXN_MAX_OPS];                /* Where to store read values */
+} smio_thsafe_txn_t;
 
 /* Thread boot args structure */
 typedef struct {
@@ -167,6 +212,14 @@ smio_err_e smio_set_handler (smio_t *self, void *smio_handler);
 void *smio_get_handler (smio_t *self);
 /* Get SMIO Worker */
 mlm_client_t *smio_get_worker (smio_t *self);
+/* Get SMIO exported service name */
+const char *smio_get_service (smio_t *self);
+/* Get SMIO parent DEVIO. Only valid after the SMIO is attached */
+struct _devio_t *smio_get_parent (smio_t *self);
+/* Set SMIO periodic handler, called every "interval" ms. A NULL handler
+ * disables it */
+smio_err_e smio_set_timer_handler (smio_t *self, size_t interval,
+        smio_timer_fp timer_handler);
 /* Get SMIO PIPE Message */
 zsock_t *smio_get_pipe_msg (smio_t *self);
 /* Get SMIO PIPE Management */
@@ -229,6 +282,24 @@ ssize_t smio_thsafe_client_read_dma (smio_t *self, uint64_t offs, size_t size, u
 /* read data block via dma from device, size in bytes, with raw address (no base address mangling) */
 ssize_t smio_thsafe_raw_client_read_dma (smio_t *self, uint64_t offs, size_t size, uint32_t *data);
 
+/* Read data block from device, size in bytes, into a newly created frame.
+ * On success, the caller owns *data_frame */
+ssize_t smio_thsafe_client_read_block_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame);
+/* Read data block from device into a newly created frame, with raw address
+ * (no base address mangling) */
+ssize_t smio_thsafe_raw_client_read_block_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame);
+
+/* Read data block via DMA from device, size in bytes, into a newly created
+ * frame. On success, the caller owns *data_frame */
+ssize_t smio_thsafe_client_read_dma_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame);
+/* Read data block via DMA from device into a newly created frame, with raw
+ * address (no base address mangling) */
+ssize_t smio_thsafe_raw_client_read_dma_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame);
+
 /* Write data block via DMA from device, size in bytes */
 ssize_t smio_thsafe_client_write_dma (smio_t *self, uint64_t offs, size_t size, const uint32_t *data);
 /* Write data block via DMA from device, size in bytes, with raw address (no base address mangling) */
@@ -237,6 +308,54 @@ ssize_t smio_thsafe_raw_client_write_dma (smio_t *self, uint64_t offs, size_t si
 /* Read device information */
 /* int smio_thsafe_client_read_info (smio_t *self, llio_dev_info_t *dev_info) */
 
+/* Reset transaction */
+void smio_thsafe_txn_init (smio_thsafe_txn_t *txn);
+/* Add a read operation to transaction. data is filled when the transaction
+ * is executed */
+smio_err_e smio_thsafe_txn_read_32 (smio_t *self, smio_thsafe_txn_t *txn,
+        uint64_t offs, uint32_t *data);
+/* Add a write operation to transaction */
+smio_err_e smio_thsafe_txn_write_32 (smio_t *self, smio_thsafe_txn_t *txn,
+        uint64_t offs, uint32_t data);
+/* Add a read-modify-write operation to transaction. Only the bits set in
+ * mask are changed. old, if not NULL, receives the previous value */
+smio_err_e smio_thsafe_txn_rmw_32 (smio_t *self, smio_thsafe_txn_t *txn,
+        uint64_t offs, uint32_t mask, uint32_t data, uint32_t *old);
+/* Execute all of the transaction operations atomically, in a single
+ * request. A transaction that had more than THSAFE_TXN_MAX_OPS operations
+ * added is not executed at all and -1 is returned */
+ssize_t smio_thsafe_client_txn (smio_t *self, smio_thsafe_txn_t *txn);
+
+/* Shadow num_regs contiguous 32-bit registers starting at offs. The shadow
+ * is populated with a single block read and kept coherent with every write
+ * issued through this SMIO. Only registers owned by software should be
+ * shadowed, see smio_shadow_set_volatile () */
+smio_err_e smio_shadow_init (smio_t *self, uint64_t offs, uint32_t num_regs);
+/* Mark num_regs registers starting at offs as changed by hardware. These are
+ * always read from hardware */
+smio_err_e smio_shadow_set_volatile (smio_t *self, uint64_t offs, uint32_t num_regs);
+/* Release the register shadow. All registers are read from hardware again */
+void smio_shadow_free (smio_t *self);
+/* Force all shadowed registers to be read again from hardware */
+void smio_shadow_invalidate (smio_t *self);
+/* Range of num_regs contiguous 32-bit registers starting at offs */
+typedef struct {
+    uint64_t offs;
+    uint32_t num_regs;
+} smio_shadow_range_t;
+/* Shadow num_regs registers starting at offs (see smio_shadow_init ()) and
+ * mark the num_volatile ranges in volatile_regs as volatile. A shadow that
+ * can't be set up is not an error: registers are then read from hardware */
+void smio_shadow_setup (smio_t *self, uint64_t offs, uint32_t num_regs,
+        const smio_shadow_range_t *volatile_regs, uint32_t num_volatile);
+/* Exported operation calling smio_shadow_invalidate (). Modules export it
+ * for resyncing their register shadow after the FPGA was reprogrammed or
+ * written behind the server's back. Takes a dummy 32-bit write argument */
+int smio_shadow_resync_exp (void *owner, void *args, void *ret);
+/* Read 32-bit data from the register shadow, falling back to the device if
+ * the register is not shadowed, is volatile or is not known yet */
+ssize_t smio_thsafe_client_read_32_shadow (smio_t *self, uint64_t offs, uint32_t *data);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,7 @@ enum _smio_err_e {
                                        terminated or received interrupt signal */
     SMIO_ERR_INV_SOCKET,            /* Invalid socket reference */
     SMIO_ERR_REGISTER_SM,           /* Could not register SMIO */
+    SMIO_ERR_PUBLISH_EVENT,         /* Could not publish event */
     SMIO_ERR_END                    /* End of enum marker */
 };
 
@@ -46,9 +46,19 @@ extern "C" {
 #define THSAFE_NAME_READ_DMA                "read_dma"
 #define THSAFE_OPCODE_WRITE_DMA             11
 #define THSAFE_NAME_WRITE_DMA               "write_dma"
-//#define THSAFE_OPCODE_READ_INFO           12
-#define THSAFE_OPCODE_END                   12
-//#define THSAFE_OPCODE_END                 13
+#define THSAFE_OPCODE_TXN                   12
+#define THSAFE_NAME_TXN                     "txn"
+//#define THSAFE_OPCODE_READ_INFO           13
+#define THSAFE_OPCODE_END                   13
+//#define THSAFE_OPCODE_END                 14
+
+/* Transaction operation types */
+#define THSAFE_TXN_OP_READ_32               0
+#define THSAFE_TXN_OP_WRITE_32              1
+#define THSAFE_TXN_OP_RMW_32                2   /* Read-modify-write with mask */
+#define THSAFE_TXN_OP_END                   3
+/* Maximum number of operations in a single transaction */
+#define THSAFE_TXN_MAX_OPS                  64
 
 /* Messaging Reply OPCODES */
 #define THSAFE_REPLY_TYPE                   uint32_t
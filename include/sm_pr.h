@@ -18,6 +18,12 @@ extern "C" {
 #define SMPR_BYTE_2_BIT                     8
 #define SMPR_WB_REG_2_BYTE                  4       /* 32-bit word */
 #define SMPR_WB_REG_2_BIT                   (SMPR_WB_REG_2_BYTE*SMPR_BYTE_2_BIT)
+#define SMPR_SEC_2_USEC                     1000000
+
+/* Completion wait defaults */
+#define SMPR_WAIT_SPIN_US                   50      /* Below this we poll instead of sleeping */
+#define SMPR_WAIT_MAX_BACKOFF_US            1000
+#define SMPR_WAIT_DFLT_TIMEOUT_US           10000   /* On top of the expected time */
 
 /* Open protocol */
 typedef int (*proto_open_fp) (smpr_t *self, uint64_t base, void *args);
@@ -40,6 +46,22 @@ typedef ssize_t (*proto_read_dma_fp) (smpr_t *self, size_t size_offs, uint64_t o
 /* Write data block via DMA from protocol, size in bytes */
 typedef ssize_t (*proto_write_dma_fp) (smpr_t *self, size_t size_offs, uint64_t offs, size_t size, const uint32_t *data);
 
+/* Single register transfer of a burst */
+typedef struct {
+    uint64_t offs;                              /* Register address */
+    uint32_t data;                              /* Data to be written. On return,
+                                                     data read for read transfers */
+    bool read;                                  /* Read transfer */
+} smpr_xfer_t;
+
+/* Run a list of register transfers with size_offs address bytes and size
+ * data bytes each. Returns the number of transfers */
+typedef ssize_t (*proto_burst_fp) (smpr_t *self, size_t size_offs, size_t size, smpr_xfer_t *xfers, size_t num_xfers);
+
+/* Poll a core for transfer completion. Sets done to true when the core is idle.
+ * Returns 0 on success or a negative number on error */
+typedef int (*smpr_poll_fp) (smpr_t *self, bool *done);
+
 typedef struct {
     const char *proto_name;                     /* Protocol name */
     proto_open_fp proto_open;                   /* Open protocol */
@@ -58,6 +80,7 @@ typedef struct {
                                                      parameter size in bytes */
     proto_write_dma_fp proto_write_dma;         /* Write arbitrary block size data via DMA,
                                                      parameter size in bytes */
+    proto_burst_fp proto_burst;                 /* Run a list of register transfers */
 } smpr_proto_ops_t;
 
 /***************** Our methods *****************/
@@ -80,6 +103,18 @@ const smpr_proto_ops_t *smpr_get_ops (smpr_t *self);
 /* Get protocol name */
 const char *smpr_get_ops_name (smpr_t *self);
 
+/* Time in microseconds to shift num_bits out at clk_freq Hz, rounded up */
+uint32_t smpr_xfer_time_us (uint32_t num_bits, uint32_t clk_freq);
+/* Wait for a transfer expected to last expected_us to complete. Sleeps for
+ * the expected time once and then polls with exponential backoff, giving up
+ * after timeout_us */
+smpr_err_e smpr_wait_completion (smpr_t *self, smpr_poll_fp poll_fp,
+        uint32_t expected_us, uint32_t timeout_us);
+/* Get the number of polls taken by the last completion wait */
+uint32_t smpr_get_wait_tries (smpr_t *self);
+/* Get the largest number of polls taken by any completion wait */
+uint32_t smpr_get_wait_max_tries (smpr_t *self);
+
 /************************************************************/
 /***************** Thsafe generic methods API ***************/
 /************************************************************/
@@ -104,6 +139,8 @@ ssize_t smpr_write_block (smpr_t *self, size_t size_offs, uint64_t offs, size_t
 ssize_t smpr_read_dma (smpr_t *self, size_t size_offs, uint64_t offs, size_t size, uint32_t *data);
 /* Write data block via DMA from protocol, size in bytes */
 ssize_t smpr_write_dma (smpr_t *self, size_t size_offs, uint64_t offs, size_t size, uint32_t *data);
+/* Run a list of register transfers back-to-back, returns the number of transfers */
+ssize_t smpr_burst (smpr_t *self, size_t size_offs, size_t size, smpr_xfer_t *xfers, size_t num_xfers);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,23 @@
+/*
+ * Copyright (C) 2014 LNLS (www.lnls.br)
+ * Author: Lucas Russo <lucas.russo@lnls.br>
+ *
+ * Released according to the GNU GPL, version 3 or any later version.
+ */
+
+#ifndef _SMIO_THSAFE_DIRECT_CLIENT_H_
+#define _SMIO_THSAFE_DIRECT_CLIENT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* For use by smio_t general structure. Accesses the parent DEVIO LLIO
+ * directly from the SMIO thread, without going through the zmq pipe */
+extern const smio_thsafe_client_ops_t smio_thsafe_client_direct_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -80,10 +80,11 @@ static struct option long_options[] =
     {"deviceentry",         required_argument,   NULL, 'e'},
     {"deviceid",            required_argument,   NULL, 'i'},
     {"logprefix",           required_argument,   NULL, 'l'},
+    {"llioaccess",          required_argument,   NULL, 'a'},
     {NULL, 0, NULL, 0}
 };
 
-static const char* shortopt = "hb:f:dw:vn:t:e:i:l:";
+static const char* shortopt = "hb:f:dw:vn:t:e:i:l:a:";
 
 void print_help (char *program_name)
 {
@@ -98,11 +99,13 @@ void print_help (char *program_name)
             "  -w  --daemonworkdir <Work Directory> Daemon working directory.\n"
             "  -v  --verbose                        Verbose output\n"
             "  -n  --deviotype <[be|fe]>            Devio type\n"
-            "  -t  --devicetype <[eth|pcie]>        Device type\n"
-            "  -e  --deviceentry <[ip_addr|/dev entry]>\n"
+            "  -t  --devicetype <[eth|pcie|sim]>    Device type. Defaults to sim for\n"
+            "                                       sim device entries\n"
+            "  -e  --deviceentry <[ip_addr|/dev entry|sim[:<latency ns>[:<MB/s>]]]>\n"
             "                                       Device entry\n"
             "  -i  --deviceid <Device ID>           Device ID\n"
-            "  -l  --logprefix <Log prefix>         Log prefix filename\n",
+            "  -l  --logprefix <Log prefix>         Log prefix filename\n"
+            "  -a  --llioaccess <[zmq|direct]>      SMIO access to LLIO (default: zmq)\n",
             program_name,
             revision_get_build_version (),
             revision_get_build_user_name (), revision_get_build_date ());
@@ -120,6 +123,7 @@ int main (int argc, char *argv[])
     char *broker_endp = NULL;
     char *log_prefix = NULL;
     char *cfg_file = NULL;
+    char *llio_access = NULL;
     int opt;
 
     while ((opt = getopt_long (argc, argv, shortopt, long_options, NULL)) != -1) {
@@ -181,6 +185,11 @@ int main (int argc, char *argv[])
                 log_prefix = strdup (optarg);
                 break;
 
+            case 'a':
+                DBE_DEBUG (DBG_DEV_IO | DBG_LVL_TRACE, "[halcsd] Will set llio_access parameter\n");
+                llio_access = strdup (optarg);
+                break;
+
             case '?':
                 DBE_DEBUG (DBG_DEV_MNGR | DBG_LVL_FATAL, "[halcsd] Option not recognized or missing argument\n");
                 print_help (argv [0]);
@@ -245,6 +254,16 @@ int main (int argc, char *argv[])
         }
     }
 
+    /* A simulated device entry is enough to tell the device type */
+    size_t sim_prefix_len = strlen (LLIO_SIM_ENDPOINT_PREFIX);
+    if (dev_type == NULL && dev_entry != NULL &&
+            strncmp (dev_entry, LLIO_SIM_ENDPOINT_PREFIX, sim_prefix_len) == 0 &&
+            (dev_entry [sim_prefix_len] == '\0' || dev_entry [sim_prefix_len] == ':')) {
+        DBE_DEBUG (DBG_DEV_IO | DBG_LVL_INFO, "[halcsd] Dev_type parameter was not set, "
+                "but Dev_entry is simulated.\n\tDefaulting Dev_type to sim\n");
+        dev_type = strdup ("sim");
+    }
+
     llio_type_e llio_type = llio_str_to_type (dev_type);
     /* Parse command-line options */
     if (llio_type == INVALID_DEV) {
@@ -259,6 +278,19 @@ int main (int argc, char *argv[])
         goto err_exit;
     }
 
+    /* SMIOs go through the DEVIO zmq pipe by default. The direct access
+     * calls the LLIO from the SMIO threads, serialized by DEVIO locks */
+    const smio_thsafe_client_ops_t *thsafe_client_ops = &smio_thsafe_client_zmq_ops;
+    if (llio_access != NULL) {
+        if (streq (llio_access, "direct")) {
+            thsafe_client_ops = &smio_thsafe_client_direct_ops;
+        }
+        else if (!streq (llio_access, "zmq")) {
+            DBE_DEBUG (DBG_DEV_IO | DBG_LVL_FATAL, "[halcsd] Llio_access parameter is invalid\n");
+            goto err_exit;
+        }
+    }
+
     /* At least one ID must be set */
     if (dev_entry == NULL && dev_id_str == NULL) {
         DBE_DEBUG (DBG_DEV_IO | DBG_LVL_INFO, "[halcsd] Dev_entry and Dev_id parameters "
@@ -363,6 +395,28 @@ int main (int argc, char *argv[])
             llio_ops = &llio_ops_pcie;
             break;
 
+        case SIM_DEV:
+            if (dev_entry != NULL && dev_id_str == NULL) {
+                DBE_DEBUG (DBG_DEV_IO | DBG_LVL_INFO, "[halcsd] Dev_id parameter was not set, but Dev_entry was.\n"
+                        "\tDefaulting Dev_id to 1\n");
+                full_dev_id = 1;
+                dev_id = board_epics_map [full_dev_id].dev_id;
+                fe_smio_id = board_epics_map [full_dev_id].smio_id;
+            }
+
+            if (dev_entry == NULL && dev_id_str != NULL) {
+                DBE_DEBUG (DBG_DEV_IO | DBG_LVL_INFO, "[halcsd] Dev_id parameter was set, but Dev_entry was not.\n"
+                        "\tDefaulting Dev_entry to "LLIO_SIM_ENDPOINT_PREFIX"\n");
+                dev_entry = strdup (LLIO_SIM_ENDPOINT_PREFIX);
+            }
+
+            /* The simulated device models a PCIe one */
+            ASSERT_TEST (fe_smio_id == 0, "Invalid Dev_id for SIM_DEV. Only "
+                    "odd device IDs are available", err_exit, 0);
+
+            llio_ops = &llio_ops_sim;
+            break;
+
         default:
             DBE_DEBUG (DBG_DEV_IO | DBG_LVL_INFO, "[halcsd] Invalid Dev_type. Exiting ...\n");
             llio_ops = NULL;
@@ -401,7 +455,8 @@ int main (int argc, char *argv[])
     /* FE DEVIO is expected to have a correct dev_id. So, we don't need to get it
      * from Hardware */
     halcs_client_t *client_cfg = NULL;
-    if (devio_type == BE_DEVIO) {
+    /* There is no Config DEVIO for simulated devices either */
+    if (devio_type == BE_DEVIO && llio_type != SIM_DEV) {
         /* At this point, the Config DEVIO is ready to receive our commands */
         char devio_config_service_str [DEVIO_SERVICE_LEN];
         snprintf (devio_config_service_str, DEVIO_SERVICE_LEN-1, "HALCS%u:DEVIO_CFG:AFC_DIAG%u",
@@ -473,6 +528,9 @@ int main (int argc, char *argv[])
             broker_endp, verbose, devio_log_filename);
     ASSERT_ALLOC (devio, err_devio_alloc);
 
+    /* Must be set before any SMIO is spawned */
+    devio_set_thsafe_client_ops (devio, thsafe_client_ops);
+
     /* We don't need it anymore */
     free (dev_entry);
     dev_entry = NULL;
@@ -541,6 +599,7 @@ err_client_cfg:
     kill (child_devio_cfg_pid, DEVIO_KILL_CFG_SIGNAL);
 #endif
 err_exit:
+    free (llio_access);
     free (log_prefix);
     free (broker_endp);
     free (dev_id_str);
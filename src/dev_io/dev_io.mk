@@ -7,5 +7,6 @@ dev_io_core_utils_OBJS = $(dev_io_DIR)/dev_io_utils.o
 # makefile
 dev_io_core_OBJS = $(dev_io_DIR)/dev_io_core.o \
 		   $(dev_io_DIR)/dev_io_err.o \
+		   $(dev_io_DIR)/dev_io_sim.o \
 		   $(dev_io_core_utils_OBJS)
 
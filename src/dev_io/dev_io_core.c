@@ -40,6 +40,12 @@
 
 #define DEVIO_MAX_DESTRUCT_MSG_TRIES        10
 #define DEVIO_LINGER_TIME                   100         /* in ms */
+/* One LLIO lock for each possible PCIe BAR. The paging registers are shared
+ * among all accesses to the same BAR, so this is the finest granularity we can
+ * safely use. Other endpoints have no BARs and share their connection among
+ * all of the accesses, so they always use the first lock */
+#define DEVIO_LLIO_LOCKS_NUM                (1 << PCIE_ADDR_BAR_MAX)
+#define DEVIO_LLIO_LOCK_IDX(offs)           (PCIE_ADDR_BAR(offs) % DEVIO_LLIO_LOCKS_NUM)
 
 struct _devio_t {
     /* General information */
@@ -67,6 +73,14 @@ struct _devio_t {
      * smio client part of the llio operations and the de-facto
      * llio operations */
     const disp_op_t **thsafe_server_ops;
+    /* Client part of the llio operations used by the SMIOs spawned by this
+     * devio. Defaults to the zmq pipe bridge to thsafe_server_ops */
+    const smio_thsafe_client_ops_t *thsafe_client_ops;
+    /* Serialize LLIO accesses coming from the thsafe server and from SMIOs
+     * accessing the LLIO directly */
+    pthread_mutex_t llio_locks [DEVIO_LLIO_LOCKS_NUM];
+    /* Use one lock per PCIe BAR instead of only the first one */
+    bool llio_bar_locks;
     /* Hash containing all the sm_io objects that
      * this dev_io can handle. It is composed
      * of key (10-char ID) / value (sm_io instance) */
@@ -130,9 +144,24 @@ static int _devio_read_llio_block (struct sdbfs *fs, int offset, void *buf,
     devio_t *devio = (devio_t *)fs->drvdata;
     llio_t *llio = devio->llio;
     uint64_t llio_sdb_prefix_addr = llio_get_sdb_prefix_addr (llio);
+    uint64_t offs = llio_sdb_prefix_addr | (offset);
 
-    return llio_read_block (llio, llio_sdb_prefix_addr |
-            (offset), count, (uint32_t *) buf);
+    devio_lock_llio (devio, offs);
+    int ret = llio_read_block (llio, offs, count, (uint32_t *) buf);
+    devio_unlock_llio (devio, offs);
+
+    return ret;
+}
+
+static bool _devio_is_sim (devio_t *self)
+{
+    return streq (llio_get_ops_name (self->llio), "SIM");
+}
+
+/* Only PCIe devices and their simulation carry an SDB */
+static bool _devio_has_sdb (devio_t *self)
+{
+    return streq (llio_get_ops_name (self->llio), "PCIE") || _devio_is_sim (self);
 }
 
 /* Default signal handlers */
@@ -248,6 +277,13 @@ devio_t * devio_new (char *name, uint32_t id, char *endpoint_dev,
     derr = _devio_register_sig_handlers (self);
     ASSERT_TEST(derr==DEVIO_SUCCESS, "Error registering setting up signal handlers", err_sig_handlers);
 
+    /* Initialize LLIO locks before anyone has the chance to use the LLIO */
+    unsigned int i;
+    for (i = 0; i < DEVIO_LLIO_LOCKS_NUM; ++i) {
+        int lerr = pthread_mutex_init (&self->llio_locks [i], NULL);
+        ASSERT_TEST(lerr == 0, "Could not initialize LLIO lock", err_llio_locks_init);
+    }
+
     /* Concatenate recv'ed name with a llio identifier */
     char *llio_name = zmalloc (sizeof (char)*(strlen(name)+strlen(LLIO_STR)+1));
     ASSERT_ALLOC(llio_name, err_llio_name_alloc);
@@ -256,11 +292,21 @@ devio_t * devio_new (char *name, uint32_t id, char *endpoint_dev,
     self->llio = llio_new (llio_name, endpoint_dev, reg_ops,
             verbose);
     ASSERT_ALLOC(self->llio, err_llio_alloc);
+    /* The simulated device uses the PCIe BAR layout as well */
+    self->llio_bar_locks = streq (llio_get_ops_name (self->llio), "PCIE") ||
+        _devio_is_sim (self);
 
     /* We try to open the device */
     int err = llio_open (self->llio, NULL);
     ASSERT_TEST(err==0, "Error opening device!", err_llio_open);
 
+    /* A simulated device starts out as blank memory */
+    if (_devio_is_sim (self)) {
+        err = devio_sim_model_init (self->llio);
+        ASSERT_TEST(err == DEVIO_SUCCESS, "Could not initialize simulated device",
+                err_sim_model_init);
+    }
+
     /* We can free llio_name now, as llio copies the string */
     free (llio_name);
     llio_name = NULL; /* Avoid double free error */
@@ -281,7 +327,7 @@ devio_t * devio_new (char *name, uint32_t id, char *endpoint_dev,
     /* Create SDB. If the device does not support SDB, this will fail.
      * So, avoid creating SDB in this case, for now, as some unsupported
      * endpoints do not have timeout implemented just yet */
-    if (streq (llio_get_ops_name (self->llio), "PCIE")) {
+    if (_devio_has_sdb (self)) {
         err = sdbfs_dev_create (self->sdbfs);
         ASSERT_TEST (err == 0, "Could not create SDBFS",
                 err_sdbfs_create, DEVIO_ERR_SMIO_DO_OP);
@@ -290,6 +336,9 @@ devio_t * devio_new (char *name, uint32_t id, char *endpoint_dev,
     /* Init sm_io_thsafe_server_ops_h. For now, we assume we want zmq
      * for exchanging messages between smio and devio instances */
     self->thsafe_server_ops = smio_thsafe_zmq_server_ops;
+    /* SMIOs talk to the thsafe server through zmq unless told otherwise.
+     * See devio_set_thsafe_client_ops () */
+    self->thsafe_client_ops = &smio_thsafe_client_zmq_ops;
 
     /* Init sm_io_h hash */
     self->sm_io_h = zhashx_new ();
@@ -323,19 +372,23 @@ err_disp_table_thsafe_ops_alloc:
 err_sm_io_cfg_h_alloc:
     zhashx_destroy (&self->sm_io_h);
 err_sm_io_h_alloc:
-    if (streq (llio_get_ops_name (self->llio), "PCIE")) {
+    if (_devio_has_sdb (self)) {
         sdbfs_dev_destroy (self->sdbfs);
     }
 err_sdbfs_create:
     free (self->sdbfs);
 err_sdbfs_alloc:
+err_sim_model_init:
     llio_release (self->llio, NULL);
 err_llio_open:
     llio_destroy (&self->llio);
 err_llio_alloc:
     free (llio_name);
 err_llio_name_alloc:
-    /* Nothing to undo */
+err_llio_locks_init:
+    while (i-- > 0) {
+        pthread_mutex_destroy (&self->llio_locks [i]);
+    }
 err_sig_handlers:
     /* Nothing to undo */
 err_set_sig_handlers:
@@ -416,6 +469,12 @@ devio_err_e devio_destroy (devio_t **self_p)
         DBE_DEBUG (DBG_DEV_IO | DBG_LVL_INFO,
                 "[dev_io_core:destroy] LLIO destroyed\n");
 
+        self->thsafe_client_ops = NULL;
+        unsigned int l;
+        for (l = 0; l < DEVIO_LLIO_LOCKS_NUM; ++l) {
+            pthread_mutex_destroy (&self->llio_locks [l]);
+        }
+
         DBE_DEBUG (DBG_DEV_IO | DBG_LVL_INFO,
                 "[dev_io_core:destroy] Destroying general operation handlers\n");
         zlistx_destroy (&self->ops->sig_ops);
@@ -474,7 +533,7 @@ devio_err_e devio_print_info (devio_t *self)
     devio_err_e err = DEVIO_SUCCESS;
 
     /* FIXME: Only valid for PCIe devices */
-    ASSERT_TEST (streq (llio_get_ops_name (self->llio), "PCIE"),
+    ASSERT_TEST (_devio_has_sdb (self),
             "SDB is only supported for PCIe devices",
             err_sdb_not_supp, DEVIO_ERR_FUNC_NOT_IMPL);
 
@@ -989,7 +1048,7 @@ static devio_err_e _devio_register_all_sm_raw (devio_t *self)
     uint32_t smio_id = 0;
 
     /* FIXME: Only valid for PCIe devices */
-    ASSERT_TEST (streq (llio_get_ops_name (self->llio), "PCIE"),
+    ASSERT_TEST (_devio_has_sdb (self),
             "SDB is only supported for PCIe devices",
             err_sdb_not_supp, DEVIO_ERR_FUNC_NOT_IMPL);
 
@@ -1133,6 +1192,140 @@ llio_t *devio_get_llio (devio_t *self)
     return self->llio;
 }
 
+devio_err_e devio_set_thsafe_client_ops (devio_t *self,
+        const smio_thsafe_client_ops_t *thsafe_client_ops)
+{
+    assert (self);
+    assert (thsafe_client_ops);
+
+    self->thsafe_client_ops = thsafe_client_ops;
+    return DEVIO_SUCCESS;
+}
+
+const smio_thsafe_client_ops_t *devio_get_thsafe_client_ops (devio_t *self)
+{
+    assert (self);
+    return self->thsafe_client_ops;
+}
+
+static uint32_t _devio_llio_lock_mask (devio_t *self, uint64_t offs)
+{
+    return self->llio_bar_locks ? (1 << DEVIO_LLIO_LOCK_IDX(offs)) : 1;
+}
+
+/* Take every lock in locks_mask, always in ascending order, and release them
+ * in the reverse order. Everyone taking more than one lock goes through here,
+ * so this can't deadlock */
+static void _devio_lock_llio_mask (devio_t *self, uint32_t locks_mask)
+{
+    unsigned int i;
+    for (i = 0; i < DEVIO_LLIO_LOCKS_NUM; ++i) {
+        if (locks_mask & (1 << i)) {
+            pthread_mutex_lock (&self->llio_locks [i]);
+        }
+    }
+}
+
+static void _devio_unlock_llio_mask (devio_t *self, uint32_t locks_mask)
+{
+    unsigned int i;
+    for (i = DEVIO_LLIO_LOCKS_NUM; i-- > 0;) {
+        if (locks_mask & (1 << i)) {
+            pthread_mutex_unlock (&self->llio_locks [i]);
+        }
+    }
+}
+
+void devio_lock_llio (devio_t *self, uint64_t offs)
+{
+    assert (self);
+    _devio_lock_llio_mask (self, _devio_llio_lock_mask (self, offs));
+}
+
+void devio_unlock_llio (devio_t *self, uint64_t offs)
+{
+    assert (self);
+    _devio_unlock_llio_mask (self, _devio_llio_lock_mask (self, offs));
+}
+
+/* DMA transfers program the DMA engine registers in BAR0, besides accessing
+ * the memory at offs */
+void devio_lock_llio_dma (devio_t *self, uint64_t offs)
+{
+    assert (self);
+    _devio_lock_llio_mask (self, _devio_llio_lock_mask (self, offs) |
+            _devio_llio_lock_mask (self, BAR0_ADDR));
+}
+
+void devio_unlock_llio_dma (devio_t *self, uint64_t offs)
+{
+    assert (self);
+    _devio_unlock_llio_mask (self, _devio_llio_lock_mask (self, offs) |
+            _devio_llio_lock_mask (self, BAR0_ADDR));
+}
+
+static ssize_t _devio_llio_txn_op (devio_t *self, smio_thsafe_txn_op_t *op)
+{
+    ssize_t llio_ret = -1;
+    uint32_t value = 0;
+
+    switch (op->type) {
+        case THSAFE_TXN_OP_READ_32:
+            llio_ret = llio_read_32 (self->llio, op->offs, &value);
+            op->data = value;
+            break;
+
+        case THSAFE_TXN_OP_WRITE_32:
+            llio_ret = llio_write_32 (self->llio, op->offs, &op->data);
+            break;
+
+        case THSAFE_TXN_OP_RMW_32:
+            llio_ret = llio_read_32 (self->llio, op->offs, &value);
+            if (llio_ret < 0) {
+                break;
+            }
+            uint32_t new_value = (value & ~op->mask) | (op->data & op->mask);
+            llio_ret = llio_write_32 (self->llio, op->offs, &new_value);
+            op->data = value;
+            break;
+
+        default:
+            DBE_DEBUG (DBG_DEV_IO | DBG_LVL_ERR, "[dev_io_core:llio_txn] "
+                    "Invalid transaction operation type %u\n", op->type);
+    }
+
+    return llio_ret;
+}
+
+ssize_t devio_llio_txn (devio_t *self, smio_thsafe_txn_op_t *ops, uint32_t num_ops)
+{
+    assert (self);
+    assert (ops);
+    ssize_t ret = num_ops * sizeof (*ops);
+    uint32_t locks_mask = 0;
+    uint32_t i;
+
+    /* Take every lock the transaction needs */
+    for (i = 0; i < num_ops; ++i) {
+        locks_mask |= _devio_llio_lock_mask (self, ops [i].offs);
+    }
+    _devio_lock_llio_mask (self, locks_mask);
+
+    for (i = 0; i < num_ops; ++i) {
+        ssize_t llio_ret = _devio_llio_txn_op (self, &ops [i]);
+        if (llio_ret < 0) {
+            DBE_DEBUG (DBG_DEV_IO | DBG_LVL_ERR, "[dev_io_core:llio_txn] "
+                    "Transaction aborted at operation #%u\n", i);
+            ret = llio_ret;
+            break;
+        }
+    }
+
+    _devio_unlock_llio_mask (self, locks_mask);
+
+    return ret;
+}
+
 devio_err_e devio_set_sig_handler (devio_t *self, devio_sig_handler_t *sig_handler)
 {
     assert (self);
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2014 LNLS (www.lnls.br)
+ * Author: Lucas Russo <lucas.russo@lnls.br>
+ *
+ * Released according to the GNU GPL, version 3 or any later version.
+ */
+
+/* Description: Register models for the simulated device. Only what the
+ * SMIOs need to come up and run is modelled: the SDB ROM and the
+ * acquisition FSM, which completes right after being started */
+
+#include "halcs_server.h"
+#include "hw/wb_acq_core_regs.h"
+
+/* Undef ASSERT_ALLOC to avoid conflicting with other ASSERT_ALLOC */
+#ifdef ASSERT_TEST
+#undef ASSERT_TEST
+#endif
+#define ASSERT_TEST(test_boolean, err_str, err_goto_label, /* err_core */ ...) \
+    ASSERT_HAL_TEST(test_boolean, DEV_IO, "[dev_io:sim]",           \
+            err_str, err_goto_label, /* err_core */ __VA_ARGS__)
+
+#ifdef ASSERT_ALLOC
+#undef ASSERT_ALLOC
+#endif
+#define ASSERT_ALLOC(ptr, err_goto_label, /* err_core */ ...)       \
+    ASSERT_HAL_ALLOC(ptr, DEV_IO, "[dev_io:sim]",                   \
+            devio_err_str(DEVIO_ERR_ALLOC),                         \
+            err_goto_label, /* err_core */ __VA_ARGS__)
+
+#ifdef CHECK_ERR
+#undef CHECK_ERR
+#endif
+#define CHECK_ERR(err, err_type)                                    \
+    CHECK_HAL_ERR(err, DEV_IO, "[dev_io:sim]",                      \
+            devio_err_str (err_type))
+
+/* From sm_io_acq_exp.h */
+#define DEVIO_SIM_ACQ_SDB_DEVID             0x4519a0ad
+#define DEVIO_SIM_ACQ_SDB_NAME              "ACQ"
+#define DEVIO_SIM_SDB_VENDORID              0x1000000000001215ULL   /* LNLS */
+#define DEVIO_SIM_SDB_NAME                  "HALCS_SIM"
+#define DEVIO_SIM_SDB_NUM_RECORDS           (1 + NUM_ACQ_CORE_SMIOS)
+#define DEVIO_SIM_SDB_RECORD_SIZE           64
+
+#define DEVIO_SIM_ACQ_CORE_IDLE             ACQ_CORE_STA_FSM_STATE_W(1)
+#define DEVIO_SIM_ACQ_CORE_DONE             (ACQ_CORE_STA_FSM_STATE_W(1) | \
+                                                ACQ_CORE_STA_FSM_ACQ_DONE | \
+                                                ACQ_CORE_STA_FC_TRANS_DONE | \
+                                                ACQ_CORE_STA_DDR3_TRANS_DONE)
+
+static void _devio_sim_set_product (struct sdb_product *product, uint32_t device_id,
+        const char *name, uint8_t record_type);
+static devio_err_e _devio_sim_load_sdb (llio_t *llio);
+static devio_err_e _devio_sim_init_acq_core (llio_t *llio, uint64_t base);
+static void _devio_sim_acq_core_ctl_hook (llio_t *llio, uint64_t offs,
+        uint32_t data, void *hook_arg);
+
+devio_err_e devio_sim_model_init (llio_t *llio)
+{
+    assert (llio);
+
+    devio_err_e err = _devio_sim_load_sdb (llio);
+    ASSERT_TEST(err == DEVIO_SUCCESS, "Could not load simulated SDB ROM",
+            err_load_sdb);
+
+    unsigned int i;
+    for (i = 0; i < NUM_ACQ_CORE_SMIOS; ++i) {
+        err = _devio_sim_init_acq_core (llio, BAR4_ADDR |
+                (DEVIO_SIM_ACQ_CORE_BASE + i*DEVIO_SIM_ACQ_CORE_SIZE));
+        ASSERT_TEST(err == DEVIO_SUCCESS, "Could not initialize simulated ACQ core",
+                err_init_acq_core);
+    }
+
+    DBE_DEBUG (DBG_DEV_IO | DBG_LVL_INFO, "[dev_io:sim] Simulated device "
+            "initialized with %u ACQ cores\n", NUM_ACQ_CORE_SMIOS);
+
+err_init_acq_core:
+err_load_sdb:
+    return err;
+}
+
+/**************** Helper Functions ***************/
+
+static void _devio_sim_set_product (struct sdb_product *product, uint32_t device_id,
+        const char *name, uint8_t record_type)
+{
+    product->vendor_id = ntohll (DEVIO_SIM_SDB_VENDORID);
+    product->device_id = htonl (device_id);
+    product->version = htonl (1);
+    /* SDB names are padded with spaces, not NULL-terminated */
+    memset (product->name, ' ', sizeof (product->name));
+    memcpy (product->name, name, strlen (name));
+    product->record_type = record_type;
+}
+
+/* The ROM is big-endian, as in the FPGA */
+static devio_err_e _devio_sim_load_sdb (llio_t *llio)
+{
+    uint8_t rom [DEVIO_SIM_SDB_NUM_RECORDS*DEVIO_SIM_SDB_RECORD_SIZE];
+    memset (rom, 0, sizeof (rom));
+
+    struct sdb_interconnect *intercon = (struct sdb_interconnect *) rom;
+    intercon->sdb_magic = htonl (SDB_MAGIC);
+    intercon->sdb_records = htons (DEVIO_SIM_SDB_NUM_RECORDS);
+    intercon->sdb_version = 1;
+    intercon->sdb_bus_type = sdb_wishbone;
+    intercon->sdb_component.addr_first = 0;
+    intercon->sdb_component.addr_last = ntohll (LLIO_SIM_BAR4_SIZE - 1);
+    _devio_sim_set_product (&intercon->sdb_component.product, 0,
+            DEVIO_SIM_SDB_NAME, sdb_type_interconnect);
+
+    unsigned int i;
+    for (i = 0; i < NUM_ACQ_CORE_SMIOS; ++i) {
+        struct sdb_device *dev = (struct sdb_device *) (rom +
+                (i+1)*DEVIO_SIM_SDB_RECORD_SIZE);
+        uint64_t addr_first = DEVIO_SIM_ACQ_CORE_BASE + i*DEVIO_SIM_ACQ_CORE_SIZE;
+
+        dev->abi_ver_major = 1;
+        dev->bus_specific = htonl (SDB_WB_ACCESS32);
+        dev->sdb_component.addr_first = ntohll (addr_first);
+        dev->sdb_component.addr_last = ntohll (addr_first + DEVIO_SIM_ACQ_CORE_SIZE - 1);
+        _devio_sim_set_product (&dev->sdb_component.product, DEVIO_SIM_ACQ_SDB_DEVID,
+                DEVIO_SIM_ACQ_SDB_NAME, sdb_type_device);
+    }
+
+    devio_err_e err = DEVIO_SUCCESS;
+    llio_err_e lerr = llio_sim_load (llio, BAR4_ADDR | SDB_ADDRESS, rom,
+            sizeof (rom));
+    ASSERT_TEST(lerr == LLIO_SUCCESS, "Could not write SDB ROM", err_load,
+            DEVIO_ERR_MOD_LLIO);
+
+err_load:
+    return err;
+}
+
+static devio_err_e _devio_sim_init_acq_core (llio_t *llio, uint64_t base)
+{
+    devio_err_e err = DEVIO_SUCCESS;
+    llio_err_e lerr = llio_sim_poke_32 (llio, base | ACQ_CORE_REG_STA,
+            DEVIO_SIM_ACQ_CORE_IDLE);
+    ASSERT_TEST(lerr == LLIO_SUCCESS, "Could not set ACQ core status", err_poke,
+            DEVIO_ERR_MOD_LLIO);
+
+    lerr = llio_sim_set_write_hook (llio, base | ACQ_CORE_REG_CTL,
+            _devio_sim_acq_core_ctl_hook, NULL);
+    ASSERT_TEST(lerr == LLIO_SUCCESS, "Could not set ACQ core control hook",
+            err_set_hook, DEVIO_ERR_MOD_LLIO);
+
+err_set_hook:
+err_poke:
+    return err;
+}
+
+/* Starting an acquisition completes it at once. The trigger is placed at
+ * the start of the channel memory, so readers see a wrapped buffer */
+static void _devio_sim_acq_core_ctl_hook (llio_t *llio, uint64_t offs,
+        uint32_t data, void *hook_arg)
+{
+    (void) hook_arg;
+
+    if (!(data & ACQ_CORE_CTL_FSM_START_ACQ)) {
+        return;
+    }
+
+    uint64_t base = offs - ACQ_CORE_REG_CTL;
+    uint32_t start_addr = 0;
+    uint32_t pre_samples = 0;
+    uint32_t post_samples = 0;
+
+    llio_sim_peek_32 (llio, base | ACQ_CORE_REG_DDR3_START_ADDR, &start_addr);
+    llio_sim_peek_32 (llio, base | ACQ_CORE_REG_PRE_SAMPLES, &pre_samples);
+    llio_sim_peek_32 (llio, base | ACQ_CORE_REG_POST_SAMPLES, &post_samples);
+
+    llio_sim_poke_32 (llio, base | ACQ_CORE_REG_TRIG_POS, start_addr);
+    llio_sim_poke_32 (llio, base | ACQ_CORE_REG_SAMPLES_CNT, pre_samples + post_samples);
+    llio_sim_poke_32 (llio, base | ACQ_CORE_REG_STA, DEVIO_SIM_ACQ_CORE_DONE);
+    /* The start bit is a strobe */
+    llio_sim_poke_32 (llio, offs, data & ~ACQ_CORE_CTL_FSM_START_ACQ);
+
+    DBE_DEBUG (DBG_DEV_IO | DBG_LVL_TRACE, "[dev_io:sim] ACQ core @ 0x%016"PRIX64
+            " completed acquisition of %u samples\n", base, pre_samples + post_samples);
+}
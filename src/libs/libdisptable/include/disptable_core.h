@@ -83,6 +83,11 @@ typedef struct {
 typedef struct {
     const disp_op_t *op;                    /* Function description */
     void *ret;                              /* Buffer for function return value */
+    void *ret_spare;                        /* Return buffer given back after being
+                                               lent. See disp_table_lend_ret () */
+    int refs;                               /* References to this handler. One
+                                               for the table, one for each lent
+                                               buffer */
 } disp_op_handler_t;
 
 /************************************************************/
@@ -118,6 +123,11 @@ int disp_table_call (disp_table_t *self, uint32_t key, void *owner, void *args,
 int disp_table_check_call (disp_table_t *self, uint32_t key, void *owner,
         void *args, void **ret);
 disp_table_err_e disp_table_set_ret (disp_table_t *self, uint32_t key, void **ret);
+/* Lend the current return buffer of "key" to someone else, typically to be
+ * sent as a zero-copy message. The function gets another buffer for the
+ * next calls. The buffer must be given back with disp_op_handler_release_ret (),
+ * with the returned "hint". Returns NULL if the buffer can't be lent */
+void *disp_table_lend_ret (disp_table_t *self, uint32_t key, void **hint);
 
 /************************************************************/
 /**************** Disp Op Handler functions *****************/
@@ -125,6 +135,9 @@ disp_table_err_e disp_table_set_ret (disp_table_t *self, uint32_t key, void **re
 
 disp_op_handler_t *disp_op_handler_new (void);
 disp_table_err_e disp_op_handler_destroy (disp_op_handler_t **self_p);
+/* Give back a buffer lent by disp_table_lend_ret (). Safe to be called
+ * from any thread. Signature compatible with zmq_free_fn */
+void disp_op_handler_release_ret (void *data, void *hint);
 
 #ifdef __cplusplus
 }
@@ -36,11 +36,18 @@
     CHECK_HAL_ERR(err, HAL_UTILS, "[disp_table]",                               \
             disp_table_err_str (err_type))
 
+/* Opcodes are small and contiguous, so we just index a dense array by
+ * them. Keep a sane upper limit to avoid huge tables on bogus opcodes */
+#define DISP_TABLE_INIT_SIZE                32
+#define DISP_TABLE_MAX_SIZE                 65536
+
 struct _disp_table_t {
-    /* Hash containg all the sm_io thsafe operations
-     * that we need to handle. It is composed
-     * of key (4-char ID) / value (pointer to funtion) */
-    zhashx_t *table_h;
+    /* Array containg all the sm_io thsafe operations
+     * that we need to handle, indexed by opcode. Unregistered
+     * opcodes are NULL */
+    disp_op_handler_t **table;
+    /* Number of entries in table */
+    uint32_t table_size;
     /* Dispatch table operations */
     const disp_table_ops_t *ops;
 };
@@ -49,7 +56,7 @@ static disp_table_err_e _disp_table_insert (disp_table_t *self, const disp_op_t*
 static disp_table_err_e _disp_table_insert_all (disp_table_t *self, const disp_op_t **disp_ops);
 static disp_table_err_e _disp_table_remove (disp_table_t *self, uint32_t key);
 static disp_table_err_e _disp_table_remove_all (disp_table_t *self);
-static void _disp_table_free_item (void **data);
+static disp_table_err_e _disp_table_grow (disp_table_t *self, uint32_t key);
 static disp_table_err_e _disp_table_check_args (disp_table_t *self, uint32_t key,
         void *args, void **ret);
 static int _disp_table_call (disp_table_t *self, uint32_t key, void *owner, void *args,
@@ -68,14 +75,14 @@ disp_table_t *disp_table_new (const disp_table_ops_t *ops)
 
     disp_table_t *self = zmalloc (sizeof *self);
     ASSERT_ALLOC (self, err_self_alloc);
-    self->table_h = zhashx_new ();
-    ASSERT_ALLOC (self->table_h, err_table_h_alloc);
-    zhashx_set_destructor (self->table_h, _disp_table_free_item);
+    self->table = zmalloc (DISP_TABLE_INIT_SIZE * sizeof (*self->table));
+    ASSERT_ALLOC (self->table, err_table_alloc);
+    self->table_size = DISP_TABLE_INIT_SIZE;
     self->ops = ops;
 
     return self;
 
-err_table_h_alloc:
+err_table_alloc:
     free (self);
 err_self_alloc:
     return NULL;
@@ -90,7 +97,9 @@ disp_table_err_e disp_table_destroy (disp_table_t **self_p)
 
         _disp_table_remove_all (self);
         self->ops = NULL;
-        zhashx_destroy (&self->table_h);
+        free (self->table);
+        self->table = NULL;
+        self->table_size = 0;
         free (self);
         *self_p = NULL;
     }
@@ -167,7 +176,7 @@ err_disp_op_handler_null:
 const disp_op_t *disp_table_lookup (disp_table_t *self, uint32_t key)
 {
     disp_op_handler_t *disp_op_handler = _disp_table_lookup (self, key);
-    return disp_op_handler->op;
+    return (disp_op_handler != NULL) ? disp_op_handler->op : NULL;
 }
 
 int disp_table_call (disp_table_t *self, uint32_t key, void *owner, void *args,
@@ -201,6 +210,42 @@ disp_table_err_e disp_table_set_ret (disp_table_t *self, uint32_t key, void **re
     return _disp_table_set_ret (self, key, ret);
 }
 
+void *disp_table_lend_ret (disp_table_t *self, uint32_t key, void **hint)
+{
+    assert (hint);
+    void *lent = NULL;
+    disp_op_handler_t *disp_op_handler = _disp_table_lookup (self, key);
+    ASSERT_TEST (disp_op_handler != NULL, "Could not find registered key",
+            err_disp_op_handler_null);
+
+    /* Only buffers allocated by us can be lent */
+    if (disp_op_handler->ret == NULL ||
+            disp_op_handler->op->retval_owner == DISP_OWNER_FUNC) {
+        goto err_no_ownership;
+    }
+
+    /* Reuse a buffer previously given back, if any. In the steady state
+     * two buffers alternate between the function and the borrower */
+    void *new_ret = __atomic_exchange_n (&disp_op_handler->ret_spare, NULL,
+            __ATOMIC_ACQ_REL);
+    if (new_ret == NULL) {
+        new_ret = zmalloc (DISP_GET_ASIZE(disp_op_handler->op->retval));
+        ASSERT_ALLOC (new_ret, err_new_ret_alloc);
+    }
+
+    lent = disp_op_handler->ret;
+    disp_op_handler->ret = new_ret;
+    /* The lent buffer holds a reference to the handler, so it can be safely
+     * given back even after the handler is removed from the table */
+    __atomic_add_fetch (&disp_op_handler->refs, 1, __ATOMIC_ACQ_REL);
+    *hint = disp_op_handler;
+
+err_new_ret_alloc:
+err_no_ownership:
+err_disp_op_handler_null:
+    return lent;
+}
+
 /******************************************************************************/
 /************************** Local static functions ****************************/
 /******************************************************************************/
@@ -225,18 +270,18 @@ static disp_table_err_e _disp_table_insert (disp_table_t *self, const disp_op_t
     ASSERT_TEST (herr == DISP_TABLE_SUCCESS, "Return value could not be allocated",
             err_alloc_ret);
 
-    char *key_c = hutils_stringify_hex_key (disp_op_handler->op->opcode);
-    ASSERT_ALLOC (key_c, err_key_c_alloc);
-    int zerr = zhashx_insert (self->table_h, key_c, disp_op_handler);
-    ASSERT_TEST(zerr == 0, "Could not insert item into dispatch table",
-            err_insert_hash);
+    uint32_t key = disp_op_handler->op->opcode;
+    herr = _disp_table_grow (self, key);
+    ASSERT_TEST(herr == DISP_TABLE_SUCCESS, "Could not grow dispatch table",
+            err_grow_table);
+    ASSERT_TEST(self->table [key] == NULL, "Could not insert item into dispatch table. "
+            "Opcode already registered", err_insert_table);
 
-    free (key_c);
+    self->table [key] = disp_op_handler;
     return DISP_TABLE_SUCCESS;
 
-err_insert_hash:
-    free (key_c);
-err_key_c_alloc:
+err_insert_table:
+err_grow_table:
     _disp_table_cleanup_args_op (disp_op_handler);
 err_alloc_ret:
     disp_op_handler_destroy (&disp_op_handler);
@@ -244,10 +289,35 @@ err_disp_op_handler_new:
     return DISP_TABLE_ERR_ALLOC;
 }
 
-static void _disp_table_free_item (void **data)
+static disp_table_err_e _disp_table_grow (disp_table_t *self, uint32_t key)
 {
-    disp_op_handler_t **disp_op_handler = (disp_op_handler_t **) data;
-    disp_op_handler_destroy (disp_op_handler);
+    assert (self);
+
+    if (key < self->table_size) {
+        return DISP_TABLE_SUCCESS;
+    }
+
+    ASSERT_TEST(key < DISP_TABLE_MAX_SIZE, "Opcode is out of the dispatch table "
+            "maximum range", err_key_oor);
+
+    uint32_t new_size = self->table_size;
+    while (new_size <= key) {
+        new_size *= 2;
+    }
+
+    disp_op_handler_t **new_table = realloc (self->table,
+            new_size * sizeof (*self->table));
+    ASSERT_ALLOC (new_table, err_table_realloc);
+    memset (new_table + self->table_size, 0,
+            (new_size - self->table_size) * sizeof (*self->table));
+
+    self->table = new_table;
+    self->table_size = new_size;
+    return DISP_TABLE_SUCCESS;
+
+err_table_realloc:
+err_key_oor:
+    return DISP_TABLE_ERR_ALLOC;
 }
 
 static disp_table_err_e _disp_table_insert_all (disp_table_t *self, const disp_op_t **disp_ops)
@@ -275,9 +345,6 @@ err_disp_insert:
 
 static disp_table_err_e _disp_table_remove (disp_table_t *self, uint32_t key)
 {
-    char *key_c = hutils_stringify_hex_key (key);
-    ASSERT_ALLOC (key_c, err_key_c_alloc);
-
     /* Do a lookup first to free the return value */
     disp_op_handler_t *disp_op_handler = _disp_table_lookup (self, key);
     ASSERT_TEST (disp_op_handler != NULL, "Could not find registered key",
@@ -290,15 +357,11 @@ static disp_table_err_e _disp_table_remove (disp_table_t *self, uint32_t key)
     DBE_DEBUG (DBG_HAL_UTILS | DBG_LVL_TRACE,
         "[disp_table] Removing function (key = %u) into dispatch table\n",
         key);
-    /* This will trigger the free function previously registered */
-    zhashx_delete (self->table_h, key_c);
+    disp_op_handler_destroy (&self->table [key]);
 
-    free (key_c);
     return DISP_TABLE_SUCCESS;
 
 err_disp_op_handler_null:
-    free (key_c);
-err_key_c_alloc:
     return DISP_TABLE_ERR_ALLOC;
 }
 
@@ -306,14 +369,13 @@ static disp_table_err_e _disp_table_remove_all (disp_table_t *self)
 {
     assert (self);
 
-    zlistx_t *hash_keys = zhashx_keys (self->table_h);
-    void * table_item = zlistx_first (hash_keys);
-
-    for ( ; table_item; table_item = zlistx_next (hash_keys)) {
-        _disp_table_remove (self, hutils_numerify_hex_key ((char *) table_item));
+    uint32_t key;
+    for (key = 0; key < self->table_size; ++key) {
+        if (self->table [key] != NULL) {
+            _disp_table_remove (self, key);
+        }
     }
 
-    zlistx_destroy (&hash_keys);
     return DISP_TABLE_SUCCESS;
 }
 
@@ -419,6 +481,8 @@ disp_op_handler_t *disp_op_handler_new ()
     ASSERT_ALLOC (self, err_disp_op_handler_alloc);
 
     self->ret = NULL;
+    self->ret_spare = NULL;
+    self->refs = 1;
 
     return self;
 
@@ -433,27 +497,44 @@ disp_table_err_e disp_op_handler_destroy (disp_op_handler_t **self_p)
     if (*self_p) {
         disp_op_handler_t *self = *self_p;
 
-        free (self);
+        /* Lent buffers might still be around */
+        if (__atomic_sub_fetch (&self->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+            free (self->ret_spare);
+            free (self);
+        }
         *self_p = NULL;
     }
 
     return DISP_TABLE_SUCCESS;
 }
 
+void disp_op_handler_release_ret (void *data, void *hint)
+{
+    disp_op_handler_t *self = (disp_op_handler_t *) hint;
+    assert (self);
+
+    /* Keep the buffer for the next lend, unless there is one already */
+    void *expected = NULL;
+    if (!__atomic_compare_exchange_n (&self->ret_spare, &expected, data, false,
+                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        free (data);
+    }
+
+    disp_op_handler_destroy (&self);
+}
+
 static disp_op_handler_t *_disp_table_lookup (disp_table_t *self, uint32_t key)
 {
     disp_op_handler_t *disp_op_handler = NULL;
 
-    char *key_c = hutils_stringify_hex_key (key);
-    ASSERT_ALLOC (key_c, err_key_c_alloc);
-
-    disp_op_handler = zhashx_lookup (self->table_h, key_c);
+    /* This runs for every request, so no allocations here */
+    if (key < self->table_size) {
+        disp_op_handler = self->table [key];
+    }
     ASSERT_TEST (disp_op_handler != NULL, "Could not find registered function",
             err_func_p_wrapper_null);
 
 err_func_p_wrapper_null:
-    free (key_c);
-err_key_c_alloc:
     return disp_op_handler;
 }
 
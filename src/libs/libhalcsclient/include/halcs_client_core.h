@@ -13,6 +13,8 @@ extern "C" {
 #endif
 
 struct _smio_rffe_data_block_t;
+struct _smio_fmc130m_4ch_dly_cal_t;
+struct _smio_dsp_monit_t;
 struct _smio_rffe_version_t;
 struct _smio_afc_diag_revision_data_t;
 
@@ -57,7 +59,10 @@ void halcs_client_destroy (halcs_client_t **self_p);
 halcs_client_err_e halcs_func_exec (halcs_client_t *self, const disp_op_t *func,
         char *service, uint32_t *input, uint32_t *output);
 
-/* Translate function's name and returns its structure */
+/* Translate function's name and returns its structure, or NULL if there is
+ * no such function. The returned structure is valid for the lifetime of the
+ * process, so callers issuing the same function repeatedly should translate
+ * it once and reuse it with halcs_func_exec () or func_polling_exec () */
 const disp_op_t* halcs_func_translate (char *name);
 
 /* Wrapper to halcs_func_exec which translates the function name to
@@ -79,6 +84,17 @@ halcs_client_err_e halcs_client_set_timeout (halcs_client_t *self, int timeout);
 /* Get the timeout parameter */
 uint32_t halcs_client_get_timeout (halcs_client_t *self);
 
+/* Set the number of data block requests halcs_acq_get_curve () keeps in
+ * flight, from 1 (wait for each block before requesting the next one) to 64.
+ * This is also the number of blocks halcs_acq_get_curve_stream () lets the
+ * server push ahead.
+ * Larger windows hide the network and broker latency, at the expense of
+ * buffering up to acq_window blocks in the connection */
+halcs_client_err_e halcs_client_set_acq_window (halcs_client_t *self, uint32_t acq_window);
+
+/* Get the number of data block requests kept in flight */
+uint32_t halcs_client_get_acq_window (halcs_client_t *self);
+
 /******************** FMC130M SMIO Functions ******************/
 
 /* Blink the FMC Leds. This is only used for debug and for demostration
@@ -277,6 +293,20 @@ halcs_client_err_e halcs_set_adc_dly2 (halcs_client_t *self, char *service,
 halcs_client_err_e halcs_set_adc_dly3 (halcs_client_t *self, char *service,
         uint32_t dly_type3, uint32_t dly_val3);
 
+/* ADC delay calibration. Sweeps all delay taps of the lines selected by
+ * dly_type (see DLY_TYPE_*) for all channels, capturing num_samples samples
+ * at each tap. Taps whose samples have a peak-to-peak value up to max_spread
+ * are considered good, and each channel is left at the center of its widest
+ * run of good taps. The ADC inputs must be held at a steady level during the
+ * calibration. num_samples is at most 1024. The eye map and the chosen taps
+ * are returned in dly_cal. The sweep waits for up to 10 s, or the client
+ * timeout if it is longer.
+ * Returns HALCS_CLIENT_SUCCESS if ok or error otherwise (see
+ * halcs_client_err.h for all possible errors) */
+halcs_client_err_e halcs_adc_dly_cal (halcs_client_t *self, char *service,
+        uint32_t dly_type, uint32_t num_samples, uint32_t max_spread,
+        struct _smio_fmc130m_4ch_dly_cal_t *dly_cal);
+
 /* FMC TEST data enable. Sets or clears the ADC test data switch. This
  * enables or disables the ADC test RAMP output.
  * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIIENT_ERR_SERVER if
@@ -376,6 +406,15 @@ halcs_client_err_e halcs_get_si571_freq (halcs_client_t *self, char *service,
 halcs_client_err_e halcs_set_si571_defaults (halcs_client_t *self, char *service,
         double si571_defaults);
 
+/* Read the AD9510 and SI571 register shadows back from the chips. Use after
+ * the FMC board was reset or reprogrammed behind the server's back.
+ * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIIENT_ERR_SERVER if
+ * if server could not complete the request */
+halcs_client_err_e halcs_set_ad9510_resync (halcs_client_t *self, char *service,
+        uint32_t ad9510_resync);
+halcs_client_err_e halcs_set_si571_resync (halcs_client_t *self, char *service,
+        double si571_resync);
+
 /******************** FMC250M SMIO Functions ******************/
 
 /* ADC ISLA216P Control */
@@ -406,6 +445,19 @@ halcs_client_err_e halcs_set_test_mode2 (halcs_client_t *self, char *service,
 halcs_client_err_e halcs_set_test_mode3 (halcs_client_t *self, char *service,
         uint32_t test_mode3);
 
+/* Read the register shadow of ISLA216P ADC 0 to 3 back from the chip. Use
+ * after the ADC was reset or reprogrammed behind the server's back.
+ * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIIENT_ERR_SERVER if
+ * if server could not complete the request */
+halcs_client_err_e halcs_set_isla216p_resync0 (halcs_client_t *self, char *service,
+        uint32_t isla216p_resync0);
+halcs_client_err_e halcs_set_isla216p_resync1 (halcs_client_t *self, char *service,
+        uint32_t isla216p_resync1);
+halcs_client_err_e halcs_set_isla216p_resync2 (halcs_client_t *self, char *service,
+        uint32_t isla216p_resync2);
+halcs_client_err_e halcs_set_isla216p_resync3 (halcs_client_t *self, char *service,
+        uint32_t isla216p_resync3);
+
 /********************** ACQ SMIO Functions ********************/
 
 /* Acquisition request */
@@ -431,12 +483,28 @@ typedef struct {
     acq_block_t block;                          /* Block or whole curve read */
 } acq_trans_t;
 
+/* Server-side reduction of an acquisition curve */
+typedef struct {
+    uint32_t first_sample;                      /* First sample of the range */
+    uint32_t num_samples;                       /* Number of samples of the range.
+                                                   0 means up to the end */
+    uint32_t decim;                             /* Decimation factor */
+    uint32_t reduction;                         /* ACQ_REDUCE_* */
+} acq_reduce_t;
+
 /* Acquisition channel definitions */
 typedef struct {
     uint32_t chan;
     uint32_t sample_size;
 } acq_chan_t;
 
+/* Acquisition done event */
+typedef struct {
+    uint32_t chan;                              /* Acquisition channel number */
+    uint32_t trig_addr;                         /* Trigger address */
+    uint64_t timestamp;                         /* Completion time, in ms since epoch */
+} acq_done_evt_t;
+
 /* Acquisition channel definitions */
 extern acq_chan_t acq_chan[END_CHAN_ID];
 
@@ -447,6 +515,20 @@ extern acq_chan_t acq_chan[END_CHAN_ID];
 halcs_client_err_e halcs_acq_start (halcs_client_t *self, char *service,
         acq_req_t *acq_req);
 
+/* Start acquisitions on all of the channels set in chan_mask (see
+ * ACQ_CHAN_MASK ()), with the number of samples and shots in acq_req.
+ * acq_req->chan is ignored. The server acquires the channels back-to-back,
+ * from the lowest to the highest, and publishes an acquisition done event
+ * for each one (see halcs_acq_wait_done ()). halcs_acq_check () only reports
+ * completion after the last channel. The channels are not acquired at the
+ * same time, so the trigger must be either skip or software. With the
+ * software trigger, only the first channel must be triggered by the client;
+ * the server triggers each of the others as soon as it is started.
+ * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIIENT_ERR_SERVER if the server
+ * could not complete the request, including any other trigger type */
+halcs_client_err_e halcs_acq_start_multi (halcs_client_t *self, char *service,
+        acq_req_t *acq_req, uint32_t chan_mask);
+
 /* Check if apreviouly started acquisition finished.
  * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIIENT_ERR_AGAIN if the acquistion
  * did not complete */
@@ -459,6 +541,23 @@ halcs_client_err_e halcs_acq_check (halcs_client_t *self, char *service);
 halcs_client_err_e halcs_acq_check_timed (halcs_client_t *self, char *service,
         int timeout);
 
+/* Subscribe to the acquisition done events published by the server. This must
+ * be done before starting the acquisition, otherwise its event might be lost.
+ * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIENT_ERR_SERVER if the
+ * subscription could not be made */
+halcs_client_err_e halcs_acq_subscribe_done (halcs_client_t *self, char *service);
+
+/* Wait for the acquisition done event of a previously started acquisition,
+ * with a maximum tolerated wait in ms (timeout < 0 means "infinite" wait).
+ * Only events of the channels set in chan_mask (see ACQ_CHAN_MASK ()) are
+ * accepted, the others are discarded. A chan_mask of 0 accepts any channel.
+ * halcs_acq_subscribe_done () must have been called before starting the acquisition.
+ * Returns HALCS_CLIENT_SUCCESS if the acquistion finished under the specified
+ * timeout or HALCS_CLIIENT_ERR_TIMEOUT if the acquistion did not completed in time.
+ * The event contents are returned in acq_done_evt, if not NULL */
+halcs_client_err_e halcs_acq_wait_done (halcs_client_t *self, char *service,
+        uint32_t chan_mask, acq_done_evt_t *acq_done_evt, int timeout);
+
 /* Get an specific data block from a previously completed acquisiton by setting
  * the desired block index in acq_trans->block.idx and the desired channel in
  * acq_trans->req.channel.
@@ -472,10 +571,64 @@ halcs_client_err_e halcs_acq_get_data_block (halcs_client_t *self, char *service
  * the desired channel in acq_trans->req.channel.
  * Returns HALCS_CLIENT_SUCCESS if the block was read or HALCS_CLIENT_ERR_SERVER
  * otherwise. The data read is returned in acq_trans->block.data along with
- * the number of bytes effectively read in acq_trans->block.bytes_read */
+ * the number of bytes effectively read in acq_trans->block.bytes_read.
+ * Up to halcs_client_get_acq_window () block requests are kept in flight */
 halcs_client_err_e halcs_acq_get_curve (halcs_client_t *self, char *service,
         acq_trans_t *acq_trans);
 
+/* Same as halcs_acq_get_curve, but num_samples samples starting at
+ * first_sample of the acquisition described in acq_trans->req are requested
+ * at once and the server pushes their blocks back, instead of having one
+ * request per block. A num_samples of 0, or one past the end of the
+ * acquisition, reads up to its end. The server never has more than
+ * halcs_client_get_acq_window () blocks in flight, and is granted more as
+ * they are received, without waiting for them.
+ * Returns HALCS_CLIENT_SUCCESS if the range was read,
+ * HALCS_CLIENT_ERR_INV_PARAM if it does not fit in acq_trans->block.data,
+ * HALCS_CLIENT_ERR_MSG if the stream was truncated or HALCS_CLIENT_ERR_SERVER
+ * otherwise. The data read is returned in acq_trans->block.data along with
+ * the number of bytes effectively read in acq_trans->block.bytes_read */
+halcs_client_err_e halcs_acq_get_curve_stream (halcs_client_t *self, char *service,
+        acq_trans_t *acq_trans, uint32_t first_sample, uint32_t num_samples);
+
+/* Get a decimated version of a curve of a previously completed acquisition,
+ * reduced inside the server, by setting the desired channel in
+ * acq_trans->req.channel and the sample range, decimation factor and
+ * reduction in acq_reduce. Each bucket of decim samples is reduced to one
+ * sample (two for ACQ_REDUCE_MINMAX, minimum then maximum), in the channel
+ * sample format. The server reduces a bounded part of the range per request,
+ * so long ranges take several requests, each within the client timeout.
+ * Returns HALCS_CLIENT_SUCCESS if the curve was read,
+ * HALCS_CLIENT_ERR_INV_PARAM if it does not fit in acq_trans->block.data or
+ * HALCS_CLIENT_ERR_SERVER otherwise. The data read is returned in acq_trans->block.data along with
+ * the number of bytes effectively read in acq_trans->block.bytes_read */
+halcs_client_err_e halcs_acq_get_curve_reduced (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, acq_reduce_t *acq_reduce);
+
+/* Get num_samples samples of a previously completed acquisition, starting at
+ * first_sample, by setting the desired channel in acq_trans->req.channel.
+ * Only the requested range is transferred, with up to
+ * halcs_client_get_acq_window () requests in flight. The range is clamped
+ * to the end of the acquisition described in acq_trans->req.
+ * Returns HALCS_CLIENT_SUCCESS if the samples were read,
+ * HALCS_CLIENT_ERR_INV_PARAM if first_sample is past the end of the
+ * acquisition or HALCS_CLIENT_ERR_SERVER otherwise. The data read is returned in
+ * acq_trans->block.data along with the number of bytes effectively read in
+ * acq_trans->block.bytes_read */
+halcs_client_err_e halcs_acq_get_samples (halcs_client_t *self, char *service,
+        acq_trans_t *acq_trans, uint32_t first_sample, uint32_t num_samples);
+
+/* Get a single shot of a previously completed multishot acquisition, by
+ * setting the desired channel in acq_trans->req.channel. Shots have the
+ * number of samples actually programmed into the hardware, which may be
+ * larger than the one requested due to alignment. The shot must fit in a
+ * single block, so use halcs_acq_get_samples () for longer ones.
+ * Returns HALCS_CLIENT_SUCCESS if the shot was read or HALCS_CLIENT_ERR_SERVER
+ * otherwise. The data read is returned in acq_trans->block.data along with
+ * the number of bytes effectively read in acq_trans->block.bytes_read */
+halcs_client_err_e halcs_acq_get_shot (halcs_client_t *self, char *service,
+        acq_trans_t *acq_trans, uint32_t shot);
+
 /* Perform a full acquisition process (Acquisition request, checking if
  * its done and receiving the full curve).
  * Returns HALCS_CLIENT_SUCCESS if the curve was read or HALCS_CLIENT_ERR_SERVER
@@ -505,6 +658,18 @@ halcs_client_err_e halcs_set_acq_trig (halcs_client_t *self, char *service,
 halcs_client_err_e halcs_get_acq_trig (halcs_client_t *self, char *service,
         uint32_t *trig);
 
+/* Configure the memory budget, in MiB, of the server curve cache. The last
+ * curve of each channel is kept in the server memory as it is read, so other
+ * readers of the same acquisition don't go to the acquisition memory again.
+ * Curves read by halcs_acq_get_curve_stream () and halcs_acq_get_curve_reduced ()
+ * are cached as well. Defaults to 32 MiB; 0 disables the cache.
+ * Returns HALCS_CLIENT_SUCCESS if the budget was correctly set or
+ * or an error (see halcs_client_err.h for all possible errors)*/
+halcs_client_err_e halcs_set_acq_cache_size (halcs_client_t *self, char *service,
+        uint32_t cache_size);
+halcs_client_err_e halcs_get_acq_cache_size (halcs_client_t *self, char *service,
+        uint32_t *cache_size);
+
 /* Configure data-driven trigger polarity. Options are: 0 -> positive slope (
  * 0 -> 1), 1 -> negative slope (1 -> 0).
  * Returns HALCS_CLIENT_SUCCESS if the trigger was correctly set or
@@ -678,6 +843,67 @@ halcs_client_err_e halcs_set_monit_updt (halcs_client_t *self, char *service,
 halcs_client_err_e halcs_get_monit_updt (halcs_client_t *self, char *service,
         uint32_t *monit_updt);
 
+/* Monitoring AMP/POS snapshot. Updates the AMP/POS values in the FPGA and
+ * reads all of them back in a single request, so they are guaranteed to come
+ * from the same update. monit->updt is incremented by the server on each
+ * update, so skipped or repeated snapshots can be detected.
+ * Returns HALCS_CLIENT_SUCCESS if ok or error otherwise (see
+ * halcs_client_err.h for all possible errors) */
+halcs_client_err_e halcs_get_monit_amp_pos (halcs_client_t *self, char *service,
+        struct _smio_dsp_monit_t *monit);
+
+/* These set of functions write (set) or read (get) the monitoring stream
+ * subscriptions. Writing 1 adds a subscriber and writing 0 removes one, while
+ * reading returns the number of subscribers. While there is at least one, the
+ * server latches the AMP/POS values every 10 ms and
+ * publishes them to the clients of halcs_subscribe_monit_amp_pos (). Prefer
+ * halcs_subscribe_monit_amp_pos () and halcs_unsubscribe_monit_amp_pos (),
+ * which keep the subscriptions balanced.
+ * All of the functions returns HALCS_CLIENT_SUCCESS if the
+ * parameter was correctly set or error (see halcs_client_err.h
+ * for all possible errors)*/
+halcs_client_err_e halcs_set_monit_stream (halcs_client_t *self, char *service,
+        uint32_t monit_stream);
+halcs_client_err_e halcs_get_monit_stream (halcs_client_t *self, char *service,
+        uint32_t *monit_stream);
+
+/* Subscribe to the monitoring samples published by the server (see
+ * halcs_set_monit_stream ()). The server latches and publishes a sample every
+ * 10 ms, so no client needs to poll with
+ * halcs_get_monit_amp_pos (). Updates latched by other clients in between are
+ * not published by themselves. Subscribing twice to the same service has no
+ * effect.
+ * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIENT_ERR_SERVER if the
+ * subscription could not be made */
+halcs_client_err_e halcs_subscribe_monit_amp_pos (halcs_client_t *self, char *service);
+
+/* Unsubscribe from the monitoring samples of service. The server stops
+ * streaming once its last subscriber is gone. Subscriptions still held are
+ * dropped by halcs_client_destroy (). Samples already queued, or published
+ * for other subscribers, may still be received by halcs_wait_monit_amp_pos ().
+ * Returns HALCS_CLIENT_SUCCESS if ok, HALCS_CLIENT_ERR_INV_PARAM if not
+ * subscribed to service or HALCS_CLIENT_ERR_SERVER if the server could not
+ * be reached */
+halcs_client_err_e halcs_unsubscribe_monit_amp_pos (halcs_client_t *self, char *service);
+
+/* Wait for the next monitoring sample, with a maximum tolerated wait in ms
+ * (timeout < 0 means "infinite" wait). halcs_subscribe_monit_amp_pos () must
+ * have been called before. Samples are queued between calls, so none is lost
+ * unless the client falls too far behind. The sample is returned in monit and
+ * its host timestamp, in ms since epoch, in timestamp, if not NULL.
+ * Returns HALCS_CLIENT_SUCCESS if a sample was received under the specified
+ * timeout or HALCS_CLIIENT_ERR_TIMEOUT if not */
+halcs_client_err_e halcs_wait_monit_amp_pos (halcs_client_t *self, char *service,
+        struct _smio_dsp_monit_t *monit, uint64_t *timestamp, int timeout);
+
+/* Resync the DSP register shadow kept by the server, so the registers are
+ * read back from the FPGA. Use after the FPGA was reprogrammed or written
+ * behind the server's back. The value written is ignored.
+ * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIIENT_ERR_SERVER if
+ * if server could not complete the request */
+halcs_client_err_e halcs_set_dsp_shadow_resync (halcs_client_t *self, char *service,
+        uint32_t dsp_shadow_resync);
+
 /********************** SWAP Functions ********************/
 
 /* Switching functions */
@@ -763,6 +989,14 @@ halcs_client_err_e halcs_set_gain_d (halcs_client_t *self, char *service,
 halcs_client_err_e halcs_get_gain_d (halcs_client_t *self, char *service,
         uint32_t *gain_dir, uint32_t *gain_inv);
 
+/* Resync the SWAP register shadow kept by the server, so the registers are
+ * read back from the FPGA. Use after the FPGA was reprogrammed or written
+ * behind the server's back. The value written is ignored.
+ * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIIENT_ERR_SERVER if
+ * if server could not complete the request */
+halcs_client_err_e halcs_set_swap_shadow_resync (halcs_client_t *self, char *service,
+        uint32_t swap_shadow_resync);
+
 /********************** RFFE Functions ********************/
 
 /* Attenuator functions */
@@ -981,6 +1215,14 @@ halcs_client_err_e halcs_set_trigger_count_transm (halcs_client_t *self, char *s
 halcs_client_err_e halcs_get_trigger_count_transm (halcs_client_t *self, char *service,
         uint32_t chan, uint32_t *count_transm);
 
+/* Resync the trigger interface register shadow kept by the server, so the registers are
+ * read back from the FPGA. Use after the FPGA was reprogrammed or written
+ * behind the server's back. The value written is ignored.
+ * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIIENT_ERR_SERVER if
+ * if server could not complete the request */
+halcs_client_err_e halcs_set_trigger_iface_shadow_resync (halcs_client_t *self, char *service,
+        uint32_t trigger_iface_shadow_resync);
+
 /**************************** Trigger Mux Functions ***************************/
 
 /* Trigger Receive Source functions */
@@ -1023,6 +1265,14 @@ halcs_client_err_e halcs_set_trigger_transm_out_sel (halcs_client_t *self, char
 halcs_client_err_e halcs_get_trigger_transm_out_sel (halcs_client_t *self, char *service,
         uint32_t chan, uint32_t *transm_out_sel);
 
+/* Resync the trigger mux register shadow kept by the server, so the registers are
+ * read back from the FPGA. Use after the FPGA was reprogrammed or written
+ * behind the server's back. The value written is ignored.
+ * Returns HALCS_CLIENT_SUCCESS if ok and HALCS_CLIIENT_ERR_SERVER if
+ * if server could not complete the request */
+halcs_client_err_e halcs_set_trigger_mux_shadow_resync (halcs_client_t *self, char *service,
+        uint32_t trigger_mux_shadow_resync);
+
 /****************************** Helper Functions ****************************/
 /* Helper Function */
 
@@ -1034,6 +1284,11 @@ halcs_client_err_e halcs_get_trigger_transm_out_sel (halcs_client_t *self, char
 halcs_client_err_e func_polling (halcs_client_t *self, char *name,
         char *service, uint32_t *input, uint32_t *output, int timeout);
 
+/* Same as func_polling (), but with the function already translated
+ * by halcs_func_translate () */
+halcs_client_err_e func_polling_exec (halcs_client_t *self, const disp_op_t *func,
+        char *service, uint32_t *input, uint32_t *output, int timeout);
+
 #ifdef __cplusplus
 }
 #endif
@@ -39,6 +39,13 @@
 #define HALCSCLIENT_DFLT_LOG_MODE             "w"
 #define HALCSCLIENT_MLM_CONNECT_TIMEOUT       1000        /* in ms */
 #define HALCSCLIENT_DFLT_TIMEOUT              1000        /* in ms */
+/* The ADC delay calibration sweep runs for longer than a regular
+ * operation, so it gets its own timeout */
+#define HALCSCLIENT_ADC_DLY_CAL_TIMEOUT       10000       /* in ms */
+#define HALCSCLIENT_DFLT_ACQ_WINDOW           4           /* in blocks */
+#define HALCSCLIENT_MAX_ACQ_WINDOW            64          /* in blocks */
+/* Subject of data block requests: "<curve ID>/<block index>" */
+#define HALCSCLIENT_ACQ_BLOCK_SUBJ_SIZE       32
 
 /* Our structure */
 struct _halcs_client_t {
@@ -47,12 +54,36 @@ struct _halcs_client_t {
     int timeout;                                /* Timeout in msec for send/recv */
     zpoller_t *poller;                          /* Poller for receiving messages */
     const acq_chan_t *acq_chan;                 /* Acquisition buffer table */
+    char *broker_endp;                          /* Broker endpoint */
+    mlm_client_t *mlm_client_evt;               /* Malamute client instance for
+                                                   receiving events. Created on
+                                                   the first subscription */
+    zpoller_t *poller_evt;                      /* Poller for receiving events */
+    zlist_t *subscriptions;                     /* Subscribed "stream/pattern" pairs */
+    zlist_t *monit_streams;                     /* Services whose monitoring stream
+                                                   we are subscribed to */
+    uint32_t acq_window;                        /* Number of data block requests
+                                                   in flight when reading a curve */
+    uint32_t acq_curve_id;                      /* Tags the data block requests of
+                                                   each curve read */
 };
 
 static halcs_client_t *_halcs_client_new (char *broker_endp, int verbose,
         const char *log_file_name, const char *log_mode, int timeout);
-static halcs_client_err_e _func_polling (halcs_client_t *self, char *name,
+static halcs_client_err_e _func_polling (halcs_client_t *self, const disp_op_t *func,
         char *service, uint32_t *input, uint32_t *output, int timeout);
+static zhashx_t *_halcs_func_table_get (void);
+static halcs_client_err_e _halcs_client_evt_new (halcs_client_t *self);
+static halcs_client_err_e _halcs_client_subscribe (halcs_client_t *self,
+        char *stream, char *pattern);
+static void _halcs_client_flush_events (halcs_client_t *self);
+static zmsg_t *_halcs_client_recv_event (halcs_client_t *self, char *stream,
+        char *subject, int timeout);
+
+/* Function name to disp_op_t table. Built on the first translation and
+ * read-only afterwards, so it can be shared among all clients and threads
+ * without locking */
+static zhashx_t *halcs_func_table = NULL;
 
 /* Acquisition channel definitions for user's application */
 #if defined(__BOARD_ML605__)
@@ -129,9 +160,19 @@ void halcs_client_destroy (halcs_client_t **self_p)
         halcs_client_t *self = *self_p;
 
         self->acq_chan = NULL;
+        /* Let the servers stop streaming if we were their last subscriber */
+        while (self->monit_streams != NULL && zlist_size (self->monit_streams) > 0) {
+            char *service = (char *) zlist_first (self->monit_streams);
+            halcs_unsubscribe_monit_amp_pos (self, service);
+        }
+        zlist_destroy (&self->monit_streams);
+        zlist_destroy (&self->subscriptions);
+        zpoller_destroy (&self->poller_evt);
+        mlm_client_destroy (&self->mlm_client_evt);
         zpoller_destroy (&self->poller);
         mlm_client_destroy (&self->mlm_client);
         zuuid_destroy (&self->uuid);
+        free (self->broker_endp);
         free (self);
         *self_p = NULL;
     }
@@ -156,6 +197,24 @@ uint32_t halcs_client_get_timeout (halcs_client_t *self)
     return self->timeout;
 }
 
+halcs_client_err_e halcs_client_set_acq_window (halcs_client_t *self, uint32_t acq_window)
+{
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+    ASSERT_TEST(acq_window > 0 && acq_window <= HALCSCLIENT_MAX_ACQ_WINDOW,
+            "Acquisition window is out of range", err_inv_param,
+            HALCS_CLIENT_ERR_INV_PARAM);
+
+    self->acq_window = acq_window;
+
+err_inv_param:
+    return err;
+}
+
+uint32_t halcs_client_get_acq_window (halcs_client_t *self)
+{
+    return self->acq_window;
+}
+
 /**************** Static LIB Client Functions ****************/
 static halcs_client_t *_halcs_client_new (char *broker_endp, int verbose,
         const char *log_file_name, const char *log_mode, int timeout)
@@ -182,6 +241,10 @@ static halcs_client_t *_halcs_client_new (char *broker_endp, int verbose,
     halcs_client_t *self = zmalloc (sizeof *self);
     ASSERT_ALLOC(self, err_self_alloc);
 
+    /* Save broker endpoint for the event connection, if ever needed */
+    self->broker_endp = strdup (broker_endp);
+    ASSERT_ALLOC(self->broker_endp, err_broker_endp_alloc);
+
     /* Generate UUID to work with MLM broker */
     self->uuid = zuuid_new ();
     ASSERT_ALLOC(self->uuid, err_uuid_alloc);
@@ -208,9 +271,17 @@ static halcs_client_t *_halcs_client_new (char *broker_endp, int verbose,
     self->acq_chan = acq_chan;
     /* Initialize timeout */
     self->timeout = timeout;
+    /* Initialize number of data block requests in flight */
+    self->acq_window = HALCSCLIENT_DFLT_ACQ_WINDOW;
+    self->acq_curve_id = 0;
+    /* Initialize monitoring stream subscriptions */
+    self->monit_streams = zlist_new ();
+    ASSERT_ALLOC(self->monit_streams, err_monit_streams_alloc);
 
     return self;
 
+err_monit_streams_alloc:
+    zpoller_destroy (&self->poller);
 err_init_poller:
 err_mlm_inv_client_socket:
 err_mlm_connect:
@@ -218,11 +289,172 @@ err_mlm_connect:
 err_mlm_client:
     zuuid_destroy (&self->uuid);
 err_uuid_alloc:
+    free (self->broker_endp);
+err_broker_endp_alloc:
     free (self);
 err_self_alloc:
     return NULL;
 }
 
+/* Events are received on a separate connection, so they never get mixed
+ * with the replies to our requests */
+static halcs_client_err_e _halcs_client_evt_new (halcs_client_t *self)
+{
+    assert (self);
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+
+    self->mlm_client_evt = mlm_client_new ();
+    ASSERT_TEST(self->mlm_client_evt != NULL, "Could not create MLM event client",
+            err_mlm_client, HALCS_CLIENT_ERR_ALLOC);
+
+    char *evt_address = hutils_concat_strings (zuuid_str_canonical (self->uuid),
+            "EVT", ':');
+    ASSERT_ALLOC(evt_address, err_evt_address_alloc, HALCS_CLIENT_ERR_ALLOC);
+
+    int rc = mlm_client_connect (self->mlm_client_evt, self->broker_endp,
+            HALCSCLIENT_MLM_CONNECT_TIMEOUT, evt_address);
+    ASSERT_TEST(rc >= 0, "Could not connect MLM event client to broker",
+            err_mlm_connect, HALCS_CLIENT_ERR_SERVER);
+
+    zsock_t *msgpipe = mlm_client_msgpipe (self->mlm_client_evt);
+    ASSERT_TEST (msgpipe != NULL, "Invalid MLM event client socket reference",
+            err_mlm_inv_client_socket, HALCS_CLIENT_ERR_SERVER);
+    self->poller_evt = zpoller_new (msgpipe, NULL);
+    ASSERT_TEST (self->poller_evt != NULL, "Could not Initialize event poller",
+            err_init_poller, HALCS_CLIENT_ERR_ALLOC);
+
+    self->subscriptions = zlist_new ();
+    ASSERT_ALLOC(self->subscriptions, err_subscriptions_alloc, HALCS_CLIENT_ERR_ALLOC);
+    zlist_autofree (self->subscriptions);
+
+    free (evt_address);
+    return err;
+
+err_subscriptions_alloc:
+    zpoller_destroy (&self->poller_evt);
+err_init_poller:
+err_mlm_inv_client_socket:
+err_mlm_connect:
+    free (evt_address);
+err_evt_address_alloc:
+    mlm_client_destroy (&self->mlm_client_evt);
+err_mlm_client:
+    return err;
+}
+
+static halcs_client_err_e _halcs_client_subscribe (halcs_client_t *self,
+        char *stream, char *pattern)
+{
+    assert (self);
+    assert (stream);
+    assert (pattern);
+
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+
+    if (self->mlm_client_evt == NULL) {
+        err = _halcs_client_evt_new (self);
+        ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "Could not create event client",
+                err_evt_new);
+    }
+
+    char *sub_key = hutils_concat_strings (stream, pattern, '/');
+    ASSERT_ALLOC(sub_key, err_sub_key_alloc, HALCS_CLIENT_ERR_ALLOC);
+
+    /* Subscribing twice would get us every event twice */
+    for (char *sub = (char *) zlist_first (self->subscriptions); sub != NULL;
+            sub = (char *) zlist_next (self->subscriptions)) {
+        if (streq (sub, sub_key)) {
+            goto already_subscribed;
+        }
+    }
+
+    int rc = mlm_client_set_consumer (self->mlm_client_evt, stream, pattern);
+    ASSERT_TEST(rc >= 0, "Could not subscribe to stream", err_set_consumer,
+            HALCS_CLIENT_ERR_SERVER);
+    zlist_append (self->subscriptions, sub_key);
+
+    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] subscribe: "
+            "Subscribed to stream %s, pattern %s\n", stream, pattern);
+
+err_set_consumer:
+already_subscribed:
+    free (sub_key);
+err_sub_key_alloc:
+err_evt_new:
+    return err;
+}
+
+/* Discard all events received so far */
+static void _halcs_client_flush_events (halcs_client_t *self)
+{
+    assert (self);
+
+    if (self->mlm_client_evt == NULL) {
+        return;
+    }
+
+    zsock_t *msgpipe = mlm_client_msgpipe (self->mlm_client_evt);
+    while (zsock_events (msgpipe) & ZMQ_POLLIN) {
+        zmsg_t *msg = mlm_client_recv (self->mlm_client_evt);
+        if (msg == NULL) {
+            break; /* Interrupted */
+        }
+        zmsg_destroy (&msg);
+    }
+}
+
+/* Wait for an event published on "stream" with "subject". Other events
+ * are discarded. timeout < 0 means "infinite" wait */
+static zmsg_t *_halcs_client_recv_event (halcs_client_t *self, char *stream,
+        char *subject, int timeout)
+{
+    assert (self);
+    assert (stream);
+    assert (subject);
+
+    zmsg_t *msg = NULL;
+    ASSERT_TEST(self->mlm_client_evt != NULL, "Event client was not created. "
+            "Subscribe to an event first", err_no_evt_client);
+
+    int64_t deadline = zclock_mono () + timeout;
+    while (!zsys_interrupted) {
+        int wait_time = -1;
+        if (timeout >= 0) {
+            int64_t time_left = deadline - zclock_mono ();
+            if (time_left < 0) {
+                break;
+            }
+            wait_time = (int) time_left;
+        }
+
+        zsock_t *which = zpoller_wait (self->poller_evt, wait_time);
+        if (which == NULL) {
+            /* Either expired or terminated */
+            break;
+        }
+
+        msg = mlm_client_recv (self->mlm_client_evt);
+        if (msg == NULL) {
+            break; /* Interrupted */
+        }
+
+        if (streq (mlm_client_command (self->mlm_client_evt), "STREAM DELIVER") &&
+                streq (mlm_client_address (self->mlm_client_evt), stream) &&
+                streq (mlm_client_subject (self->mlm_client_evt), subject)) {
+            return msg;
+        }
+
+        /* Not what we are waiting for */
+        zmsg_destroy (&msg);
+    }
+
+    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] recv_event: "
+            "No event %s received from %s\n", subject, stream);
+
+err_no_evt_client:
+    return NULL;
+}
+
 /**************** General Function to call the others *********/
 
 halcs_client_err_e halcs_func_exec (halcs_client_t *self, const disp_op_t *func,
@@ -322,16 +554,14 @@ const disp_op_t *halcs_func_translate (char *name)
 {
     assert (name);
 
-    /* Search the function table for a match in the 'name' field */
-    for (int i=0; smio_exp_ops[i] != NULL; i++) {
-        for (int j=0; smio_exp_ops[i][j] != NULL; j++) {
-            if (streq(name, smio_exp_ops[i][j]->name)) {
-                return smio_exp_ops[i][j];
-            }
-        }
-    }
+    zhashx_t *func_table = _halcs_func_table_get ();
+    ASSERT_TEST(func_table != NULL, "Could not get function table",
+            err_func_table);
 
-    return 0;
+    return (const disp_op_t *) zhashx_lookup (func_table, name);
+
+err_func_table:
+    return NULL;
 }
 
 halcs_client_err_e halcs_func_trans_exec (halcs_client_t *self, char *name, char *service, uint32_t *input, uint32_t *output)
@@ -603,6 +833,20 @@ PARAM_FUNC_CLIENT_WRITE_DOUBLE(si571_defaults)
             si571_defaults);
 }
 
+/* AD9510 register shadow resync */
+PARAM_FUNC_CLIENT_WRITE(ad9510_resync)
+{
+    return param_client_write (self, service, FMC_ACTIVE_CLK_OPCODE_AD9510_RESYNC,
+            ad9510_resync);
+}
+
+/* SI571 register shadow resync */
+PARAM_FUNC_CLIENT_WRITE_DOUBLE(si571_resync)
+{
+    return param_client_write_double (self, service, FMC_ACTIVE_CLK_OPCODE_SI571_RESYNC,
+            si571_resync);
+}
+
 /**************** FMC 130M SMIO Functions ****************/
 
 /* ADC LTC2208 RAND */
@@ -860,6 +1104,27 @@ PARAM_FUNC_CLIENT_WRITE2(adc_dly3, type, val)
             type, val);
 }
 
+/* ADC delay calibration sweep */
+halcs_client_err_e halcs_adc_dly_cal (halcs_client_t *self, char *service,
+        uint32_t dly_type, uint32_t num_samples, uint32_t max_spread,
+        struct _smio_fmc130m_4ch_dly_cal_t *dly_cal)
+{
+    assert (dly_cal);
+
+    uint32_t write_val[3] = {dly_type, num_samples, max_spread};
+    const disp_op_t* func = halcs_func_translate(FMC130M_4CH_NAME_ADC_DLY_CAL);
+    int timeout = self->timeout;
+
+    if (timeout >= 0 && timeout < HALCSCLIENT_ADC_DLY_CAL_TIMEOUT) {
+        self->timeout = HALCSCLIENT_ADC_DLY_CAL_TIMEOUT;
+    }
+    halcs_client_err_e err = halcs_func_exec (self, func, service, write_val,
+            (uint32_t *) dly_cal);
+    self->timeout = timeout;
+
+    return err;
+}
+
 /*************************** FMC250M Chips Functions *************************/
 
 /* ISLA216P RST ADCs */
@@ -926,19 +1191,59 @@ PARAM_FUNC_CLIENT_WRITE(test_mode3)
             test_mode3);
 }
 
+PARAM_FUNC_CLIENT_WRITE(isla216p_resync0)
+{
+    return param_client_write (self, service, FMC250M_4CH_OPCODE_ISLA216P_RESYNC0,
+            isla216p_resync0);
+}
+
+PARAM_FUNC_CLIENT_WRITE(isla216p_resync1)
+{
+    return param_client_write (self, service, FMC250M_4CH_OPCODE_ISLA216P_RESYNC1,
+            isla216p_resync1);
+}
+
+PARAM_FUNC_CLIENT_WRITE(isla216p_resync2)
+{
+    return param_client_write (self, service, FMC250M_4CH_OPCODE_ISLA216P_RESYNC2,
+            isla216p_resync2);
+}
+
+PARAM_FUNC_CLIENT_WRITE(isla216p_resync3)
+{
+    return param_client_write (self, service, FMC250M_4CH_OPCODE_ISLA216P_RESYNC3,
+            isla216p_resync3);
+}
+
 /****************** ACQ SMIO Functions ****************/
 #define MIN_WAIT_TIME           1                           /* in ms */
 #define MSECS                   1000                        /* in seconds */
 
 static halcs_client_err_e _halcs_acq_start (halcs_client_t *self, char *service,
         acq_req_t *acq_req);
+static halcs_client_err_e _halcs_acq_start_multi (halcs_client_t *self,
+        char *service, acq_req_t *acq_req, uint32_t chan_mask);
 static halcs_client_err_e _halcs_acq_check (halcs_client_t *self, char *service);
 static halcs_client_err_e _halcs_acq_check_timed (halcs_client_t *self, char *service,
         int timeout);
+static halcs_client_err_e _halcs_acq_subscribe_done (halcs_client_t *self,
+        char *service);
+static halcs_client_err_e _halcs_acq_wait_done (halcs_client_t *self, char *service,
+        uint32_t chan_mask, acq_done_evt_t *acq_done_evt, int timeout);
 static halcs_client_err_e _halcs_acq_get_data_block (halcs_client_t *self,
         char *service, acq_trans_t *acq_trans);
 static halcs_client_err_e _halcs_acq_get_curve (halcs_client_t *self, char *service,
         acq_trans_t *acq_trans);
+static halcs_client_err_e _halcs_acq_get_curve_stream (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, uint32_t first_sample,
+        uint32_t num_samples);
+static halcs_client_err_e _halcs_acq_get_curve_reduced (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, acq_reduce_t *acq_reduce);
+static halcs_client_err_e _halcs_acq_get_samples (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, uint32_t first_sample,
+        uint32_t num_samples);
+static halcs_client_err_e _halcs_acq_get_shot (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, uint32_t shot);
 static halcs_client_err_e _halcs_full_acq (halcs_client_t *self, char *service,
         acq_trans_t *acq_trans, int timeout);
 static halcs_client_err_e _halcs_full_acq_compat (halcs_client_t *self, char *service,
@@ -949,6 +1254,12 @@ halcs_client_err_e halcs_acq_start (halcs_client_t *self, char *service, acq_req
     return _halcs_acq_start (self, service, acq_req);
 }
 
+halcs_client_err_e halcs_acq_start_multi (halcs_client_t *self, char *service,
+        acq_req_t *acq_req, uint32_t chan_mask)
+{
+    return _halcs_acq_start_multi (self, service, acq_req, chan_mask);
+}
+
 halcs_client_err_e halcs_acq_check (halcs_client_t *self, char *service)
 {
     return _halcs_acq_check (self, service);
@@ -960,6 +1271,17 @@ halcs_client_err_e halcs_acq_check_timed (halcs_client_t *self, char *service,
     return _halcs_acq_check_timed (self, service, timeout);
 }
 
+halcs_client_err_e halcs_acq_subscribe_done (halcs_client_t *self, char *service)
+{
+    return _halcs_acq_subscribe_done (self, service);
+}
+
+halcs_client_err_e halcs_acq_wait_done (halcs_client_t *self, char *service,
+        uint32_t chan_mask, acq_done_evt_t *acq_done_evt, int timeout)
+{
+    return _halcs_acq_wait_done (self, service, chan_mask, acq_done_evt, timeout);
+}
+
 halcs_client_err_e halcs_acq_get_data_block (halcs_client_t *self, char *service,
         acq_trans_t *acq_trans)
 {
@@ -972,6 +1294,32 @@ halcs_client_err_e halcs_acq_get_curve (halcs_client_t *self, char *service,
     return _halcs_acq_get_curve (self, service, acq_trans);
 }
 
+halcs_client_err_e halcs_acq_get_curve_stream (halcs_client_t *self, char *service,
+        acq_trans_t *acq_trans, uint32_t first_sample, uint32_t num_samples)
+{
+    return _halcs_acq_get_curve_stream (self, service, acq_trans, first_sample,
+            num_samples);
+}
+
+halcs_client_err_e halcs_acq_get_curve_reduced (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, acq_reduce_t *acq_reduce)
+{
+    return _halcs_acq_get_curve_reduced (self, service, acq_trans, acq_reduce);
+}
+
+halcs_client_err_e halcs_acq_get_samples (halcs_client_t *self, char *service,
+        acq_trans_t *acq_trans, uint32_t first_sample, uint32_t num_samples)
+{
+    return _halcs_acq_get_samples (self, service, acq_trans, first_sample,
+            num_samples);
+}
+
+halcs_client_err_e halcs_acq_get_shot (halcs_client_t *self, char *service,
+        acq_trans_t *acq_trans, uint32_t shot)
+{
+    return _halcs_acq_get_shot (self, service, acq_trans, shot);
+}
+
 halcs_client_err_e halcs_full_acq (halcs_client_t *self, char *service,
         acq_trans_t *acq_trans, int timeout)
 {
@@ -1003,6 +1351,18 @@ halcs_client_err_e halcs_get_acq_trig (halcs_client_t *self, char *service,
     return param_client_read (self, service, ACQ_OPCODE_CFG_TRIG, trig);
 }
 
+halcs_client_err_e halcs_set_acq_cache_size (halcs_client_t *self, char *service,
+        uint32_t cache_size)
+{
+    return param_client_write (self, service, ACQ_OPCODE_CACHE_SIZE, cache_size);
+}
+
+halcs_client_err_e halcs_get_acq_cache_size (halcs_client_t *self, char *service,
+        uint32_t *cache_size)
+{
+    return param_client_read (self, service, ACQ_OPCODE_CACHE_SIZE, cache_size);
+}
+
 halcs_client_err_e halcs_set_acq_data_trig_pol (halcs_client_t *self, char *service,
         uint32_t data_trig_pol)
 {
@@ -1141,6 +1501,34 @@ err_data_acquire:
     return err;
 }
 
+static halcs_client_err_e _halcs_acq_start_multi (halcs_client_t *self,
+        char *service, acq_req_t *acq_req, uint32_t chan_mask)
+{
+    assert (self);
+    assert (service);
+    assert (acq_req);
+
+    uint32_t write_val[4] = {0};
+    write_val[0] = acq_req->num_samples_pre;
+    write_val[1] = acq_req->num_samples_post;
+    write_val[2] = acq_req->num_shots;
+    write_val[3] = chan_mask;
+
+    const disp_op_t* func = halcs_func_translate(ACQ_NAME_DATA_ACQUIRE_MULTI);
+    halcs_client_err_e err = halcs_func_exec(self, func, service, write_val, NULL);
+
+    /* Check if any error occurred */
+    ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "halcs_data_acquire_multi: Data "
+            "acquire was not requested correctly", err_data_acquire,
+            HALCS_CLIENT_ERR_AGAIN);
+
+    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_data_acquire_multi: "
+            "Data acquire of channels 0x%08x was successfully required\n", chan_mask);
+
+err_data_acquire:
+    return err;
+}
+
 static halcs_client_err_e _halcs_acq_check (halcs_client_t *self, char *service)
 {
     assert (self);
@@ -1161,56 +1549,406 @@ static halcs_client_err_e _halcs_acq_check (halcs_client_t *self, char *service)
     return err;
 }
 
-static halcs_client_err_e _halcs_acq_get_data_block (halcs_client_t *self, char *service, acq_trans_t *acq_trans)
+static halcs_client_err_e _halcs_acq_subscribe_done (halcs_client_t *self,
+        char *service)
+{
+    assert (self);
+    assert (service);
+
+    /* Events are published on a stream named after the service */
+    return _halcs_client_subscribe (self, service, ACQ_EVENT_DONE);
+}
+
+static halcs_client_err_e _halcs_acq_wait_done (halcs_client_t *self, char *service,
+        uint32_t chan_mask, acq_done_evt_t *acq_done_evt, int timeout)
 {
     assert (self);
     assert (service);
-    assert (acq_trans);
-    assert (acq_trans->block.data);
 
     halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+    zmsg_t *msg = NULL;
+    uint32_t chan = 0;
+    zframe_t *trig_addr_frm = NULL;
+    zframe_t *timestamp_frm = NULL;
+
+    /* Other clients might be acquiring other channels of the same service,
+     * so skip the events of channels we are not waiting for */
+    int64_t deadline = zclock_mono () + timeout;
+    while (true) {
+        int wait_time = -1;
+        if (timeout >= 0) {
+            int64_t time_left = deadline - zclock_mono ();
+            wait_time = (time_left < 0)? 0 : (int) time_left;
+        }
+
+        msg = _halcs_client_recv_event (self, service, ACQ_EVENT_DONE, wait_time);
+        if (msg == NULL) {
+            err = zsys_interrupted ? HALCS_CLIENT_INT : HALCS_CLIENT_ERR_TIMEOUT;
+            goto err_recv_event;
+        }
+
+        /* Message is:
+         * frame 0: channel
+         * frame 1: trigger address
+         * frame 2: timestamp */
+        ASSERT_TEST(zmsg_size (msg) == ACQ_EVENT_DONE_SIZE, "Unexpected event received",
+                err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+        zframe_t *chan_frm = zmsg_first (msg);
+        trig_addr_frm = zmsg_next (msg);
+        timestamp_frm = zmsg_next (msg);
+        ASSERT_TEST(zframe_size (chan_frm) == sizeof (uint32_t) &&
+                zframe_size (trig_addr_frm) == sizeof (uint32_t) &&
+                zframe_size (timestamp_frm) == sizeof (uint64_t),
+                "Malformed acquisition done event", err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+
+        chan = *(uint32_t *) zframe_data (chan_frm);
+        if (chan_mask == 0 || (chan < 32 && (chan_mask & ACQ_CHAN_MASK(chan)))) {
+            break;
+        }
+
+        DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_acq_wait_done: "
+                "Skipping acquisition done event of channel %u\n", chan);
+        zmsg_destroy (&msg);
+    }
 
-    uint32_t write_val[2] = {0};
-    write_val[0] = acq_trans->req.chan;
-    write_val[1] = acq_trans->block.idx;
+    if (acq_done_evt != NULL) {
+        acq_done_evt->chan = chan;
+        acq_done_evt->trig_addr = *(uint32_t *) zframe_data (trig_addr_frm);
+        acq_done_evt->timestamp = *(uint64_t *) zframe_data (timestamp_frm);
+    }
 
-    smio_acq_data_block_t read_val[1];
+    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_acq_wait_done: "
+            "Acquisition done event of channel %u received\n", chan);
+
+err_msg_fmt:
+    zmsg_destroy (&msg);
+err_recv_event:
+    return err;
+}
+
+/* Send an ACQ request with uint32_t arguments, tagging it with the current
+ * curve ID and tag. The server echoes the tag in its reply */
+static halcs_client_err_e _halcs_acq_send_tagged_req (halcs_client_t *self,
+        char *service, const disp_op_t *func, uint32_t tag, const uint32_t *args,
+        uint32_t num_args)
+{
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+    char subject [HALCSCLIENT_ACQ_BLOCK_SUBJ_SIZE];
+    snprintf (subject, sizeof (subject), "%u/%u", self->acq_curve_id, tag);
+
+    /* Sent Message is:
+     * frame 0: operation code
+     * frame 1+: arguments */
+    zmsg_t *msg = zmsg_new ();
+    ASSERT_ALLOC(msg, err_msg_alloc, HALCS_CLIENT_ERR_ALLOC);
+    zmsg_addmem (msg, &func->opcode, sizeof (func->opcode));
+    for (uint32_t i = 0; i < num_args; ++i) {
+        zmsg_addmem (msg, &args [i], sizeof (args [i]));
+    }
+
+    int rc = mlm_client_sendto (self->mlm_client, service, subject, NULL, 0, &msg);
+    ASSERT_TEST(rc == 0, "Could not send ACQ request", err_send_msg,
+            HALCS_CLIENT_ERR_SERVER);
+
+err_send_msg:
+    zmsg_destroy (&msg);
+err_msg_alloc:
+    return err;
+}
+
+/* How the blocks of a windowed ACQ read are requested. Blocks are either
+ * addressed by index (ACQ_NAME_GET_DATA_BLOCK) or by sample range
+ * (ACQ_NAME_GET_SAMPLES) */
+typedef struct {
+    const disp_op_t *func;                      /* Operation returning a block */
+    uint32_t num_blocks;                        /* Number of blocks to read */
+    uint32_t first_sample;                      /* First sample of the range */
+    uint32_t num_samples;                       /* Number of samples of the range */
+    uint32_t block_samples;                     /* Number of samples per block */
+} acq_blocks_t;
+
+/* Request a data block, tagged with the block index */
+static halcs_client_err_e _halcs_acq_send_block_req (halcs_client_t *self,
+        char *service, const acq_blocks_t *blocks, uint32_t chan,
+        uint32_t block_n)
+{
+    if (blocks->func->opcode == ACQ_OPCODE_GET_SAMPLES) {
+        /* Sent Message is:
+         * frame 0: operation code
+         * frame 1: channel
+         * frame 2: first sample
+         * frame 3: number of samples */
+        uint32_t offset = block_n*blocks->block_samples;
+        uint32_t num_samples = blocks->num_samples - offset;
+        if (num_samples > blocks->block_samples) {
+            num_samples = blocks->block_samples;
+        }
+
+        uint32_t args [3] = {chan, blocks->first_sample + offset, num_samples};
+        return _halcs_acq_send_tagged_req (self, service, blocks->func, block_n,
+                args, 3);
+    }
 
     /* Sent Message is:
      * frame 0: operation code
      * frame 1: channel
      * frame 2: block required */
+    uint32_t args [2] = {chan, block_n};
+    return _halcs_acq_send_tagged_req (self, service, blocks->func, block_n,
+            args, 2);
+}
+
+/* Receive the reply to one of the data block requests of the current curve.
+ * Replies left behind by previous curves are discarded. The block index is
+ * returned in block_n */
+static halcs_client_err_e _halcs_acq_recv_block_reply (halcs_client_t *self,
+        uint32_t *block_n, zmsg_t **report)
+{
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
 
-    const disp_op_t* func = halcs_func_translate(ACQ_NAME_GET_DATA_BLOCK);
-    err = halcs_func_exec(self, func, service, write_val, (uint32_t *) read_val);
+    while (true) {
+        *report = param_client_recv_timeout (self);
+        ASSERT_TEST(*report != NULL, "Data block reply not received",
+                err_recv_msg, HALCS_CLIENT_ERR_TIMEOUT);
+
+        const char *subject = mlm_client_subject (self->mlm_client);
+        uint32_t curve_id;
+        if (subject != NULL &&
+                sscanf (subject, "%u/%u", &curve_id, block_n) == 2 &&
+                curve_id == self->acq_curve_id) {
+            break;
+        }
+
+        DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_WARN, "[libclient] halcs_get_curve: "
+                "Discarding unexpected reply with subject \"%s\"\n",
+                (subject == NULL) ? "" : subject);
+        zmsg_destroy (report);
+    }
+
+err_recv_msg:
+    return err;
+}
+
+/* Wait for the replies to requests still in flight, so they are not taken
+ * as replies to the next requests. Gives up on the first timeout */
+static void _halcs_acq_drain_block_replies (halcs_client_t *self,
+        uint32_t num_replies)
+{
+    for (; num_replies > 0; num_replies--) {
+        uint32_t block_n;
+        zmsg_t *report = NULL;
+        halcs_client_err_e err = _halcs_acq_recv_block_reply (self, &block_n,
+                &report);
+        zmsg_destroy (&report);
+
+        if (err != HALCS_CLIENT_SUCCESS) {
+            break;
+        }
+    }
+}
+
+/* Decode a data block reply and copy its payload straight from the frame
+ * into data, up to data_size bytes. The number of bytes copied is returned
+ * in read_size */
+static halcs_client_err_e _halcs_acq_copy_block_reply (zmsg_t *report,
+        uint8_t *data, uint32_t data_size, uint32_t *read_size)
+{
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
 
     /* Message is:
      * frame 0: error code
      * frame 1: number of bytes read (optional)
      * frame 2: data read (optional) */
+    zframe_t *err_code = zmsg_first (report);
+    ASSERT_TEST(err_code != NULL && zframe_size (err_code) == ACQ_REPLY_SIZE,
+            "Could not receive error code", err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+    ASSERT_TEST(*(ACQ_REPLY_TYPE *) zframe_data (err_code) == ACQ_OK &&
+            zmsg_size (report) == MSG_FULL_SIZE,
+            "Data block was not acquired", err_get_data_block,
+            HALCS_CLIENT_ERR_SERVER);
+
+    zframe_t *data_size_frm = zmsg_next (report);
+    zframe_t *data_frm = zmsg_next (report);
+    ASSERT_TEST(zframe_size (data_size_frm) == RW_REPLY_SIZE &&
+            *(RW_REPLY_TYPE *) zframe_data (data_size_frm) == zframe_size (data_frm),
+            "<payload> parameter size does not match size in <number of payload bytes> parameter",
+            err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+
+    smio_acq_data_block_t *data_block = (smio_acq_data_block_t *) zframe_data (data_frm);
+    ASSERT_TEST(zframe_size (data_frm) >= sizeof (data_block->valid_bytes) &&
+            data_block->valid_bytes <= zframe_size (data_frm) -
+                sizeof (data_block->valid_bytes),
+            "Malformed data block", err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+
+    *read_size = (data_size < data_block->valid_bytes) ?
+        data_size : data_block->valid_bytes;
+    memcpy (data, data_block->data, *read_size);
 
-    /* Check if any error occurred */
-    ASSERT_TEST(err == HALCS_CLIENT_SUCCESS,
-            "halcs_get_data_block: Data block was not acquired",
-            err_get_data_block, HALCS_CLIENT_ERR_SERVER);
+err_msg_fmt:
+err_get_data_block:
+    return err;
+}
+
+/* Execute an ACQ operation replying with a single smio_acq_data_block_t.
+ * The reply frame is decoded in place and the payload copied once, straight
+ * into the user buffer */
+static halcs_client_err_e _halcs_acq_exec_block (halcs_client_t *self,
+        char *service, const char *name, const uint32_t *args, uint32_t num_args,
+        acq_trans_t *acq_trans)
+{
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+    zmsg_t *report = NULL;
+
+    const disp_op_t* func = halcs_func_translate((char *) name);
+    ASSERT_TEST(func != NULL, "Could not find ACQ function",
+            err_func_translate, HALCS_CLIENT_ERR_INV_FUNCTION);
+
+    self->acq_curve_id++;
+    err = _halcs_acq_send_tagged_req (self, service, func, 0, args, num_args);
+    ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "Could not send ACQ request",
+            err_send_req);
 
-    /* Data size effectively returned */
-    uint32_t read_size = (acq_trans->block.data_size < read_val->valid_bytes) ?
-        acq_trans->block.data_size : read_val->valid_bytes;
+    uint32_t tag;
+    err = _halcs_acq_recv_block_reply (self, &tag, &report);
+    ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "Could not receive ACQ reply",
+            err_recv_reply);
 
-    /* Copy message contents to user */
-    memcpy (acq_trans->block.data, read_val->data, read_size);
+    uint32_t read_size = 0;
+    err = _halcs_acq_copy_block_reply (report, (uint8_t *) acq_trans->block.data,
+            acq_trans->block.data_size, &read_size);
+    ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "ACQ data was not read",
+            err_copy_reply);
 
     /* Inform user about the number of bytes effectively copied */
     acq_trans->block.bytes_read = read_size;
 
     /* Print some debug messages */
-    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_get_data_block: "
-            "read_size: %u\n", read_size);
-    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_get_data_block: "
-            "acq_trans->block.data: %p\n", acq_trans->block.data);
+    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] %s: "
+            "read_size: %u\n", name, read_size);
+    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] %s: "
+            "acq_trans->block.data: %p\n", name, acq_trans->block.data);
 
-err_get_data_block:
+err_copy_reply:
+    zmsg_destroy (&report);
+err_recv_reply:
+err_send_req:
+err_func_translate:
+    return err;
+}
+
+static halcs_client_err_e _halcs_acq_get_data_block (halcs_client_t *self, char *service, acq_trans_t *acq_trans)
+{
+    assert (self);
+    assert (service);
+    assert (acq_trans);
+    assert (acq_trans->block.data);
+
+    /* Sent Message is:
+     * frame 0: operation code
+     * frame 1: channel
+     * frame 2: block required */
+    uint32_t args [2] = {acq_trans->req.chan, acq_trans->block.idx};
+    return _halcs_acq_exec_block (self, service, ACQ_NAME_GET_DATA_BLOCK, args,
+            2, acq_trans);
+}
+
+static halcs_client_err_e _halcs_acq_get_shot (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, uint32_t shot)
+{
+    assert (self);
+    assert (service);
+    assert (acq_trans);
+    assert (acq_trans->block.data);
+
+    /* Sent Message is:
+     * frame 0: operation code
+     * frame 1: channel
+     * frame 2: shot */
+    uint32_t args [2] = {acq_trans->req.chan, shot};
+    return _halcs_acq_exec_block (self, service, ACQ_NAME_GET_SHOT, args, 2,
+            acq_trans);
+}
+
+/* Read blocks->num_blocks blocks, keeping up to acq_window block requests in
+ * flight. Each reply is copied straight into its place in the user buffer */
+static halcs_client_err_e _halcs_acq_get_blocks (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, const acq_blocks_t *blocks)
+{
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+
+    /* New tag for our requests, so replies to requests of a previous,
+     * failed, curve read are told apart */
+    self->acq_curve_id++;
+
+    uint8_t *data_pt = (uint8_t *) acq_trans->block.data;
+    uint32_t data_size = acq_trans->block.data_size;
+    uint32_t num_blocks = blocks->num_blocks;
+    /* Total bytes read */
+    uint32_t total_bread = 0;
+    /* Next block to request */
+    uint32_t block_req = 0;
+    /* Number of replies received */
+    uint32_t num_replies = 0;
+    zmsg_t *report = NULL;
+
+    while (num_replies < num_blocks) {
+        if (zsys_interrupted) {
+            err = HALCS_CLIENT_INT;
+            goto halcs_zsys_interrupted;
+        }
+
+        /* Keep the window full */
+        while (block_req < num_blocks &&
+                block_req - num_replies < self->acq_window) {
+            err = _halcs_acq_send_block_req (self, service, blocks,
+                    acq_trans->req.chan, block_req);
+            ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "Could not request data block",
+                    err_send_block_req);
+            block_req++;
+        }
+
+        uint32_t block_n;
+        err = _halcs_acq_recv_block_reply (self, &block_n, &report);
+        ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "Could not receive data block",
+                err_recv_block_reply);
+        num_replies++;
+
+        ASSERT_TEST(block_n < block_req, "Unexpected data block received",
+                err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+
+        /* All of the blocks but the last are full, so each one has its
+         * fixed place in the user buffer. Copy as much as it holds */
+        uint64_t offset = (uint64_t) block_n * BLOCK_SIZE;
+        if (offset > data_size) {
+            offset = data_size;
+        }
+        uint32_t read_size = 0;
+        err = _halcs_acq_copy_block_reply (report, data_pt + offset,
+                data_size - offset, &read_size);
+        ASSERT_TEST(err == HALCS_CLIENT_SUCCESS,
+                "_halcs_get_data_block failed. block_n is probably out of range",
+                err_msg_fmt);
+        total_bread += read_size;
+        zmsg_destroy (&report);
+
+        /* Print some debug messages */
+        DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_get_curve: "
+                "Block %u: %u bytes read, total bytes read up to now: %u\n",
+                block_n, read_size, total_bread);
+    }
+
+    /* Return to client the total number of bytes read */
+    acq_trans->block.bytes_read = total_bread;
+
+    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_get_curve: "
+            "Data curve of %u bytes was successfully acquired\n", total_bread);
+
+err_msg_fmt:
+    zmsg_destroy (&report);
+err_recv_block_reply:
+err_send_block_req:
+halcs_zsys_interrupted:
+    _halcs_acq_drain_block_replies (self, block_req - num_replies);
     return err;
 }
 
@@ -1231,50 +1969,419 @@ static halcs_client_err_e _halcs_acq_get_curve (halcs_client_t *self, char *serv
     DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_get_curve: "
             "block_n_valid = %u\n", block_n_valid);
 
-    /* Total bytes read */
+    acq_blocks_t blocks = {0};
+    blocks.func = halcs_func_translate(ACQ_NAME_GET_DATA_BLOCK);
+    ASSERT_TEST(blocks.func != NULL, "Could not find data block function",
+            err_func_translate, HALCS_CLIENT_ERR_INV_FUNCTION);
+    blocks.num_blocks = block_n_valid + 1;
+
+    err = _halcs_acq_get_blocks (self, service, acq_trans, &blocks);
+
+err_func_translate:
+    return err;
+}
+
+/* Read a sample range, as blocks of whole samples. Every block but the last
+ * is BLOCK_SIZE bytes long, as with the regular data blocks */
+static halcs_client_err_e _halcs_acq_get_samples (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, uint32_t first_sample,
+        uint32_t num_samples)
+{
+    assert (self);
+    assert (service);
+    assert (acq_trans);
+    assert (acq_trans->block.data);
+
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+
+    ASSERT_TEST(num_samples > 0, "Number of samples must be greater than 0",
+            err_inv_param, HALCS_CLIENT_ERR_INV_PARAM);
+
+    /* Clamp the range to the end of the acquisition, as the server refuses
+     * blocks past it */
+    uint32_t num_samples_multishot = (acq_trans->req.num_samples_pre +
+        acq_trans->req.num_samples_post)*acq_trans->req.num_shots;
+    ASSERT_TEST(first_sample < num_samples_multishot,
+            "First sample is out of the acquisition range", err_inv_param,
+            HALCS_CLIENT_ERR_INV_PARAM);
+    if (num_samples > num_samples_multishot - first_sample) {
+        num_samples = num_samples_multishot - first_sample;
+    }
+
+    acq_blocks_t blocks = {0};
+    blocks.func = halcs_func_translate(ACQ_NAME_GET_SAMPLES);
+    ASSERT_TEST(blocks.func != NULL, "Could not find sample range function",
+            err_func_translate, HALCS_CLIENT_ERR_INV_FUNCTION);
+    blocks.first_sample = first_sample;
+    blocks.num_samples = num_samples;
+    blocks.block_samples = BLOCK_SIZE/self->acq_chan[acq_trans->req.chan].sample_size;
+    blocks.num_blocks = (num_samples + blocks.block_samples - 1) / blocks.block_samples;
+
+    err = _halcs_acq_get_blocks (self, service, acq_trans, &blocks);
+
+err_func_translate:
+err_inv_param:
+    return err;
+}
+
+/* The server reduces a bounded range per request, so each one is answered
+ * within the client timeout. Resume the range after the last bucket of each
+ * reply until all of it is reduced */
+static halcs_client_err_e _halcs_acq_get_curve_reduced (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, acq_reduce_t *acq_reduce)
+{
+    assert (self);
+    assert (service);
+    assert (acq_trans);
+    assert (acq_trans->block.data);
+    assert (acq_reduce);
+
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+
+    ASSERT_TEST(acq_reduce->decim > 0 && acq_reduce->reduction < ACQ_REDUCE_END,
+            "Invalid decimation factor or reduction", err_inv_param,
+            HALCS_CLIENT_ERR_INV_PARAM);
+
+    uint32_t first_sample = acq_reduce->first_sample;
+    uint32_t num_samples = acq_reduce->num_samples;
+    uint32_t num_samples_multishot = (acq_trans->req.num_samples_pre +
+        acq_trans->req.num_samples_post)*acq_trans->req.num_shots;
+    ASSERT_TEST(first_sample < num_samples_multishot,
+            "First sample is out of the acquisition range", err_inv_param,
+            HALCS_CLIENT_ERR_INV_PARAM);
+    if (num_samples == 0 || num_samples > num_samples_multishot - first_sample) {
+        num_samples = num_samples_multishot - first_sample;
+    }
+
+    uint32_t reduced_bucket_size = self->acq_chan[acq_trans->req.chan].sample_size*
+        ((acq_reduce->reduction == ACQ_REDUCE_MINMAX) ? 2 : 1);
+    uint64_t num_buckets = ((uint64_t) num_samples + acq_reduce->decim - 1) /
+        acq_reduce->decim;
+    ASSERT_TEST(num_buckets*reduced_bucket_size <= acq_trans->block.data_size,
+            "Reduced curve does not fit in the data buffer", err_inv_param,
+            HALCS_CLIENT_ERR_INV_PARAM);
+
+    acq_trans_t acq_trans_part = *acq_trans;
+    uint8_t *data_pt = (uint8_t *) acq_trans->block.data;
     uint32_t total_bread = 0;
-    /* Save the original buffer size for later */
-    uint32_t data_size = acq_trans->block.data_size;
-    uint32_t *original_data_pt = acq_trans->block.data;
 
-    /* Fill all blocks */
-    for (uint32_t block_n = 0; block_n <= block_n_valid; block_n++) {
+    while (num_samples > 0) {
+        acq_trans_part.block.data = (uint32_t *) (data_pt + total_bread);
+        acq_trans_part.block.data_size = acq_trans->block.data_size - total_bread;
+
+        /* Sent Message is:
+         * frame 0: operation code
+         * frame 1: channel
+         * frame 2: first sample
+         * frame 3: number of samples
+         * frame 4: decimation factor
+         * frame 5: reduction */
+        uint32_t args [5] = {acq_trans->req.chan, first_sample, num_samples,
+            acq_reduce->decim, acq_reduce->reduction};
+        err = _halcs_acq_exec_block (self, service, ACQ_NAME_GET_CURVE_REDUCED,
+                args, 5, &acq_trans_part);
+        ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "Could not reduce curve",
+                err_exec_block);
+
+        /* Every reply but the last one ends at a bucket boundary */
+        uint32_t read_size = acq_trans_part.block.bytes_read;
+        uint64_t reply_buckets = read_size / reduced_bucket_size;
+        ASSERT_TEST(reply_buckets > 0 && read_size % reduced_bucket_size == 0,
+                "Malformed reduced curve", err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+        uint64_t reply_samples = reply_buckets*acq_reduce->decim;
+        if (reply_samples > num_samples) {
+            reply_samples = num_samples;
+        }
+
+        first_sample += reply_samples;
+        num_samples -= reply_samples;
+        total_bread += read_size;
+    }
+
+    /* Return to client the total number of bytes read */
+    acq_trans->block.bytes_read = total_bread;
+
+err_msg_fmt:
+err_exec_block:
+err_inv_param:
+    return err;
+}
+
+/* Receive the next message of the current curve stream. It is either a data
+ * block, pushed by the server, or the reply to one of our stream requests,
+ * tagged as sent. Messages left behind by previous streams or curves are
+ * discarded */
+static halcs_client_err_e _halcs_acq_recv_stream_msg (halcs_client_t *self,
+        bool *is_block, uint32_t *tag, zmsg_t **report)
+{
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+
+    while (true) {
+        *report = param_client_recv_timeout (self);
+        ASSERT_TEST(*report != NULL, "Curve stream message not received",
+                err_recv_msg, HALCS_CLIENT_ERR_TIMEOUT);
+
+        const char *subject = mlm_client_subject (self->mlm_client);
+        uint32_t curve_id;
+        if (subject != NULL &&
+                sscanf (subject, ACQ_STREAM_SUBJECT ":%u/%u", &curve_id, tag) == 2 &&
+                curve_id == self->acq_curve_id) {
+            *is_block = true;
+            break;
+        }
+        if (subject != NULL &&
+                sscanf (subject, "%u/%u", &curve_id, tag) == 2 &&
+                curve_id == self->acq_curve_id) {
+            *is_block = false;
+            break;
+        }
+
+        DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_WARN, "[libclient] halcs_get_curve_stream: "
+                "Discarding unexpected message with subject \"%s\"\n",
+                (subject == NULL) ? "" : subject);
+        zmsg_destroy (report);
+    }
+
+err_recv_msg:
+    return err;
+}
+
+/* Decode the reply to a curve stream request, carrying a number of bytes:
+ * the size of the range for ACQ_NAME_GET_CURVE_STREAM and the bytes still to
+ * be pushed for ACQ_NAME_CURVE_STREAM_CREDIT */
+static halcs_client_err_e _halcs_acq_decode_stream_reply (zmsg_t *report,
+        uint64_t *bytes)
+{
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+
+    /* Message is:
+     * frame 0: error code
+     * frame 1: number of bytes of the reply (optional)
+     * frame 2: number of bytes (optional) */
+    size_t msg_size = zmsg_size (report);
+    ASSERT_TEST(msg_size == MSG_ERR_CODE_SIZE || msg_size == MSG_FULL_SIZE,
+            "Unexpected message received", err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+    zframe_t *err_code = zmsg_first (report);
+    ASSERT_TEST(zframe_size (err_code) == ACQ_REPLY_SIZE,
+            "Could not receive error code", err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+    ASSERT_TEST(*(ACQ_REPLY_TYPE *) zframe_data (err_code) == ACQ_OK,
+            "halcs_get_curve_stream: Data curve was not acquired",
+            err_msg_fmt, HALCS_CLIENT_ERR_SERVER);
+    ASSERT_TEST(msg_size == MSG_FULL_SIZE, "Could not receive curve stream size",
+            err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+    zmsg_next (report);
+    zframe_t *bytes_frm = zmsg_next (report);
+    ASSERT_TEST(zframe_size (bytes_frm) == sizeof (uint64_t),
+            "Could not receive curve stream size", err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+
+    *bytes = *(uint64_t *) zframe_data (bytes_frm);
+
+err_msg_fmt:
+    return err;
+}
+
+/* Wait for the stream messages still in flight, so they are not taken as
+ * replies to the next requests. A failed request means the server dropped
+ * the stream, so no more blocks will come. Gives up on the first timeout */
+static void _halcs_acq_drain_stream (halcs_client_t *self, uint32_t num_blocks,
+        uint32_t num_replies)
+{
+    while (num_blocks > 0 || num_replies > 0) {
+        bool is_block;
+        uint32_t tag;
+        uint64_t bytes;
+        zmsg_t *report = NULL;
+        halcs_client_err_e err = _halcs_acq_recv_stream_msg (self, &is_block,
+                &tag, &report);
+        if (err != HALCS_CLIENT_SUCCESS) {
+            break;
+        }
+
+        if (is_block) {
+            num_blocks = (num_blocks > 0) ? num_blocks - 1 : 0;
+        }
+        else {
+            num_replies = (num_replies > 0) ? num_replies - 1 : 0;
+            if (_halcs_acq_decode_stream_reply (report, &bytes) != HALCS_CLIENT_SUCCESS) {
+                num_blocks = 0;
+            }
+        }
+        zmsg_destroy (&report);
+    }
+}
+
+/* Have the server push the sample range, with no request per block. The
+ * server only sends as many blocks as we have granted credits for, up to
+ * halcs_client_get_acq_window (), and the credits are topped up as soon as
+ * half of them are used, so the stream never stalls waiting for us */
+static halcs_client_err_e _halcs_acq_get_curve_stream (halcs_client_t *self,
+        char *service, acq_trans_t *acq_trans, uint32_t first_sample,
+        uint32_t num_samples)
+{
+    assert (self);
+    assert (service);
+    assert (acq_trans);
+    assert (acq_trans->block.data);
+
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+    zmsg_t *report = NULL;
+    /* Blocks granted and received, and replies we are waiting for */
+    uint32_t num_granted = 0;
+    uint32_t num_received = 0;
+    uint32_t num_replies = 0;
+
+    const disp_op_t* func = halcs_func_translate(ACQ_NAME_GET_CURVE_STREAM);
+    ASSERT_TEST(func != NULL, "Could not find curve stream function",
+            err_func_translate, HALCS_CLIENT_ERR_INV_FUNCTION);
+    const disp_op_t* credit_func = halcs_func_translate(ACQ_NAME_CURVE_STREAM_CREDIT);
+    ASSERT_TEST(credit_func != NULL, "Could not find curve stream credit function",
+            err_func_translate, HALCS_CLIENT_ERR_INV_FUNCTION);
+
+    uint32_t chan = acq_trans->req.chan;
+    uint32_t sample_size = self->acq_chan[chan].sample_size;
+    uint32_t num_samples_multishot = (acq_trans->req.num_samples_pre +
+        acq_trans->req.num_samples_post)*acq_trans->req.num_shots;
+    ASSERT_TEST(first_sample < num_samples_multishot,
+            "First sample is out of the acquisition range", err_inv_param,
+            HALCS_CLIENT_ERR_INV_PARAM);
+    if (num_samples == 0 || num_samples > num_samples_multishot - first_sample) {
+        num_samples = num_samples_multishot - first_sample;
+    }
+
+    uint64_t size = (uint64_t) num_samples*sample_size;
+    ASSERT_TEST(size <= acq_trans->block.data_size,
+            "Sample range does not fit in the data buffer", err_inv_param,
+            HALCS_CLIENT_ERR_INV_PARAM);
+    uint32_t num_blocks = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    /* New tag for our requests, so messages of a previous, failed, stream
+     * are told apart */
+    self->acq_curve_id++;
+
+    /* Sent Message is:
+     * frame 0: operation code
+     * frame 1: channel
+     * frame 2: first sample
+     * frame 3: number of samples
+     * frame 4: number of blocks we are ready to receive */
+    num_granted = (num_blocks < self->acq_window) ? num_blocks : self->acq_window;
+    uint32_t args [4] = {chan, first_sample, num_samples, num_granted};
+    err = _halcs_acq_send_tagged_req (self, service, func, 0, args, 4);
+    ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "Could not send curve stream request",
+            err_send_req);
+    num_replies++;
+
+    uint8_t *data_pt = (uint8_t *) acq_trans->block.data;
+    uint64_t total_bread = 0;
+    uint32_t credit_tag = 0;
+
+    while (num_received < num_blocks || num_replies > 0) {
         if (zsys_interrupted) {
             err = HALCS_CLIENT_INT;
             goto halcs_zsys_interrupted;
         }
 
-        acq_trans->block.idx = block_n;
-        err = _halcs_acq_get_data_block (self, service, acq_trans);
+        bool is_block;
+        uint32_t tag;
+        err = _halcs_acq_recv_stream_msg (self, &is_block, &tag, &report);
+        ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "Could not receive curve stream message",
+                err_recv_msg);
+
+        if (!is_block) {
+            num_replies--;
+
+            uint64_t bytes;
+            err = _halcs_acq_decode_stream_reply (report, &bytes);
+            if (err != HALCS_CLIENT_SUCCESS) {
+                /* The server dropped the stream */
+                num_received = num_granted;
+                goto err_stream_reply;
+            }
+            /* The server must agree with us on the size of the range */
+            ASSERT_TEST(tag != 0 || bytes == size, "Unexpected curve stream size",
+                    err_msg_fmt, HALCS_CLIENT_ERR_MSG);
 
-        /* Check for return code */
-        ASSERT_TEST(err == HALCS_CLIENT_SUCCESS,
-                "_halcs_get_data_block failed. block_n is probably out of range",
-                err_halcs_get_data_block);
+            zmsg_destroy (&report);
+            continue;
+        }
 
-        total_bread += acq_trans->block.bytes_read;
-        acq_trans->block.data = (uint32_t *)((uint8_t *)acq_trans->block.data + acq_trans->block.bytes_read);
-        acq_trans->block.data_size -= acq_trans->block.bytes_read;
+        /* Message is:
+         * frame 0: reply code
+         * frame 1: block sequence number
+         * frame 2: number of bytes in block
+         * frame 3: data */
+        ASSERT_TEST(zmsg_size (report) == ACQ_STREAM_MSG_SIZE,
+                "Malformed curve stream message", err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+        zframe_t *reply_code_frm = zmsg_first (report);
+        zframe_t *seq_frm = zmsg_next (report);
+        zframe_t *size_frm = zmsg_next (report);
+        zframe_t *data_frm = zmsg_next (report);
+        ASSERT_TEST(zframe_size (reply_code_frm) == ACQ_REPLY_SIZE &&
+                zframe_size (seq_frm) == sizeof (ACQ_STREAM_SEQ_TYPE) &&
+                zframe_size (size_frm) == sizeof (ACQ_STREAM_SIZE_TYPE),
+                "Malformed curve stream message", err_msg_fmt,
+                HALCS_CLIENT_ERR_MSG);
+
+        ACQ_STREAM_SEQ_TYPE seq = *(ACQ_STREAM_SEQ_TYPE *) zframe_data (seq_frm);
+        ACQ_STREAM_SIZE_TYPE block_size = *(ACQ_STREAM_SIZE_TYPE *) zframe_data (size_frm);
+        ASSERT_TEST(seq == num_received && num_received < num_granted,
+                "Curve stream block out of sequence", err_msg_fmt,
+                HALCS_CLIENT_ERR_MSG);
+        ASSERT_TEST(block_size == zframe_size (data_frm),
+                "<payload> parameter size does not match size in <number of payload bytes> parameter",
+                err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+        ASSERT_TEST(block_size <= size - total_bread,
+                "Curve stream is longer than requested", err_msg_fmt,
+                HALCS_CLIENT_ERR_MSG);
+
+        memcpy (data_pt + total_bread, zframe_data (data_frm), block_size);
+        total_bread += block_size;
+        num_received++;
+        zmsg_destroy (&report);
+
+        /* Top the credits up once half of them are used */
+        uint32_t in_flight = num_granted - num_received;
+        if (num_granted < num_blocks && in_flight <= self->acq_window/2) {
+            uint32_t credits = self->acq_window - in_flight;
+            if (credits > num_blocks - num_granted) {
+                credits = num_blocks - num_granted;
+            }
 
-        /* Print some debug messages */
-        DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_get_curve: "
-                "Total bytes read up to now: %u\n", total_bread);
-        DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_get_curve: "
-                "Data pointer addr: %p\n", acq_trans->block.data);
-        DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_get_curve: "
-                "Data buffer size: %u\n", acq_trans->block.data_size);
+            /* Sent Message is:
+             * frame 0: operation code
+             * frame 1: number of blocks we are ready to receive */
+            err = _halcs_acq_send_tagged_req (self, service, credit_func,
+                    ++credit_tag, &credits, 1);
+            ASSERT_TEST(err == HALCS_CLIENT_SUCCESS, "Could not grant curve stream credits",
+                    err_send_credit);
+            num_granted += credits;
+            num_replies++;
+        }
     }
 
+    /* Blocks lost on the way or a range cut short by the server */
+    ASSERT_TEST(total_bread == size, "Truncated curve stream", err_msg_fmt,
+            HALCS_CLIENT_ERR_MSG);
+
     /* Return to client the total number of bytes read */
     acq_trans->block.bytes_read = total_bread;
-    acq_trans->block.data_size = data_size;
-    acq_trans->block.data = original_data_pt;
 
-    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_get_curve: "
-            "Data curve of %u bytes was successfully acquired\n", total_bread);
+    DBE_DEBUG (DBG_LIB_CLIENT | DBG_LVL_TRACE, "[libclient] halcs_get_curve_stream: "
+            "Data curve of %"PRIu64" bytes was successfully acquired in %u blocks\n",
+            total_bread, num_received);
 
+err_msg_fmt:
+err_stream_reply:
+    zmsg_destroy (&report);
+err_send_credit:
+err_recv_msg:
 halcs_zsys_interrupted:
-err_halcs_get_data_block:
+    if (err != HALCS_CLIENT_SUCCESS) {
+        _halcs_acq_drain_stream (self, num_granted - num_received, num_replies);
+    }
+err_send_req:
+err_inv_param:
+err_func_translate:
     return err;
 }
 
@@ -1286,12 +2393,27 @@ static halcs_client_err_e _halcs_full_acq (halcs_client_t *self, char *service,
     assert (acq_trans);
     assert (acq_trans->block.data);
 
+    /* Prefer being notified by the server when the acquisition is done.
+     * If we can't, fall back to polling it */
+    halcs_client_err_e err = _halcs_acq_subscribe_done (self, service);
+    bool wait_event = (err == HALCS_CLIENT_SUCCESS);
+    if (wait_event) {
+        /* Discard events from previous acquisitions */
+        _halcs_client_flush_events (self);
+    }
+
     /* Send Acquisition Request */
     _halcs_acq_start (self, service, &acq_trans->req);
 
     /* Wait until the acquisition is finished */
-    halcs_client_err_e err = _func_polling (self, ACQ_NAME_CHECK_DATA_ACQUIRE,
-            service, NULL, NULL, timeout);
+    if (wait_event) {
+        err = _halcs_acq_wait_done (self, service,
+                ACQ_CHAN_MASK(acq_trans->req.chan), NULL, timeout);
+    }
+    else {
+        err = _func_polling (self, halcs_func_translate (ACQ_NAME_CHECK_DATA_ACQUIRE),
+                service, NULL, NULL, timeout);
+    }
 
     ASSERT_TEST(err == HALCS_CLIENT_SUCCESS,
             "Data acquisition was not completed",
@@ -1489,6 +2611,135 @@ PARAM_FUNC_CLIENT_READ(monit_updt)
     return param_client_read (self, service, DSP_OPCODE_SET_GET_MONIT_UPDT, monit_updt);
 }
 
+/* Monitoring AMP/POS snapshot */
+halcs_client_err_e halcs_get_monit_amp_pos (halcs_client_t *self, char *service,
+        struct _smio_dsp_monit_t *monit)
+{
+    assert (monit);
+
+    const disp_op_t* func = halcs_func_translate(DSP_NAME_MONIT_AMP_POS);
+    return halcs_func_exec (self, func, service, NULL, (uint32_t *) monit);
+}
+
+/* Monitoring stream subscription */
+PARAM_FUNC_CLIENT_WRITE(monit_stream)
+{
+    return param_client_write (self, service, DSP_OPCODE_SET_GET_MONIT_STREAM, monit_stream);
+}
+
+PARAM_FUNC_CLIENT_READ(monit_stream)
+{
+    return param_client_read (self, service, DSP_OPCODE_SET_GET_MONIT_STREAM, monit_stream);
+}
+
+/* Monitoring stream subscription of service, or NULL if there is none */
+static char *_halcs_find_monit_stream (halcs_client_t *self, char *service)
+{
+    for (char *stream = (char *) zlist_first (self->monit_streams); stream != NULL;
+            stream = (char *) zlist_next (self->monit_streams)) {
+        if (streq (stream, service)) {
+            return stream;
+        }
+    }
+
+    return NULL;
+}
+
+halcs_client_err_e halcs_subscribe_monit_amp_pos (halcs_client_t *self, char *service)
+{
+    assert (self);
+    assert (service);
+
+    /* A client holds at most one subscription per service */
+    if (_halcs_find_monit_stream (self, service) != NULL) {
+        return HALCS_CLIENT_SUCCESS;
+    }
+
+    /* Events are published on a stream named after the service */
+    halcs_client_err_e err = _halcs_client_subscribe (self, service, DSP_EVENT_MONIT);
+    if (err != HALCS_CLIENT_SUCCESS) {
+        return err;
+    }
+
+    /* The server only publishes while the stream has subscribers */
+    err = param_client_write (self, service, DSP_OPCODE_SET_GET_MONIT_STREAM, 1);
+    if (err != HALCS_CLIENT_SUCCESS) {
+        return err;
+    }
+
+    /* Not autofree, as the entries are freed by us on removal */
+    char *stream = strdup (service);
+    ASSERT_ALLOC(stream, err_stream_alloc, HALCS_CLIENT_ERR_ALLOC);
+    zlist_append (self->monit_streams, stream);
+
+err_stream_alloc:
+    return err;
+}
+
+halcs_client_err_e halcs_unsubscribe_monit_amp_pos (halcs_client_t *self, char *service)
+{
+    assert (self);
+    assert (service);
+
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+    char *stream = _halcs_find_monit_stream (self, service);
+    ASSERT_TEST(stream != NULL,
+            "Not subscribed to the monitoring stream of this service",
+            err_not_subscribed, HALCS_CLIENT_ERR_INV_PARAM);
+
+    /* Forget the subscription even if the server could not be reached, so
+     * we never unsubscribe twice from it */
+    err = param_client_write (self, service, DSP_OPCODE_SET_GET_MONIT_STREAM, 0);
+    zlist_remove (self->monit_streams, stream);
+    free (stream);
+
+err_not_subscribed:
+    return err;
+}
+
+halcs_client_err_e halcs_wait_monit_amp_pos (halcs_client_t *self, char *service,
+        struct _smio_dsp_monit_t *monit, uint64_t *timestamp, int timeout)
+{
+    assert (self);
+    assert (service);
+    assert (monit);
+
+    halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
+
+    zmsg_t *msg = _halcs_client_recv_event (self, service, DSP_EVENT_MONIT, timeout);
+    if (msg == NULL) {
+        err = zsys_interrupted ? HALCS_CLIENT_INT : HALCS_CLIENT_ERR_TIMEOUT;
+        goto err_recv_event;
+    }
+
+    /* Message is:
+     * frame 0: monitoring values
+     * frame 1: timestamp */
+    ASSERT_TEST(zmsg_size (msg) == DSP_EVENT_MONIT_SIZE, "Unexpected event received",
+            err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+    zframe_t *monit_frm = zmsg_first (msg);
+    zframe_t *timestamp_frm = zmsg_next (msg);
+    ASSERT_TEST(zframe_size (monit_frm) == sizeof (*monit) &&
+            zframe_size (timestamp_frm) == sizeof (uint64_t),
+            "Malformed monitoring event", err_msg_fmt, HALCS_CLIENT_ERR_MSG);
+
+    memcpy (monit, zframe_data (monit_frm), sizeof (*monit));
+    if (timestamp != NULL) {
+        *timestamp = *(uint64_t *) zframe_data (timestamp_frm);
+    }
+
+err_msg_fmt:
+    zmsg_destroy (&msg);
+err_recv_event:
+    return err;
+}
+
+/* DSP register shadow resync */
+PARAM_FUNC_CLIENT_WRITE(dsp_shadow_resync)
+{
+    return param_client_write (self, service, DSP_OPCODE_SHADOW_RESYNC, dsp_shadow_resync);
+}
+
 /**************** Swap SMIO Functions ****************/
 
 /* Switching functions */
@@ -1634,6 +2885,12 @@ PARAM_FUNC_CLIENT_READ2(gain_d, dir_gain, inv_gain)
     return err;
 }
 
+/* Swap register shadow resync */
+PARAM_FUNC_CLIENT_WRITE(swap_shadow_resync)
+{
+    return param_client_write (self, service, SWAP_OPCODE_SHADOW_RESYNC, swap_shadow_resync);
+}
+
 /**************** RFFE SMIO Functions ****************/
 
 /* RFFE get/set attenuator */
@@ -2026,6 +3283,12 @@ PARAM_FUNC_CLIENT_WRITE_READ(trigger_count_transm, chan, count_transm)
             chan, count_transm);
 }
 
+/* Trigger interface register shadow resync */
+PARAM_FUNC_CLIENT_WRITE(trigger_iface_shadow_resync)
+{
+    return param_client_write (self, service, TRIGGER_IFACE_OPCODE_SHADOW_RESYNC, trigger_iface_shadow_resync);
+}
+
 /********************** Trigger Mux Functions ********************/
 
 /* Trigger receive source */
@@ -2080,38 +3343,48 @@ PARAM_FUNC_CLIENT_WRITE_READ(trigger_transm_out_sel, chan, transm_out_sel)
             chan, transm_out_sel);
 }
 
+/* Trigger mux register shadow resync */
+PARAM_FUNC_CLIENT_WRITE(trigger_mux_shadow_resync)
+{
+    return param_client_write (self, service, TRIGGER_MUX_OPCODE_SHADOW_RESYNC, trigger_mux_shadow_resync);
+}
+
 /**************** Helper Function ****************/
 
 halcs_client_err_e func_polling (halcs_client_t *self, char *name, char *service,
         uint32_t *input, uint32_t *output, int timeout)
 {
-    return _func_polling (self, name, service, input, output, timeout);
+    assert (name);
+    return _func_polling (self, halcs_func_translate (name), service, input,
+            output, timeout);
+}
+
+halcs_client_err_e func_polling_exec (halcs_client_t *self, const disp_op_t *func,
+        char *service, uint32_t *input, uint32_t *output, int timeout)
+{
+    return _func_polling (self, func, service, input, output, timeout);
 }
 
 /* Polling Function */
-static halcs_client_err_e _func_polling (halcs_client_t *self, char *name,
+static halcs_client_err_e _func_polling (halcs_client_t *self, const disp_op_t *func,
         char *service, uint32_t *input, uint32_t *output, int timeout)
 {
     assert (self);
-    assert (name);
     assert (service);
 
     /* timeout < 0 means "infinite" wait */
     if (timeout < 0) {
-        /* FIXME! Very unportable way! We assume that time_t is at least of
-         * size INT */
         timeout = INT_MAX;
     }
 
     halcs_client_err_e err = HALCS_CLIENT_SUCCESS;
-    time_t start = time (NULL);
-    while ((time(NULL) - start)*1000 < timeout) {
+    int64_t start = zclock_mono ();
+    while (zclock_mono () - start < timeout) {
         if (zsys_interrupted) {
             err = HALCS_CLIENT_INT;
             goto halcs_zsys_interrupted;
         }
 
-        const disp_op_t* func = halcs_func_translate(name);
         err = halcs_func_exec (self, func, service, input, output);
 
         if (err == HALCS_CLIENT_SUCCESS) {
@@ -2132,3 +3405,37 @@ halcs_zsys_interrupted:
 exit:
     return err;
 }
+
+/* Get the function name table, building it on the first call. Concurrent
+ * first calls may each build a table, but only one gets published */
+static zhashx_t *_halcs_func_table_get (void)
+{
+    zhashx_t *func_table = __atomic_load_n (&halcs_func_table, __ATOMIC_ACQUIRE);
+    if (func_table != NULL) {
+        return func_table;
+    }
+
+    func_table = zhashx_new ();
+    ASSERT_ALLOC(func_table, err_func_table_alloc);
+
+    for (int i = 0; smio_exp_ops[i] != NULL; i++) {
+        for (int j = 0; smio_exp_ops[i][j] != NULL; j++) {
+            /* Keep the first match, as the linear search used to */
+            zhashx_insert (func_table, smio_exp_ops[i][j]->name,
+                    (void *) smio_exp_ops[i][j]);
+        }
+    }
+
+    zhashx_t *expected = NULL;
+    if (!__atomic_compare_exchange_n (&halcs_func_table, &expected, func_table,
+                false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        /* Someone else got there first. Use theirs */
+        zhashx_destroy (&func_table);
+        func_table = expected;
+    }
+
+    return func_table;
+
+err_func_table_alloc:
+    return NULL;
+}
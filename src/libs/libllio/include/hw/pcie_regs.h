@@ -77,6 +77,31 @@
 #define PCIE_CFG_REG_DMA_DS_CTRL            (27 << WB_DWORD_ACC)
 #define PCIE_CFG_REG_DMA_DS_STA             (28 << WB_DWORD_ACC)
 
+/* DMA channel control register bits. Writing a descriptor with the VALID
+ * bit set starts the transfer.
+ *
+ * WARNING: these CTRL bits, the STA bits below and the CHANNEL_RST
+ * behaviour (clearing DONE and the transferred byte count) were taken
+ * from the PCIe core documentation and have NOT been verified against
+ * the FPGA firmware. This is why DMA is only compiled in with
+ * WITH_PCIE_DMA=y */
+#define PCIE_CFG_DMA_CTRL_AINC              (0x1 << 15) /* Increment peripheral address */
+#define PCIE_CFG_DMA_CTRL_BAR_SHIFT         16          /* Peripheral BAR */
+#define PCIE_CFG_DMA_CTRL_BAR_MASK          (0xF << PCIE_CFG_DMA_CTRL_BAR_SHIFT)
+#define PCIE_CFG_DMA_CTRL_BAR(bar)          (((bar) << PCIE_CFG_DMA_CTRL_BAR_SHIFT) & \
+                                                PCIE_CFG_DMA_CTRL_BAR_MASK)
+#define PCIE_CFG_DMA_CTRL_UPA               (0x1 << 20) /* Use 64-bit peripheral address */
+#define PCIE_CFG_DMA_CTRL_LAST              (0x1 << 24) /* Last descriptor of the chain */
+#define PCIE_CFG_DMA_CTRL_VALID             (0x1 << 25) /* Descriptor valid */
+/* Must not have PCIE_CFG_DMA_CTRL_VALID set, or the reset could start a
+ * transfer */
+#define PCIE_CFG_DMA_CTRL_CHANNEL_RST       0x0000000A
+
+/* DMA channel status register bits */
+#define PCIE_CFG_DMA_STA_DONE               (0x1 << 0)
+#define PCIE_CFG_DMA_STA_BUSY               (0x1 << 1)
+#define PCIE_CFG_DMA_STA_TIMEOUT            (0x1 << 4)
+
 /* Address for MRd channel control */
 #define PCIE_CFG_REG_MRD_CTRL               (29 << WB_DWORD_ACC)
 /* Address for Tx module control */
@@ -160,6 +185,22 @@
 
 /*************************** PCIe BAR RW type **************************/
 #define BAR_RW_TYPE                         uint32_t
+#define BAR_RW_64_TYPE                      uint64_t
+
+/*********************** PCIe BAR block copy kernels ********************/
+/* Kernels used for BAR2 block copies, from the narrowest to the widest
+ * access. By default only the plain 32-bit accesses are used. Wider
+ * kernels are opt-in: set PCIE_BLOCK_COPY to the widest one allowed and
+ * the widest one supported by the CPU, and that copies the same bytes as
+ * the 32-bit kernel, is selected at runtime */
+#define PCIE_BLOCK_COPY_32                  0           /* 32-bit accesses */
+#define PCIE_BLOCK_COPY_64                  1           /* 64-bit accesses */
+#define PCIE_BLOCK_COPY_SSE                 2           /* 128-bit SSE4.1 streaming */
+#define PCIE_BLOCK_COPY_AVX                 3           /* 256-bit AVX2 streaming */
+
+#ifndef PCIE_BLOCK_COPY
+#define PCIE_BLOCK_COPY                     PCIE_BLOCK_COPY_32
+#endif
 
 /********** Read or write to BAR **********/
 #define BAR_RW_8(barp, addr, datap, rw)                             \
@@ -216,6 +257,28 @@
         }                                                           \
     } while (0)
 
+/* 64-bit accesses. (barp + addr) must be 64-bit aligned and size a
+ * multiple of 64-bit */
+#define BAR_RW_64_BLOCK(barp, addr, size, datap, rw)                \
+    do {                                                            \
+        BAR_RW_64_TYPE *_barp64 = (BAR_RW_64_TYPE *)(((uint8_t *)barp) + \
+                (addr));                                            \
+        uint8_t *_datap8 = (uint8_t *)(datap);                      \
+        BAR_RW_64_TYPE _word;                                       \
+        if (rw) {                                                   \
+            for (uint32_t j = 0; j < size/sizeof (BAR_RW_64_TYPE); ++j) { \
+                _word = _barp64[j];                                 \
+                memcpy (_datap8 + j*sizeof (_word), &_word, sizeof (_word)); \
+            }                                                       \
+        }                                                           \
+        else {                                                      \
+            for (uint32_t j = 0; j < size/sizeof (BAR_RW_64_TYPE); ++j) { \
+                memcpy (&_word, _datap8 + j*sizeof (_word), sizeof (_word)); \
+                _barp64[j] = _word;                                 \
+            }                                                       \
+        }                                                           \
+    } while (0)
+
 #define BAR0_RW_BLOCK(barp, addr, size, datap, rw)                  \
     BAR_RW_8_BLOCK(barp, addr, size, datap, rw)
 
@@ -61,5 +61,6 @@ typedef struct _llio_t llio_t;
 #include "ll_io_pcie.h"
 #include "ll_io_eth_utils.h"
 #include "ll_io_eth.h"
+#include "ll_io_sim.h"
 
 #endif
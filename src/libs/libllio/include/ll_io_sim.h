@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2014 LNLS (www.lnls.br)
+ * Author: Lucas Russo <lucas.russo@lnls.br>
+ *
+ * Released according to the GNU GPL, version 3 or any later version.
+ */
+
+#ifndef _LL_IO_SIM_H_
+#define _LL_IO_SIM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Simulated PCIe device. BAR0, BAR2 and BAR4 are plain host memory,
+ * addressed as on the PCIe device (see hw/pcie_regs.h), but with no
+ * paging. The endpoint name has the form:
+ *
+ *  sim[:<access latency in ns>[:<block throughput in MB/s>]]
+ *
+ * Every access costs the latency, spent busy-waiting. Block and DMA
+ * accesses cost the size over the throughput on top of that. Both
+ * default to 0, i.e., memory speed */
+#define LLIO_SIM_ENDPOINT_PREFIX            "sim"
+
+#define LLIO_SIM_BAR0_SIZE                  (1ULL << 12)
+/* Large enough for the whole acquisition DDR3 */
+#define LLIO_SIM_BAR2_SIZE                  (1ULL << 31)
+/* 28-bit Wishbone address space */
+#define LLIO_SIM_BAR4_SIZE                  (1ULL << 28)
+#define LLIO_SIM_MAX_HOOKS                  16
+
+/* Called after data was written to a register with a hook set. The hook
+ * may update other registers with llio_sim_poke_32 () */
+typedef void (*llio_sim_write_hook_fp) (llio_t *self, uint64_t offs,
+        uint32_t data, void *hook_arg);
+
+/* For use by llio_t general structure */
+extern const llio_ops_t llio_ops_sim;
+
+/* Models a register with side effects. Every write covering the 32-bit
+ * register at offs calls hook. A NULL hook removes it */
+llio_err_e llio_sim_set_write_hook (llio_t *self, uint64_t offs,
+        llio_sim_write_hook_fp hook, void *hook_arg);
+/* Copy size bytes into the simulated device memory, e.g., a ROM image.
+ * No latency is added and no hook is called */
+llio_err_e llio_sim_load (llio_t *self, uint64_t offs, const void *data,
+        size_t size);
+/* Read/Write a register from a hook or a register model. No latency is
+ * added and no hook is called */
+llio_err_e llio_sim_peek_32 (llio_t *self, uint64_t offs, uint32_t *data);
+llio_err_e llio_sim_poke_32 (llio_t *self, uint64_t offs, uint32_t data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
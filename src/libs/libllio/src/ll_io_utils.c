@@ -38,6 +38,7 @@ static const convc_types_t llio_dev_types_map [] ={
     {.name = GENERIC_DEV_STR,       .type = GENERIC_DEV},
     {.name = PCIE_DEV_STR,          .type = PCIE_DEV},
     {.name = ETH_DEV_STR,           .type = ETH_DEV},
+    {.name = SIM_DEV_STR,           .type = SIM_DEV},
     {.name = INVALID_DEV_STR,       .type = INVALID_DEV},
     {.name = CONVC_TYPE_NAME_END,   .type = CONVC_TYPE_END}        /* End marker */
 };
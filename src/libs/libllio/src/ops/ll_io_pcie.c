@@ -11,6 +11,11 @@
 #include <pciDriver/lib/pciDriver.h>
 #include "hw/pcie_regs.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#define PCIE_BLOCK_COPY_X86
+#include <immintrin.h>
+#endif
+
 /* Undef ASSERT_ALLOC to avoid conflicting with other ASSERT_ALLOC */
 #ifdef ASSERT_TEST
 #undef ASSERT_TEST
@@ -46,6 +51,27 @@
 /* Number of timeout pattern bytes in a row to detect a timeout */
 #define PCIE_TIMEOUT_PATT_SIZE                  32
 
+/* Largest block used to check a BAR block copy kernel against the
+ * 32-bit one. Must be a multiple of 32-bit */
+#define PCIE_BLOCK_COPY_CHECK_SIZE              256
+/* Largest misalignment tried by the check, in bytes */
+#define PCIE_BLOCK_COPY_CHECK_MISALIGN          32
+
+/* Size of the pinned host buffer used as the DMA target/source. Larger
+ * transfers are split in chunks of this size */
+#define PCIE_DMA_BUF_SIZE                       PCIE_SDRAM_PG_SIZE
+#define PCIE_DMA_TIMEOUT_MAX_TRIES              100000
+/* Wait between DMA status polls, in usecs */
+#define PCIE_DMA_TIMEOUT_WAIT                   10
+
+#define DMA_FROM_DEVICE                         1
+#define DMA_TO_DEVICE                           0
+
+/* BAR block copy kernel. barp must already point to the first MMIO
+ * address and size is in bytes */
+typedef void (*pcie_block_copy_fp) (uint8_t *barp, uint32_t *data,
+        uint32_t size, int rw);
+
 /* Device endpoint */
 typedef struct {
     pd_device_t *dev;                   /* PCIe device handler */
@@ -55,6 +81,10 @@ typedef struct {
     uint32_t bar2_size;                 /* PCIe BAR2 size */
     uint64_t *bar4;                     /* PCIe BAR4 */
     uint32_t bar4_size;                 /* PCIe BAR4 size */
+    pd_kmem_t dma_kmem;                 /* Pinned kernel memory for DMA */
+    uint32_t *dma_buf;                  /* DMA buffer. NULL if DMA is
+                                           not available */
+    pcie_block_copy_fp block_copy;      /* BAR2 block copy kernel */
 } llio_dev_pcie_t;
 
 static uint32_t pcie_timeout_patt [PCIE_TIMEOUT_PATT_SIZE];
@@ -66,8 +96,13 @@ static ssize_t _pcie_rw_bar4_block_raw (llio_t *self, uint32_t pg_start, uint64_
         uint32_t *data, uint32_t size, int rw);
 static ssize_t _pcie_rw_block (llio_t *self, uint64_t offs, size_t size,
         uint32_t *data, int rw);
+static ssize_t _pcie_rw_dma (llio_t *self, uint64_t offs, size_t size,
+        uint32_t *data, int dir);
+static ssize_t _pcie_dma_xfer (llio_dev_pcie_t *dev_pcie, uint64_t pa,
+        uint32_t size, int dir);
 static ssize_t _pcie_timeout_reset (llio_t *self);
 static ssize_t _pcie_reset_fpga (llio_t *self);
+static pcie_block_copy_fp _pcie_block_copy_select (uint8_t *bar2);
 
 /************ Our methods implementation **********/
 
@@ -108,6 +143,25 @@ static llio_dev_pcie_t * llio_dev_pcie_new (const char *dev_entry)
     self->bar4_size = pd_getBARsize (self->dev, BAR4NO);
     ASSERT_TEST(self->bar4_size > 0, "Could not get bar4 size", err_bar4_size);
 
+#ifdef __WITH_PCIE_DMA__
+    /* Allocate the pinned DMA buffer. This is not fatal, as we can still
+     * access the device through the BARs */
+    self->dma_buf = (uint32_t *) pd_allocKernelMemory (self->dev, PCIE_DMA_BUF_SIZE,
+            &self->dma_kmem);
+    if (self->dma_buf == NULL) {
+        DBE_DEBUG (DBG_LL_IO | DBG_LVL_WARN, "[ll_io_pcie] Could not allocate "
+                "DMA buffer. DMA transfers will not be available\n");
+    }
+#else
+    /* The DMA engine register map is not verified against the FPGA
+     * firmware yet (see hw/pcie_regs.h), so DMA is opt-in */
+    self->dma_buf = NULL;
+    DBE_DEBUG (DBG_LL_IO | DBG_LVL_INFO, "[ll_io_pcie] DMA support not "
+            "compiled in. DMA transfers will not be available\n");
+#endif
+
+    self->block_copy = _pcie_block_copy_select ((uint8_t *) self->bar2);
+
     /* Initialize PCIE timeout pattern */
     memset (&pcie_timeout_patt, PCIE_TIMEOUT_PATT_INIT, sizeof (pcie_timeout_patt));
     DBE_DEBUG (DBG_LL_IO | DBG_LVL_TRACE, "[ll_io_pcie] Created instance of llio_dev_pcie\n");
@@ -138,6 +192,10 @@ static llio_err_e llio_dev_pcie_destroy (llio_dev_pcie_t **self_p)
     if (*self_p) {
         llio_dev_pcie_t *self = *self_p;
 
+        if (self->dma_buf != NULL) {
+            pd_freeKernelMemory (&self->dma_kmem);
+        }
+
         /* Unmap all bars first and then destroy the remaining structures */
         pd_unmapBAR (self->dev, BAR4NO, self->bar4);
         pd_unmapBAR (self->dev, BAR2NO, self->bar2);
@@ -290,21 +348,14 @@ static ssize_t pcie_write_block (llio_t *self, uint64_t offs, size_t size, uint3
 /* Read data block from PCIe device, size in bytes */
 static ssize_t pcie_read_dma (llio_t *self, uint64_t offs, size_t size, uint32_t *data)
 {
-    (void) self;
-    (void) offs;
-    (void) size;
-    (void) data;
-    return -1;
+    return _pcie_rw_dma (self, offs, size, data, DMA_FROM_DEVICE);
 }
 
 /* Write data block from PCIe device, size in bytes */
 static ssize_t pcie_write_dma (llio_t *self, uint64_t offs, size_t size, uint32_t *data)
 {
-    (void) self;
-    (void) offs;
-    (void) size;
-    (void) data;
-    return -1;
+    /* _pcie_rw_dma with DMA_TO_DEVICE does not modify "data" */
+    return _pcie_rw_dma (self, offs, size, data, DMA_TO_DEVICE);
 }
 
 /* Read PCIe device information */
@@ -433,8 +484,8 @@ static ssize_t _pcie_rw_bar2_block_raw (llio_t *self, uint32_t pg_start, uint64_
                 "[ll_io_pcie:_pcie_rw_bar2_block_raw] Reading %u bytes from addr: %p\n"
                 "-------------------------------------------------------------------------------------\n",
                 num_bytes_page, dev_pcie->bar2);
-        BAR2_RW_BLOCK(dev_pcie->bar2, offs, num_bytes_page,
-                datap, rw);
+        dev_pcie->block_copy ((uint8_t *) dev_pcie->bar2 + offs, datap,
+                num_bytes_page, rw);
         datap = (uint32_t *)((uint8_t *)datap + num_bytes_page);
 
         /* Always 0 after the first page */
@@ -632,6 +683,366 @@ err_endp_open:
     return err;
 }
 
+/************ BAR block copy kernels **********/
+
+/* Reference kernel. Plain 32-bit accesses */
+static void _pcie_block_copy_32 (uint8_t *barp, uint32_t *data, uint32_t size,
+        int rw)
+{
+    BAR2_RW_BLOCK(barp, 0, size, data, rw);
+}
+
+/* Copy the unaligned head and tail with 32-bit accesses and the rest with
+ * "wide_copy", whose MMIO accesses must be "width"-aligned */
+static void _pcie_block_copy_wide (uint8_t *barp, uint32_t *data, uint32_t size,
+        int rw, uint32_t width, pcie_block_copy_fp wide_copy)
+{
+    uint32_t head = (-(uintptr_t) barp) & (width-1);
+    if (head > size) {
+        head = size;
+    }
+    uint32_t body = (size - head) & ~(width-1);
+    uint32_t tail = size - head - body;
+
+    _pcie_block_copy_32 (barp, data, head, rw);
+    wide_copy (barp + head, (uint32_t *)((uint8_t *) data + head), body, rw);
+    _pcie_block_copy_32 (barp + head + body,
+            (uint32_t *)((uint8_t *) data + head + body), tail, rw);
+}
+
+static void _pcie_block_copy_64_aligned (uint8_t *barp, uint32_t *data,
+        uint32_t size, int rw)
+{
+    BAR_RW_64_BLOCK(barp, 0, size, data, rw);
+}
+
+static void _pcie_block_copy_64 (uint8_t *barp, uint32_t *data, uint32_t size,
+        int rw)
+{
+    _pcie_block_copy_wide (barp, data, size, rw, sizeof (BAR_RW_64_TYPE),
+            _pcie_block_copy_64_aligned);
+}
+
+#ifdef PCIE_BLOCK_COPY_X86
+/* Streaming loads from the device and streaming stores to it, so we do not
+ * pollute the caches with data we only pass through. Host memory needs no
+ * particular alignment */
+__attribute__((target("sse4.1")))
+static void _pcie_block_copy_sse_aligned (uint8_t *barp, uint32_t *data,
+        uint32_t size, int rw)
+{
+    __m128i *mmiop = (__m128i *) barp;
+    __m128i *datap = (__m128i *) data;
+
+    if (rw) {
+        for (uint32_t j = 0; j < size/sizeof (__m128i); ++j) {
+            _mm_storeu_si128 (datap + j, _mm_stream_load_si128 (mmiop + j));
+        }
+    }
+    else {
+        for (uint32_t j = 0; j < size/sizeof (__m128i); ++j) {
+            _mm_stream_si128 (mmiop + j, _mm_loadu_si128 (datap + j));
+        }
+        _mm_sfence ();
+    }
+}
+
+static void _pcie_block_copy_sse (uint8_t *barp, uint32_t *data, uint32_t size,
+        int rw)
+{
+    _pcie_block_copy_wide (barp, data, size, rw, sizeof (__m128i),
+            _pcie_block_copy_sse_aligned);
+}
+
+__attribute__((target("avx2")))
+static void _pcie_block_copy_avx_aligned (uint8_t *barp, uint32_t *data,
+        uint32_t size, int rw)
+{
+    __m256i *mmiop = (__m256i *) barp;
+    __m256i *datap = (__m256i *) data;
+
+    if (rw) {
+        for (uint32_t j = 0; j < size/sizeof (__m256i); ++j) {
+            _mm256_storeu_si256 (datap + j, _mm256_stream_load_si256 (mmiop + j));
+        }
+    }
+    else {
+        for (uint32_t j = 0; j < size/sizeof (__m256i); ++j) {
+            _mm256_stream_si256 (mmiop + j, _mm256_loadu_si256 (datap + j));
+        }
+        _mm_sfence ();
+    }
+}
+
+static void _pcie_block_copy_avx (uint8_t *barp, uint32_t *data, uint32_t size,
+        int rw)
+{
+    _pcie_block_copy_wide (barp, data, size, rw, sizeof (__m256i),
+            _pcie_block_copy_avx_aligned);
+}
+#endif
+
+/* Check that "block_copy" moves exactly the same bytes as the 32-bit
+ * kernel, for every 32-bit misalignment and size up to the check limits.
+ * Both directions are checked against host memory. Reads are also
+ * checked against BAR2, as some firmwares do not answer wide requests
+ * the same way. Writes are never issued to the device here */
+static bool _pcie_block_copy_check (pcie_block_copy_fp block_copy, uint8_t *bar2)
+{
+    /* Extra room for the misalignment and for a guard word at the end */
+    enum { CHECK_BUF_SIZE = PCIE_BLOCK_COPY_CHECK_SIZE +
+        PCIE_BLOCK_COPY_CHECK_MISALIGN + sizeof (uint32_t) };
+    uint32_t src [CHECK_BUF_SIZE/sizeof (uint32_t)];
+    uint32_t ref [CHECK_BUF_SIZE/sizeof (uint32_t)];
+    uint32_t out [CHECK_BUF_SIZE/sizeof (uint32_t)];
+    uint32_t i;
+
+    for (i = 0; i < sizeof (src)/sizeof (src [0]); ++i) {
+        src [i] = 0xA5000000 | (i * 0x00010203);
+    }
+
+    uint32_t misalign;
+    uint32_t size;
+    for (misalign = 0; misalign < PCIE_BLOCK_COPY_CHECK_MISALIGN;
+            misalign += sizeof (uint32_t)) {
+        for (size = 0; size <= PCIE_BLOCK_COPY_CHECK_SIZE; size += sizeof (uint32_t)) {
+            /* "Device" to host */
+            memset (ref, 0, sizeof (ref));
+            memset (out, 0, sizeof (out));
+            _pcie_block_copy_32 ((uint8_t *) src + misalign, ref, size, READ_FROM_BAR);
+            block_copy ((uint8_t *) src + misalign, out, size, READ_FROM_BAR);
+            if (memcmp (ref, out, sizeof (ref)) != 0) {
+                return false;
+            }
+
+            /* Host to "device" */
+            memset (ref, 0, sizeof (ref));
+            memset (out, 0, sizeof (out));
+            _pcie_block_copy_32 ((uint8_t *) ref + misalign, src, size, WRITE_TO_BAR);
+            block_copy ((uint8_t *) out + misalign, src, size, WRITE_TO_BAR);
+            if (memcmp (ref, out, sizeof (ref)) != 0) {
+                return false;
+            }
+
+            /* Device to host */
+            if (bar2 != NULL) {
+                memset (ref, 0, sizeof (ref));
+                memset (out, 0, sizeof (out));
+                _pcie_block_copy_32 (bar2 + misalign, ref, size, READ_FROM_BAR);
+                block_copy (bar2 + misalign, out, size, READ_FROM_BAR);
+                if (memcmp (ref, out, sizeof (ref)) != 0) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/* Select the widest kernel available in this CPU, up to PCIE_BLOCK_COPY,
+ * that passes _pcie_block_copy_check (). The 32-bit kernel is the
+ * reference, so it is always available */
+static pcie_block_copy_fp _pcie_block_copy_select (uint8_t *bar2)
+{
+    struct {
+        int type;
+        bool supported;
+        pcie_block_copy_fp block_copy;
+        const char *name;
+    } kernels [] = {
+#ifdef PCIE_BLOCK_COPY_X86
+        {PCIE_BLOCK_COPY_AVX, false, _pcie_block_copy_avx, "AVX2"},
+        {PCIE_BLOCK_COPY_SSE, false, _pcie_block_copy_sse, "SSE4.1"},
+#endif
+        {PCIE_BLOCK_COPY_64, true, _pcie_block_copy_64, "64-bit"},
+    };
+
+#ifdef PCIE_BLOCK_COPY_X86
+    __builtin_cpu_init ();
+    kernels [0].supported = __builtin_cpu_supports ("avx2");
+    kernels [1].supported = __builtin_cpu_supports ("sse4.1");
+#endif
+
+    pcie_block_copy_fp block_copy = _pcie_block_copy_32;
+    const char *block_copy_name = "32-bit";
+
+    unsigned int i;
+    for (i = 0; i < sizeof (kernels)/sizeof (kernels [0]); ++i) {
+        if (kernels [i].type > PCIE_BLOCK_COPY || !kernels [i].supported) {
+            continue;
+        }
+
+        if (!_pcie_block_copy_check (kernels [i].block_copy, bar2)) {
+            DBE_DEBUG (DBG_LL_IO | DBG_LVL_WARN, "[ll_io_pcie] %s BAR block "
+                    "copy kernel does not match the 32-bit one. Not using it\n",
+                    kernels [i].name);
+            continue;
+        }
+
+        block_copy = kernels [i].block_copy;
+        block_copy_name = kernels [i].name;
+        break;
+    }
+
+    DBE_DEBUG (DBG_LL_IO | DBG_LVL_INFO, "[ll_io_pcie] Using %s BAR block "
+            "copy kernel\n", block_copy_name);
+    return block_copy;
+}
+
+/* DMA transfers between the FPGA SDRAM (BAR2 address space) and host memory,
+ * bouncing through the pinned DMA buffer. Only one descriptor is used per
+ * chunk, so there is no need for a descriptor chain in host memory */
+static ssize_t _pcie_rw_dma (llio_t *self, uint64_t offs, size_t size,
+        uint32_t *data, int dir)
+{
+    assert (self);
+    ssize_t err = -1;
+    ASSERT_TEST(llio_get_endpoint_open (self), "Could not perform DMA operation. Device is not opened",
+            err_endp_open, -1);
+
+    llio_dev_pcie_t *dev_pcie = llio_get_dev_handler (self);
+    ASSERT_TEST(dev_pcie != NULL, "Could not get PCIe handler",
+            err_dev_pcie_handler, -1);
+    ASSERT_TEST(dev_pcie->dma_buf != NULL, "DMA is not available",
+            err_dma_buf, -1);
+    ASSERT_TEST(PCIE_ADDR_BAR (offs) == BAR2NO, "DMA is only available for BAR2",
+            err_dma_bar, -1);
+    ASSERT_TEST(size % sizeof (uint32_t) == 0, "DMA size must be a multiple of 32-bit",
+            err_dma_size, -1);
+
+    uint64_t pa = PCIE_ADDR_GEN (offs);
+    size_t num_bytes_rem = size;
+    uint8_t *datap = (uint8_t *) data;
+
+    DBE_DEBUG (DBG_LL_IO | DBG_LVL_TRACE,
+            "[ll_io_pcie:_pcie_rw_dma] %s %zu bytes, peripheral address = 0x%"PRIX64"\n",
+            (dir == DMA_FROM_DEVICE) ? "Reading" : "Writing", size, pa);
+
+    while (num_bytes_rem > 0) {
+        uint32_t num_bytes_chunk = (num_bytes_rem > PCIE_DMA_BUF_SIZE) ?
+            PCIE_DMA_BUF_SIZE : num_bytes_rem;
+
+        if (dir == DMA_TO_DEVICE) {
+            memcpy (dev_pcie->dma_buf, datap, num_bytes_chunk);
+            pd_syncKernelMemory (&dev_pcie->dma_kmem, PD_DIR_TODEVICE);
+        }
+
+        ssize_t num_bytes_xfer = _pcie_dma_xfer (dev_pcie, pa, num_bytes_chunk, dir);
+        ASSERT_TEST(num_bytes_xfer == num_bytes_chunk, "DMA transfer failed",
+                err_dma_xfer, -1);
+
+        if (dir == DMA_FROM_DEVICE) {
+            pd_syncKernelMemory (&dev_pcie->dma_kmem, PD_DIR_FROMDEVICE);
+            memcpy (datap, dev_pcie->dma_buf, num_bytes_chunk);
+        }
+
+        datap += num_bytes_chunk;
+        pa += num_bytes_chunk;
+        num_bytes_rem -= num_bytes_chunk;
+    }
+
+    err = size;
+
+err_dma_xfer:
+err_dma_size:
+err_dma_bar:
+err_dma_buf:
+err_dev_pcie_handler:
+err_endp_open:
+    return err;
+}
+
+/* Program a single DMA descriptor on the upstream (FPGA to host) or the
+ * downstream (host to FPGA) channel and wait for its completion. The
+ * channel is reset before being armed, so a DONE flag or a byte count
+ * left by a previous transfer is not mistaken for this one */
+static ssize_t _pcie_dma_xfer (llio_dev_pcie_t *dev_pcie, uint64_t pa,
+        uint32_t size, int dir)
+{
+    uint32_t *bar0 = dev_pcie->bar0;
+    /* Downstream channel registers are located right after the upstream
+     * ones and have the same layout */
+    uint64_t ch_offs = (dir == DMA_FROM_DEVICE) ? 0 :
+        (PCIE_CFG_REG_DMA_DS_PAH - PCIE_CFG_REG_DMA_US_PAH);
+    uint64_t bc_reg = (dir == DMA_FROM_DEVICE) ? PCIE_CFG_REG_US_TRANSF_BC :
+        PCIE_CFG_REG_DS_TRANSF_BC;
+    uint64_t ha = dev_pcie->dma_kmem.pa;
+    uint32_t data;
+
+    /* Never touch a channel in the middle of a transfer */
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_STA + ch_offs, &data, READ_FROM_BAR);
+    if (data & PCIE_CFG_DMA_STA_BUSY) {
+        DBE_DEBUG (DBG_LL_IO | DBG_LVL_ERR,
+                "[ll_io_pcie:_pcie_dma_xfer] DMA channel is busy. "
+                "Status = 0x%08X\n", data);
+        return -1;
+    }
+
+    /* Acknowledge any previous completion */
+    data = PCIE_CFG_DMA_CTRL_CHANNEL_RST;
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_CTRL + ch_offs, &data, WRITE_TO_BAR);
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_STA + ch_offs, &data, READ_FROM_BAR);
+    if (data & (PCIE_CFG_DMA_STA_DONE | PCIE_CFG_DMA_STA_BUSY)) {
+        DBE_DEBUG (DBG_LL_IO | DBG_LVL_ERR,
+                "[ll_io_pcie:_pcie_dma_xfer] Could not clear DMA channel "
+                "status. Status = 0x%08X\n", data);
+        return -1;
+    }
+
+    data = pa >> 32;
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_PAH + ch_offs, &data, WRITE_TO_BAR);
+    data = pa & 0xFFFFFFFF;
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_PAL + ch_offs, &data, WRITE_TO_BAR);
+    data = ha >> 32;
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_HAH + ch_offs, &data, WRITE_TO_BAR);
+    data = ha & 0xFFFFFFFF;
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_HAL + ch_offs, &data, WRITE_TO_BAR);
+    /* Single descriptor. No next descriptor address */
+    data = 0;
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_BDAH + ch_offs, &data, WRITE_TO_BAR);
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_BDAL + ch_offs, &data, WRITE_TO_BAR);
+    data = size;
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_LENG + ch_offs, &data, WRITE_TO_BAR);
+    /* This starts the transfer */
+    data = PCIE_CFG_DMA_CTRL_VALID | PCIE_CFG_DMA_CTRL_LAST |
+        PCIE_CFG_DMA_CTRL_UPA | PCIE_CFG_DMA_CTRL_AINC |
+        PCIE_CFG_DMA_CTRL_BAR(BAR2NO);
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_CTRL + ch_offs, &data, WRITE_TO_BAR);
+
+    uint32_t i;
+    for (i = 0; i < PCIE_DMA_TIMEOUT_MAX_TRIES; ++i) {
+        BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_STA + ch_offs, &data, READ_FROM_BAR);
+        if (data & PCIE_CFG_DMA_STA_DONE) {
+            break;
+        }
+        usleep (PCIE_DMA_TIMEOUT_WAIT);
+    }
+
+    if (i >= PCIE_DMA_TIMEOUT_MAX_TRIES || (data & PCIE_CFG_DMA_STA_TIMEOUT)) {
+        DBE_DEBUG (DBG_LL_IO | DBG_LVL_ERR,
+                "[ll_io_pcie:_pcie_dma_xfer] DMA transfer did not complete. "
+                "Resetting channel\n");
+        goto err_xfer;
+    }
+
+    /* DONE alone does not mean the whole descriptor was moved */
+    BAR0_RW(bar0, bc_reg, &data, READ_FROM_BAR);
+    if (data != size) {
+        DBE_DEBUG (DBG_LL_IO | DBG_LVL_ERR,
+                "[ll_io_pcie:_pcie_dma_xfer] DMA transferred %u bytes out of %u. "
+                "Resetting channel\n", data, size);
+        goto err_xfer;
+    }
+
+    return size;
+
+err_xfer:
+    data = PCIE_CFG_DMA_CTRL_CHANNEL_RST;
+    BAR0_RW(bar0, PCIE_CFG_REG_DMA_US_CTRL + ch_offs, &data, WRITE_TO_BAR);
+    return -1;
+}
+
 static ssize_t _pcie_timeout_reset (llio_t *self)
 {
     DBE_DEBUG (DBG_LL_IO | DBG_LVL_TRACE,
@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2014 LNLS (www.lnls.br)
+ * Author: Lucas Russo <lucas.russo@lnls.br>
+ *
+ * Released according to the GNU GPL, version 3 or any later version.
+ */
+
+#include "ll_io.h"
+
+#include <sys/mman.h>
+#include <time.h>
+
+/* Same address layout as the PCIe device */
+#include "hw/pcie_regs.h"
+
+/* Undef ASSERT_ALLOC to avoid conflicting with other ASSERT_ALLOC */
+#ifdef ASSERT_TEST
+#undef ASSERT_TEST
+#endif
+#define ASSERT_TEST(test_boolean, err_str, err_goto_label, /* err_core */ ...) \
+    ASSERT_HAL_TEST(test_boolean, LL_IO, "[ll_io:sim]",     \
+            err_str, err_goto_label, /* err_core */ __VA_ARGS__)
+
+#ifdef ASSERT_ALLOC
+#undef ASSERT_ALLOC
+#endif
+#define ASSERT_ALLOC(ptr, err_goto_label, /* err_core */ ...) \
+    ASSERT_HAL_ALLOC(ptr, LL_IO, "[ll_io:sim]",             \
+            llio_err_str(LLIO_ERR_ALLOC),                   \
+            err_goto_label, /* err_core */ __VA_ARGS__)
+
+#ifdef CHECK_ERR
+#undef CHECK_ERR
+#endif
+#define CHECK_ERR(err, err_type)                            \
+    CHECK_HAL_ERR(err, LL_IO, "[ll_io:sim]",                \
+            llio_err_str (err_type))
+
+#define SIM_NSECS_PER_SEC                       1000000000ULL
+/* ns per byte at 1 MB/s */
+#define SIM_NSECS_PER_BYTE_MBPS                 1000ULL
+
+/* Register with side effects */
+typedef struct {
+    uint64_t offs;                      /* Register address */
+    llio_sim_write_hook_fp hook;        /* Called after writes */
+    void *hook_arg;                     /* Passed back to hook */
+} llio_sim_hook_t;
+
+/* Device endpoint */
+typedef struct {
+    uint8_t *bar0;                      /* Simulated BAR0 */
+    uint8_t *bar2;                      /* Simulated BAR2 */
+    uint8_t *bar4;                      /* Simulated BAR4 */
+    uint64_t latency_ns;                /* Cost of every access */
+    uint64_t throughput_mbps;           /* Block access throughput.
+                                           0 means unlimited */
+    llio_sim_hook_t hooks [LLIO_SIM_MAX_HOOKS];
+    unsigned int num_hooks;
+} llio_dev_sim_t;
+
+static uint8_t *_sim_map_bar (uint64_t size);
+static uint8_t *_sim_addr (llio_dev_sim_t *dev_sim, uint64_t offs, size_t size);
+static void _sim_delay (llio_dev_sim_t *dev_sim, size_t size);
+static void _sim_run_hooks (llio_t *self, llio_dev_sim_t *dev_sim,
+        uint64_t offs, size_t size);
+static ssize_t _sim_rw (llio_t *self, uint64_t offs, size_t size, void *data,
+        bool block, bool read);
+
+/************ Our methods implementation **********/
+
+/* Creates a new instance of the dev_sim */
+static llio_dev_sim_t * llio_dev_sim_new (const char *dev_entry)
+{
+    llio_dev_sim_t *self = (llio_dev_sim_t *) zmalloc (sizeof *self);
+    ASSERT_ALLOC (self, err_llio_dev_sim_alloc);
+
+    ASSERT_TEST(dev_entry != NULL && strncmp (dev_entry, LLIO_SIM_ENDPOINT_PREFIX,
+                strlen (LLIO_SIM_ENDPOINT_PREFIX)) == 0,
+            "Invalid simulated endpoint name", err_dev_entry);
+
+    unsigned long long latency_ns = 0;
+    unsigned long long throughput_mbps = 0;
+    sscanf (dev_entry, LLIO_SIM_ENDPOINT_PREFIX ":%llu:%llu", &latency_ns,
+            &throughput_mbps);
+    self->latency_ns = latency_ns;
+    self->throughput_mbps = throughput_mbps;
+
+    /* Pages are only backed by memory when first written to, so mapping
+     * the whole DDR3 costs nothing */
+    self->bar0 = _sim_map_bar (LLIO_SIM_BAR0_SIZE);
+    ASSERT_TEST(self->bar0 != NULL, "Could not allocate bar0", err_bar0_alloc);
+    self->bar2 = _sim_map_bar (LLIO_SIM_BAR2_SIZE);
+    ASSERT_TEST(self->bar2 != NULL, "Could not allocate bar2", err_bar2_alloc);
+    self->bar4 = _sim_map_bar (LLIO_SIM_BAR4_SIZE);
+    ASSERT_TEST(self->bar4 != NULL, "Could not allocate bar4", err_bar4_alloc);
+
+    DBE_DEBUG (DBG_LL_IO | DBG_LVL_TRACE, "[ll_io_sim] Created instance of llio_dev_sim. "
+            "Latency = %"PRIu64" ns, throughput = %"PRIu64" MB/s\n",
+            self->latency_ns, self->throughput_mbps);
+
+    return self;
+
+err_bar4_alloc:
+    munmap (self->bar2, LLIO_SIM_BAR2_SIZE);
+err_bar2_alloc:
+    munmap (self->bar0, LLIO_SIM_BAR0_SIZE);
+err_bar0_alloc:
+err_dev_entry:
+    free (self);
+err_llio_dev_sim_alloc:
+    return NULL;
+}
+
+/* Destroy an instance of the Endpoint */
+static llio_err_e llio_dev_sim_destroy (llio_dev_sim_t **self_p)
+{
+    if (*self_p) {
+        llio_dev_sim_t *self = *self_p;
+
+        munmap (self->bar4, LLIO_SIM_BAR4_SIZE);
+        munmap (self->bar2, LLIO_SIM_BAR2_SIZE);
+        munmap (self->bar0, LLIO_SIM_BAR0_SIZE);
+        free (self);
+
+        *self_p = NULL;
+    }
+
+    return LLIO_SUCCESS;
+}
+
+llio_err_e llio_sim_set_write_hook (llio_t *self, uint64_t offs,
+        llio_sim_write_hook_fp hook, void *hook_arg)
+{
+    assert (self);
+
+    llio_err_e err = LLIO_SUCCESS;
+    llio_dev_sim_t *dev_sim = llio_get_dev_handler (self);
+    ASSERT_TEST(dev_sim != NULL, "Could not get SIM handler",
+            err_dev_sim_handler, LLIO_ERR_INV_FUNC_PARAM);
+
+    unsigned int i;
+    for (i = 0; i < dev_sim->num_hooks; ++i) {
+        if (dev_sim->hooks [i].offs == offs) {
+            break;
+        }
+    }
+
+    if (hook == NULL) {
+        /* Remove it, if present */
+        if (i < dev_sim->num_hooks) {
+            dev_sim->hooks [i] = dev_sim->hooks [--dev_sim->num_hooks];
+        }
+        goto err_dev_sim_handler;
+    }
+
+    ASSERT_TEST(i < LLIO_SIM_MAX_HOOKS, "Too many simulated register hooks",
+            err_dev_sim_handler, LLIO_ERR_ALLOC);
+
+    dev_sim->hooks [i].offs = offs;
+    dev_sim->hooks [i].hook = hook;
+    dev_sim->hooks [i].hook_arg = hook_arg;
+    if (i == dev_sim->num_hooks) {
+        dev_sim->num_hooks++;
+    }
+
+err_dev_sim_handler:
+    return err;
+}
+
+llio_err_e llio_sim_load (llio_t *self, uint64_t offs, const void *data,
+        size_t size)
+{
+    assert (self);
+    assert (data);
+
+    llio_err_e err = LLIO_SUCCESS;
+    llio_dev_sim_t *dev_sim = llio_get_dev_handler (self);
+    ASSERT_TEST(dev_sim != NULL, "Could not get SIM handler",
+            err_dev_sim_handler, LLIO_ERR_INV_FUNC_PARAM);
+
+    uint8_t *addr = _sim_addr (dev_sim, offs, size);
+    ASSERT_TEST(addr != NULL, "Address out of the simulated device range",
+            err_dev_sim_handler, LLIO_ERR_INV_FUNC_PARAM);
+
+    memcpy (addr, data, size);
+
+err_dev_sim_handler:
+    return err;
+}
+
+llio_err_e llio_sim_peek_32 (llio_t *self, uint64_t offs, uint32_t *data)
+{
+    assert (self);
+    assert (data);
+
+    llio_err_e err = LLIO_SUCCESS;
+    llio_dev_sim_t *dev_sim = llio_get_dev_handler (self);
+    ASSERT_TEST(dev_sim != NULL, "Could not get SIM handler",
+            err_dev_sim_handler, LLIO_ERR_INV_FUNC_PARAM);
+
+    uint8_t *addr = _sim_addr (dev_sim, offs, sizeof (*data));
+    ASSERT_TEST(addr != NULL, "Address out of the simulated device range",
+            err_dev_sim_handler, LLIO_ERR_INV_FUNC_PARAM);
+
+    memcpy (data, addr, sizeof (*data));
+
+err_dev_sim_handler:
+    return err;
+}
+
+llio_err_e llio_sim_poke_32 (llio_t *self, uint64_t offs, uint32_t data)
+{
+    return llio_sim_load (self, offs, &data, sizeof (data));
+}
+
+/************ llio_ops_sim Implementation **********/
+
+/* Open simulated device */
+static int sim_open (llio_t *self, llio_endpoint_t *endpoint)
+{
+    if (llio_get_endpoint_open (self)) {
+        /* Device is already opened. So, we return success */
+        return 0;
+    }
+
+    llio_err_e lerr = LLIO_SUCCESS;
+    int err = 0;
+    if (endpoint != NULL) {
+        lerr = llio_set_endpoint (self, endpoint);
+        ASSERT_TEST(lerr == LLIO_SUCCESS, "Could not set endpoint on simulated device",
+                err_endpoint_set, -1);
+    }
+
+    /* Create new private simulated handler */
+    llio_dev_sim_t *dev_sim = llio_dev_sim_new (llio_get_endpoint_name (self));
+    ASSERT_TEST(dev_sim != NULL, "Could not allocate dev_handler",
+            err_dev_handler_alloc, -1);
+
+    /* Attach this simulated device to LLIO instance */
+    llio_set_dev_handler (self, dev_sim);
+
+    /* Signal that the endpoint is opened and ready to work */
+    llio_set_endpoint_open (self, true);
+    DBE_DEBUG (DBG_LL_IO | DBG_LVL_INFO,
+            "[ll_io_sim] Opened simulated device %s\n",
+            llio_get_endpoint_name (self));
+
+    /* SDB lives in the Wishbone BAR, as in the PCIe device */
+    llio_set_sdb_prefix_addr (self, BAR4_ADDR);
+
+    return err;
+
+err_dev_handler_alloc:
+err_endpoint_set:
+    return err;
+}
+
+/* Release simulated device */
+static int sim_release (llio_t *self, llio_endpoint_t *endpoint)
+{
+    (void) endpoint;
+
+    if (!llio_get_endpoint_open (self)) {
+        /* Nothing to close */
+        return 0;
+    }
+
+    int err = 0;
+    llio_dev_sim_t *dev_sim = llio_get_dev_handler (self);
+    ASSERT_TEST(dev_sim != NULL, "Could not get SIM handler",
+            err_dev_sim_handler, -1);
+
+    llio_dev_sim_destroy (&dev_sim);
+    llio_set_dev_handler (self, NULL);
+    llio_set_endpoint_open (self, false);
+
+    DBE_DEBUG (DBG_LL_IO | DBG_LVL_INFO,
+            "[ll_io_sim] Closed simulated device %s\n",
+            llio_get_endpoint_name (self));
+
+err_dev_sim_handler:
+    return err;
+}
+
+/* Read data from simulated device */
+static ssize_t sim_read_32 (llio_t *self, uint64_t offs, uint32_t *data)
+{
+    return _sim_rw (self, offs, sizeof (*data), data, false, true);
+}
+
+static ssize_t sim_read_64 (llio_t *self, uint64_t offs, uint64_t *data)
+{
+    return _sim_rw (self, offs, sizeof (*data), data, false, true);
+}
+
+/* Write data to simulated device */
+static ssize_t sim_write_32 (llio_t *self, uint64_t offs, const uint32_t *data)
+{
+    /* _sim_rw does not modify "data" on writes */
+    return _sim_rw (self, offs, sizeof (*data), (uint32_t *) data, false, false);
+}
+
+static ssize_t sim_write_64 (llio_t *self, uint64_t offs, const uint64_t *data)
+{
+    return _sim_rw (self, offs, sizeof (*data), (uint64_t *) data, false, false);
+}
+
+/* Read data block from simulated device, size in bytes */
+static ssize_t sim_read_block (llio_t *self, uint64_t offs, size_t size, uint32_t *data)
+{
+    return _sim_rw (self, offs, size, data, true, true);
+}
+
+/* Write data block to simulated device, size in bytes */
+static ssize_t sim_write_block (llio_t *self, uint64_t offs, size_t size, uint32_t *data)
+{
+    return _sim_rw (self, offs, size, data, true, false);
+}
+
+/************ Helper functions **********/
+
+static uint8_t *_sim_map_bar (uint64_t size)
+{
+    void *bar = mmap (NULL, size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return (bar == MAP_FAILED)? NULL : (uint8_t *) bar;
+}
+
+static uint8_t *_sim_addr (llio_dev_sim_t *dev_sim, uint64_t offs, size_t size)
+{
+    uint64_t bar_no = PCIE_ADDR_BAR (offs);
+    uint64_t full_offs = PCIE_ADDR_GEN (offs);
+    uint8_t *bar = NULL;
+    uint64_t bar_size = 0;
+
+    switch (bar_no) {
+        case BAR0NO:
+            bar = dev_sim->bar0;
+            bar_size = LLIO_SIM_BAR0_SIZE;
+            break;
+
+        case BAR2NO:
+            bar = dev_sim->bar2;
+            bar_size = LLIO_SIM_BAR2_SIZE;
+            break;
+
+        case BAR4NO:
+            bar = dev_sim->bar4;
+            bar_size = LLIO_SIM_BAR4_SIZE;
+            break;
+
+        default:
+            return NULL;
+    }
+
+    if (full_offs > bar_size || size > bar_size - full_offs) {
+        return NULL;
+    }
+
+    return bar + full_offs;
+}
+
+/* Busy-wait, as sleeping is far too coarse for bus latencies */
+static void _sim_delay (llio_dev_sim_t *dev_sim, size_t size)
+{
+    uint64_t delay_ns = dev_sim->latency_ns;
+    if (dev_sim->throughput_mbps != 0) {
+        delay_ns += size * SIM_NSECS_PER_BYTE_MBPS / dev_sim->throughput_mbps;
+    }
+
+    if (delay_ns == 0) {
+        return;
+    }
+
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    uint64_t deadline = (uint64_t) now.tv_sec * SIM_NSECS_PER_SEC + now.tv_nsec + delay_ns;
+
+    do {
+        clock_gettime (CLOCK_MONOTONIC, &now);
+    } while ((uint64_t) now.tv_sec * SIM_NSECS_PER_SEC + now.tv_nsec < deadline);
+}
+
+static void _sim_run_hooks (llio_t *self, llio_dev_sim_t *dev_sim,
+        uint64_t offs, size_t size)
+{
+    unsigned int i;
+    for (i = 0; i < dev_sim->num_hooks; ++i) {
+        llio_sim_hook_t *hook = &dev_sim->hooks [i];
+        if (hook->offs < offs || hook->offs >= offs + size) {
+            continue;
+        }
+
+        uint32_t data = 0;
+        memcpy (&data, _sim_addr (dev_sim, hook->offs, sizeof (data)), sizeof (data));
+        hook->hook (self, hook->offs, data, hook->hook_arg);
+    }
+}
+
+static ssize_t _sim_rw (llio_t *self, uint64_t offs, size_t size, void *data,
+        bool block, bool read)
+{
+    assert (self);
+    ssize_t err = size;
+    ASSERT_TEST(llio_get_endpoint_open (self), "Could not perform RW operation. Device is not opened",
+            err_endp_open, -1);
+
+    llio_dev_sim_t *dev_sim = llio_get_dev_handler (self);
+    ASSERT_TEST(dev_sim != NULL, "Could not get SIM handler",
+            err_dev_sim_handler, -1);
+
+    uint8_t *addr = _sim_addr (dev_sim, offs, size);
+    ASSERT_TEST(addr != NULL, "Address out of the simulated device range",
+            err_addr, -1);
+
+    _sim_delay (dev_sim, block? size : 0);
+
+    if (read) {
+        memcpy (data, addr, size);
+    }
+    else {
+        memcpy (addr, data, size);
+        _sim_run_hooks (self, dev_sim, offs, size);
+    }
+
+err_addr:
+err_dev_sim_handler:
+err_endp_open:
+    return err;
+}
+
+const llio_ops_t llio_ops_sim = {
+    .name           = "SIM",            /* Operations name */
+    .open           = sim_open,         /* Open device */
+    .release        = sim_release,      /* Release device */
+    .read_16        = NULL,             /* Read 16-bit data */
+    .read_32        = sim_read_32,      /* Read 32-bit data */
+    .read_64        = sim_read_64,      /* Read 64-bit data */
+    .write_16       = NULL,             /* Write 16-bit data */
+    .write_32       = sim_write_32,     /* Write 32-bit data */
+    .write_64       = sim_write_64,     /* Write 64-bit data */
+    .read_block     = sim_read_block,   /* Read arbitrary block size data,
+                                           parameter size in bytes */
+    .write_block    = sim_write_block,  /* Write arbitrary block size data,
+                                           parameter size in bytes */
+    .read_dma       = sim_read_block,   /* Read arbitrary block size data via DMA,
+                                            parameter size in bytes */
+    .write_dma      = sim_write_block   /* Write arbitrary block size data via DMA,
+                                            parameter size in bytes */
+};
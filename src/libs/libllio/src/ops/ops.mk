@@ -2,4 +2,5 @@ ll_io_ops_DIR = $(SRC_DIR)/ops
 
 ll_io_ops_OBJS = $(ll_io_ops_DIR)/ll_io_pcie.o \
 		 $(ll_io_ops_DIR)/ll_io_eth.o \
-		 $(ll_io_ops_DIR)/ll_io_eth_utils.o
+		 $(ll_io_ops_DIR)/ll_io_eth_utils.o \
+		 $(ll_io_ops_DIR)/ll_io_sim.o
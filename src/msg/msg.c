@@ -32,6 +32,10 @@
     CHECK_HAL_ERR(err, MSG, "[msg]",                                \
             msg_err_str (err_type))
 
+/* Replies at least this big are sent without copying the return buffer.
+ * Smaller ones are cheaper to copy than to track */
+#define MSG_ZERO_COPY_MIN_SIZE                  4096
+
 static msg_type_e _msg_guess_type (void *msg);
 static msg_err_e _msg_validate (void *msg, msg_type_e expected_msg_type);
 static msg_err_e _msg_exp_zmq_get_opcode (exp_msg_zmq_t *msg, uint32_t *opcode);
@@ -49,6 +53,9 @@ static void _msg_send_client_response_mlm (RW_REPLY_TYPE reply_code, uint32_t re
         zframe_t *reply_to);
 static void _msg_send_client_response_sock (RW_REPLY_TYPE reply_code, uint32_t reply_size,
         uint32_t *data_out, bool with_data_frame, zframe_t *reply_to);
+static int _msg_send_client_response_sock_zero_copy (RW_REPLY_TYPE reply_code,
+        uint32_t reply_size, disp_table_t *disp_table, uint32_t opcode,
+        void *reply_to);
 
 msg_type_e msg_guess_type (void *msg)
 {
@@ -144,7 +151,14 @@ msg_err_e msg_handle_sock_request (void *owner, void *args,
     ASSERT_TEST(err == MSG_SUCCESS, "Could not format client response",
             err_format_response);
 
-    /* Send response back to client */
+    /* Send response back to client. Big replies, such as data blocks, are
+     * handed to ZMQ without being copied */
+    if (with_data_frame && disp_table_ret >= MSG_ZERO_COPY_MIN_SIZE &&
+            _msg_send_client_response_sock_zero_copy (reply_code, disp_table_ret,
+                disp_table, opcode_data, msg->reply_to) == 0) {
+        return err;
+    }
+
     _msg_send_client_response_sock (reply_code, disp_table_ret, ret, with_data_frame,
            msg->reply_to);
 
@@ -343,7 +357,10 @@ static void _msg_send_client_response_mlm (RW_REPLY_TYPE reply_code, uint32_t re
     ASSERT_TEST(msg != NULL, "Could format client message",
             err_fmt_client_message);
 
-    mlm_client_sendto (worker, mlm_client_sender (worker), NULL, NULL, 0, &msg);
+    /* Echo the request subject, so clients with several requests in
+     * flight can match replies to them */
+    mlm_client_sendto (worker, mlm_client_sender (worker),
+            mlm_client_subject (worker), NULL, 0, &msg);
 err_fmt_client_message:
     return;
 }
@@ -361,6 +378,56 @@ err_fmt_client_message:
     return;
 }
 
+/* Returns 0 if the message was sent, or -1 if nothing was sent and the caller
+ * must fall back to the regular path */
+static int _msg_send_client_response_sock_zero_copy (RW_REPLY_TYPE reply_code,
+        uint32_t reply_size, disp_table_t *disp_table, uint32_t opcode,
+        void *reply_to)
+{
+    void *hint = NULL;
+    /* Take the return buffer from the dispatch table, so the next call
+     * won't overwrite it while ZMQ still holds it */
+    void *data_out = disp_table_lend_ret (disp_table, opcode, &hint);
+    if (data_out == NULL) {
+        return -1;
+    }
+
+    zmq_msg_t data_msg;
+    int zerr = zmq_msg_init_data (&data_msg, data_out, reply_size,
+            disp_op_handler_release_ret, hint);
+    ASSERT_TEST(zerr == 0, "Could not initialize zero-copy message", err_msg_init);
+
+    void *sock = zsock_resolve (reply_to);
+
+    /* Message is:
+     * frame 0: error code
+     * frame 1: size (in bytes) or return code
+     * frame 2: data (zero-copy)
+     * */
+    zerr = zmq_send (sock, &reply_code, sizeof(reply_code), ZMQ_SNDMORE);
+    ASSERT_TEST(zerr >= 0, "Could not send reply code", err_send_reply_code);
+    zerr = zmq_send (sock, &reply_size, sizeof(reply_size), ZMQ_SNDMORE);
+    ASSERT_TEST(zerr >= 0, "Could not send reply size", err_send_reply_size);
+    zerr = zmq_msg_send (&data_msg, sock, 0);
+    ASSERT_TEST(zerr >= 0, "Could not send reply data", err_send_reply_data);
+
+    return 0;
+
+err_send_reply_code:
+    zmq_msg_close (&data_msg);
+    return -1;
+
+err_send_reply_data:
+err_send_reply_size:
+    /* The message is partially sent already. Nothing we can do */
+    zmq_msg_close (&data_msg);
+    return 0;
+
+err_msg_init:
+    disp_op_handler_release_ret (data_out, hint);
+    return -1;
+}
+
 static zmsg_t * _msg_create_client_response (RW_REPLY_TYPE reply_code, uint32_t reply_size,
         uint32_t *data_out, bool with_data_frame)
 {
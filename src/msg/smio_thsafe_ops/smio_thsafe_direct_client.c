@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2014 LNLS (www.lnls.br)
+ * Author: Lucas Russo <lucas.russo@lnls.br>
+ *
+ * Released according to the GNU GPL, version 3 or any later version.
+ */
+
+#include "halcs_server.h"
+
+/* Undef ASSERT_ALLOC to avoid conflicting with other ASSERT_ALLOC */
+#ifdef ASSERT_TEST
+#undef ASSERT_TEST
+#endif
+#define ASSERT_TEST(test_boolean, err_str, err_goto_label, /* err_core */ ...) \
+    ASSERT_HAL_TEST(test_boolean, MSG, "[smio_thsafe_client:direct]", \
+            err_str, err_goto_label, /* err_core */ __VA_ARGS__)
+
+#ifdef ASSERT_ALLOC
+#undef ASSERT_ALLOC
+#endif
+#define ASSERT_ALLOC(ptr, err_goto_label, /* err_core */ ...) \
+    ASSERT_HAL_ALLOC(ptr, MSG, "[smio_thsafe_client:direct]",  \
+            msg_err_str(MSG_ERR_ALLOC),                     \
+            err_goto_label, /* err_core */ __VA_ARGS__)
+
+#ifdef CHECK_ERR
+#undef CHECK_ERR
+#endif
+#define CHECK_ERR(err, err_type)                            \
+    CHECK_HAL_ERR(err, MSG, "[smio_thsafe_client:direct]",  \
+            msg_err_str (err_type))
+
+/* Call the LLIO function "func" from the SMIO thread, holding the parent
+ * DEVIO lock associated with the address "offs", taken by "lock_func" and
+ * released by "unlock_func". The DEVIO thsafe server holds the same locks,
+ * so both paths can coexist safely */
+#define THSAFE_DIRECT_LLIO_LOCKED(self, offs, lock_func, unlock_func, func, ...) \
+    ({                                                               \
+        devio_t *__devio = smio_get_parent (self);                   \
+        ssize_t __ret = -1;                                          \
+        if (__devio != NULL) {                                       \
+            lock_func (__devio, offs);                               \
+            __ret = func (devio_get_llio (__devio), offs,            \
+                    ##__VA_ARGS__);                                  \
+            unlock_func (__devio, offs);                             \
+        }                                                            \
+        __ret;                                                       \
+    })
+
+#define THSAFE_DIRECT_LLIO_WRAPPER(self, offs, func, ...)            \
+    THSAFE_DIRECT_LLIO_LOCKED(self, offs, devio_lock_llio,           \
+            devio_unlock_llio, func, ##__VA_ARGS__)
+
+#define THSAFE_DIRECT_LLIO_DMA_WRAPPER(self, offs, func, ...)        \
+    THSAFE_DIRECT_LLIO_LOCKED(self, offs, devio_lock_llio_dma,       \
+            devio_unlock_llio_dma, func, ##__VA_ARGS__)
+
+/**** Open device ****/
+/* DEVIO owns the LLIO and opens it before any SMIO is spawned, so there is
+ * nothing to do here. Opening it again would reinitialize the device under
+ * the other SMIOs */
+int thsafe_direct_client_open (smio_t *self, llio_endpoint_t *endpoint)
+{
+    (void) self;
+    (void) endpoint;
+    return 0;
+}
+
+/**** Release device ****/
+/* DEVIO releases the LLIO when it is destroyed, after all of its SMIOs */
+int thsafe_direct_client_release (smio_t *self, llio_endpoint_t *endpoint)
+{
+    (void) self;
+    (void) endpoint;
+    return 0;
+}
+
+/**** Read data from device ****/
+ssize_t thsafe_direct_client_read_16 (smio_t *self, uint64_t offs, uint16_t *data)
+{
+    return THSAFE_DIRECT_LLIO_WRAPPER(self, offs, llio_read_16, data);
+}
+
+ssize_t thsafe_direct_client_read_32 (smio_t *self, uint64_t offs, uint32_t *data)
+{
+    return THSAFE_DIRECT_LLIO_WRAPPER(self, offs, llio_read_32, data);
+}
+
+ssize_t thsafe_direct_client_read_64 (smio_t *self, uint64_t offs, uint64_t *data)
+{
+    return THSAFE_DIRECT_LLIO_WRAPPER(self, offs, llio_read_64, data);
+}
+
+/**** Write data to device ****/
+ssize_t thsafe_direct_client_write_16 (smio_t *self, uint64_t offs, const uint16_t *data)
+{
+    return THSAFE_DIRECT_LLIO_WRAPPER(self, offs, llio_write_16, data);
+}
+
+ssize_t thsafe_direct_client_write_32 (smio_t *self, uint64_t offs, const uint32_t *data)
+{
+    return THSAFE_DIRECT_LLIO_WRAPPER(self, offs, llio_write_32, data);
+}
+
+ssize_t thsafe_direct_client_write_64 (smio_t *self, uint64_t offs, const uint64_t *data)
+{
+    return THSAFE_DIRECT_LLIO_WRAPPER(self, offs, llio_write_64, data);
+}
+
+/**** Read data block from device function pointer, size in bytes ****/
+ssize_t thsafe_direct_client_read_block (smio_t *self, uint64_t offs, size_t size, uint32_t *data)
+{
+    return THSAFE_DIRECT_LLIO_WRAPPER(self, offs, llio_read_block, size, data);
+}
+
+/**** Write data block from device function pointer, size in bytes ****/
+ssize_t thsafe_direct_client_write_block (smio_t *self, uint64_t offs, size_t size, const uint32_t *data)
+{
+    /* LLIO does not modify the data, it just lacks the const qualifier */
+    return THSAFE_DIRECT_LLIO_WRAPPER(self, offs, llio_write_block, size,
+            (uint32_t *) data);
+}
+
+/**** Read data block via DMA from device, size in bytes ****/
+ssize_t thsafe_direct_client_read_dma (smio_t *self, uint64_t offs, size_t size, uint32_t *data)
+{
+    return THSAFE_DIRECT_LLIO_DMA_WRAPPER(self, offs, llio_read_dma, size, data);
+}
+
+/**** Write data block via DMA from device, size in bytes ****/
+ssize_t thsafe_direct_client_write_dma (smio_t *self, uint64_t offs, size_t size, const uint32_t *data)
+{
+    /* LLIO does not modify the data, it just lacks the const qualifier */
+    return THSAFE_DIRECT_LLIO_DMA_WRAPPER(self, offs, llio_write_dma, size,
+            (uint32_t *) data);
+}
+
+/* Read a block straight into a new frame, so callers forwarding it get the
+ * same interface as with the ZMQ client */
+static ssize_t _thsafe_direct_client_read_frame (smio_t *self, uint64_t offs,
+        size_t size, zframe_t **data_frame, thsafe_client_read_block_fp read_fp)
+{
+    assert (data_frame);
+    ssize_t ret_size = -1;
+    zframe_t *frame = zframe_new (NULL, size);
+    ASSERT_ALLOC(frame, err_frame_alloc);
+
+    ret_size = read_fp (self, offs, size, (uint32_t *) zframe_data (frame));
+    ASSERT_TEST(ret_size > 0, "Could not read data block", err_read);
+
+    *data_frame = frame;
+    return ret_size;
+
+err_read:
+    zframe_destroy (&frame);
+err_frame_alloc:
+    *data_frame = NULL;
+    return ret_size;
+}
+
+/**** Read data block from device into a frame, size in bytes ****/
+ssize_t thsafe_direct_client_read_block_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame)
+{
+    return _thsafe_direct_client_read_frame (self, offs, size, data_frame,
+            thsafe_direct_client_read_block);
+}
+
+/**** Read data block via DMA from device into a frame, size in bytes ****/
+ssize_t thsafe_direct_client_read_dma_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame)
+{
+    return _thsafe_direct_client_read_frame (self, offs, size, data_frame,
+            thsafe_direct_client_read_dma);
+}
+
+/**** Execute a transaction of register operations ****/
+ssize_t thsafe_direct_client_txn (smio_t *self, smio_thsafe_txn_op_t *ops,
+        uint32_t num_ops)
+{
+    devio_t *devio = smio_get_parent (self);
+    ASSERT_TEST(devio != NULL, "SMIO not attached to any DEVIO", err_devio);
+
+    return devio_llio_txn (devio, ops, num_ops);
+
+err_devio:
+    return -1;
+}
+
+/*************** Our constant structure **************/
+const smio_thsafe_client_ops_t smio_thsafe_client_direct_ops = {
+    .thsafe_client_open           = thsafe_direct_client_open,        /* Open device */
+    .thsafe_client_release        = thsafe_direct_client_release,     /* Release device */
+    .thsafe_client_read_16        = thsafe_direct_client_read_16,     /* Read 16-bit data */
+    .thsafe_client_read_32        = thsafe_direct_client_read_32,     /* Read 32-bit data */
+    .thsafe_client_read_64        = thsafe_direct_client_read_64,     /* Read 64-bit data */
+    .thsafe_client_write_16       = thsafe_direct_client_write_16,    /* Write 16-bit data */
+    .thsafe_client_write_32       = thsafe_direct_client_write_32,    /* Write 32-bit data */
+    .thsafe_client_write_64       = thsafe_direct_client_write_64,    /* Write 64-bit data */
+    .thsafe_client_read_block     = thsafe_direct_client_read_block,  /* Read arbitrary block size data,
+                                                                           parameter size in bytes */
+    .thsafe_client_write_block    = thsafe_direct_client_write_block, /* Write arbitrary block size data,
+                                                                           parameter size in bytes */
+    .thsafe_client_read_dma       = thsafe_direct_client_read_dma,    /* Read arbitrary block size data via DMA,
+                                                                           parameter size in bytes */
+    .thsafe_client_write_dma      = thsafe_direct_client_write_dma,   /* Write arbitrary block size data via DMA,
+                                                                           parameter size in bytes */
+    .thsafe_client_txn            = thsafe_direct_client_txn,         /* Execute a transaction of register
+                                                                           operations atomically */
+    .thsafe_client_read_block_frame = thsafe_direct_client_read_block_frame,
+                                                                        /* Read arbitrary block size data
+                                                                           into a frame owned by the caller */
+    .thsafe_client_read_dma_frame = thsafe_direct_client_read_dma_frame
+                                                                        /* Read arbitrary block size data via DMA
+                                                                           into a frame owned by the caller */
+};
@@ -36,8 +36,14 @@ static ssize_t _thsafe_zmq_client_read_generic (smio_t *self, uint64_t offs, uin
         uint32_t size);
 static ssize_t _thsafe_zmq_client_write_generic (smio_t *self, uint64_t offs, const uint8_t *data,
         uint32_t size);
+static ssize_t _thsafe_zmq_client_read_block_generic (smio_t *self, uint32_t opcode,
+        uint64_t offs, size_t size, uint32_t *data, zframe_t **data_frame);
+static ssize_t _thsafe_zmq_client_write_block_generic (smio_t *self, uint32_t opcode,
+        uint64_t offs, size_t size, const uint32_t *data);
 static ssize_t _thsafe_zmq_client_recv_rw (smio_t *self, uint8_t *data,
         uint32_t size, bool accept_empty_data);
+static ssize_t _thsafe_zmq_client_recv_frame (smio_t *self, size_t size,
+        bool accept_empty_data, zframe_t **data_frame);
 
 /**** Open device ****/
 int thsafe_zmq_client_open (smio_t *self, llio_endpoint_t *endpoint)
@@ -87,133 +93,47 @@ ssize_t thsafe_zmq_client_write_64 (smio_t *self, uint64_t offs, const uint64_t
 /**** Read data block from device function pointer, size in bytes ****/
 ssize_t thsafe_zmq_client_read_block (smio_t *self, uint64_t offs, size_t size, uint32_t *data)
 {
-    assert (self);
-    ssize_t ret_size = -1;
-    zmsg_t *send_msg = zmsg_new ();
-    ASSERT_ALLOC(send_msg, err_msg_alloc);
-    uint32_t opcode = THSAFE_OPCODE_READ_BLOCK;
-    zsock_t *pipe_msg = smio_get_pipe_msg (self);
-    ASSERT_TEST(pipe_msg != NULL, "Could not get SMIO PIPE MSG",
-            err_get_pipe_msg);
-
-    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Calling thsafe_read_block\n");
-
-    /* Message is:
-     * frame 0: READ_BLOCK opcode
-     * frame 1: offset
-     * frame 2: number of bytes to be read */
-    int zerr = zmsg_addmem (send_msg, &opcode, sizeof (opcode));
-    ASSERT_TEST(zerr == 0, "Could not add READ opcode in message",
-            err_add_opcode);
-    zerr = zmsg_addmem (send_msg, &offs, sizeof (offs));
-    ASSERT_TEST(zerr == 0, "Could not add offset in message",
-            err_add_offset);
-    zerr = zmsg_addmem (send_msg, &size, sizeof (size));
-    ASSERT_TEST(zerr == 0, "Could not add size in message",
-            err_add_size);
-
-    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Sending message:\n");
-#ifdef LOCAL_MSG_DBG
-    errhand_log_print_zmq_msg (send_msg);
-#endif
-
-    zerr = zmsg_send (&send_msg, pipe_msg);
-    ASSERT_TEST(zerr == 0, "Could not send message", err_send_msg);
-
-    /* Message is:
-     * frame 0: reply code
-     * frame 1: return code
-     * frame 2: data */
-    ret_size = _thsafe_zmq_client_recv_rw (self, (uint8_t *) data, size, true);
+    return _thsafe_zmq_client_read_block_generic (self, THSAFE_OPCODE_READ_BLOCK,
+            offs, size, data, NULL);
+}
 
-err_send_msg:
-err_add_size:
-err_add_offset:
-err_add_opcode:
-err_get_pipe_msg:
-    zmsg_destroy (&send_msg);
-err_msg_alloc:
-    return ret_size;
+/**** Read data block from device, size in bytes. The received frame is
+ * handed to the caller, which owns it ****/
+ssize_t thsafe_zmq_client_read_block_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame)
+{
+    return _thsafe_zmq_client_read_block_generic (self, THSAFE_OPCODE_READ_BLOCK,
+            offs, size, NULL, data_frame);
 }
 
 /**** Write data block from device function pointer, size in bytes ****/
 ssize_t thsafe_zmq_client_write_block (smio_t *self, uint64_t offs, size_t size, const uint32_t *data)
 {
-    assert (self);
-    zmsg_t *send_msg = zmsg_new ();
-    ASSERT_ALLOC(send_msg, err_msg_alloc);
-    uint32_t opcode = THSAFE_OPCODE_WRITE_BLOCK;
-    zsock_t *pipe_msg = smio_get_pipe_msg (self);
-    ASSERT_TEST(pipe_msg != NULL, "Could not get SMIO PIPE MSG",
-            err_get_pipe_msg);
-
-    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Calling thsafe_write_block\n");
-
-    /* Message is:
-     * frame 0: WRITE_BLOCK opcode
-     * frame 1: offset
-     * frame 2: data to be written
-     * */
-    int zerr = zmsg_addmem (send_msg, &opcode, sizeof (opcode));
-    ASSERT_TEST(zerr == 0, "Could not add WRITE opcode in message",
-            err_add_opcode);
-    zerr = zmsg_addmem (send_msg, &offs, sizeof (offs));
-    ASSERT_TEST(zerr == 0, "Could not add offset in message",
-            err_add_offset);
-    zerr = zmsg_addmem (send_msg, data, size);
-    ASSERT_TEST(zerr == 0, "Could not add data in message",
-            err_add_data);
-
-    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Sending message:\n");
-#ifdef LOCAL_MSG_DBG
-    errhand_log_print_zmq_msg (send_msg);
-#endif
-
-    zerr = zmsg_send (&send_msg, pipe_msg);
-    ASSERT_TEST(zerr == 0, "Could not send message", err_send_msg);
-
-    /* Message is:
-     * frame 0: reply code
-     * frame 1: return code
-     * frame 2: data */
-    uint32_t ret_data = 0;
-    ssize_t ret_size = _thsafe_zmq_client_recv_rw (self, (uint8_t *) &ret_data,
-            sizeof (ret_data), false);
-    ASSERT_TEST(ret_size == sizeof (ret_data), "Data size does not match the expected",
-            err_data_size);
-
-    zmsg_destroy (&send_msg);
-    return ret_data;
-
-err_data_size:
-err_send_msg:
-err_add_data:
-err_add_offset:
-err_add_opcode:
-err_get_pipe_msg:
-    zmsg_destroy (&send_msg);
-err_msg_alloc:
-    return -1;
+    return _thsafe_zmq_client_write_block_generic (self, THSAFE_OPCODE_WRITE_BLOCK,
+            offs, size, data);
 }
 
 /**** Read data block via DMA from device, size in bytes ****/
 ssize_t thsafe_zmq_client_read_dma (smio_t *self, uint64_t offs, size_t size, uint32_t *data)
 {
-    (void) self;
-    (void) offs;
-    (void) size;
-    (void) data;
-    return -1;
+    return _thsafe_zmq_client_read_block_generic (self, THSAFE_OPCODE_READ_DMA,
+            offs, size, data, NULL);
+}
+
+/**** Read data block via DMA from device, size in bytes. The received frame
+ * is handed to the caller, which owns it ****/
+ssize_t thsafe_zmq_client_read_dma_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame)
+{
+    return _thsafe_zmq_client_read_block_generic (self, THSAFE_OPCODE_READ_DMA,
+            offs, size, NULL, data_frame);
 }
 
 /**** Write data block via DMA from device, size in bytes ****/
 ssize_t thsafe_zmq_client_write_dma (smio_t *self, uint64_t offs, size_t size, const uint32_t *data)
 {
-    (void) self;
-    (void) offs;
-    (void) size;
-    (void) data;
-    return -1;
+    return _thsafe_zmq_client_write_block_generic (self, THSAFE_OPCODE_WRITE_DMA,
+            offs, size, data);
 }
 
 /**** Read device information function pointer ****/
@@ -437,6 +357,172 @@ err_msg_alloc:
     return -1;
 }
 
+static ssize_t _thsafe_zmq_client_read_block_generic (smio_t *self, uint32_t opcode,
+        uint64_t offs, size_t size, uint32_t *data, zframe_t **data_frame)
+{
+    assert (self);
+    ssize_t ret_size = -1;
+    zmsg_t *send_msg = zmsg_new ();
+    ASSERT_ALLOC(send_msg, err_msg_alloc);
+    zsock_t *pipe_msg = smio_get_pipe_msg (self);
+    ASSERT_TEST(pipe_msg != NULL, "Could not get SMIO PIPE MSG",
+            err_get_pipe_msg);
+
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Calling _thsafe_read_block_generic\n");
+
+    /* Message is:
+     * frame 0: READ_BLOCK or READ_DMA opcode
+     * frame 1: offset
+     * frame 2: number of bytes to be read */
+    int zerr = zmsg_addmem (send_msg, &opcode, sizeof (opcode));
+    ASSERT_TEST(zerr == 0, "Could not add READ opcode in message",
+            err_add_opcode);
+    zerr = zmsg_addmem (send_msg, &offs, sizeof (offs));
+    ASSERT_TEST(zerr == 0, "Could not add offset in message",
+            err_add_offset);
+    zerr = zmsg_addmem (send_msg, &size, sizeof (size));
+    ASSERT_TEST(zerr == 0, "Could not add size in message",
+            err_add_size);
+
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Sending message:\n");
+#ifdef LOCAL_MSG_DBG
+    errhand_log_print_zmq_msg (send_msg);
+#endif
+
+    zerr = zmsg_send (&send_msg, pipe_msg);
+    ASSERT_TEST(zerr == 0, "Could not send message", err_send_msg);
+
+    /* Message is:
+     * frame 0: reply code
+     * frame 1: return code
+     * frame 2: data */
+    if (data_frame != NULL) {
+        /* Hand the data frame over, so the caller can forward it without
+         * copying the block */
+        ret_size = _thsafe_zmq_client_recv_frame (self, size, true, data_frame);
+    }
+    else {
+        ret_size = _thsafe_zmq_client_recv_rw (self, (uint8_t *) data, size, true);
+    }
+
+err_send_msg:
+err_add_size:
+err_add_offset:
+err_add_opcode:
+err_get_pipe_msg:
+    zmsg_destroy (&send_msg);
+err_msg_alloc:
+    return ret_size;
+}
+
+static ssize_t _thsafe_zmq_client_write_block_generic (smio_t *self, uint32_t opcode,
+        uint64_t offs, size_t size, const uint32_t *data)
+{
+    assert (self);
+    zmsg_t *send_msg = zmsg_new ();
+    ASSERT_ALLOC(send_msg, err_msg_alloc);
+    zsock_t *pipe_msg = smio_get_pipe_msg (self);
+    ASSERT_TEST(pipe_msg != NULL, "Could not get SMIO PIPE MSG",
+            err_get_pipe_msg);
+
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Calling _thsafe_write_block_generic\n");
+
+    /* Message is:
+     * frame 0: WRITE_BLOCK or WRITE_DMA opcode
+     * frame 1: offset
+     * frame 2: data to be written
+     * */
+    int zerr = zmsg_addmem (send_msg, &opcode, sizeof (opcode));
+    ASSERT_TEST(zerr == 0, "Could not add WRITE opcode in message",
+            err_add_opcode);
+    zerr = zmsg_addmem (send_msg, &offs, sizeof (offs));
+    ASSERT_TEST(zerr == 0, "Could not add offset in message",
+            err_add_offset);
+    zerr = zmsg_addmem (send_msg, data, size);
+    ASSERT_TEST(zerr == 0, "Could not add data in message",
+            err_add_data);
+
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Sending message:\n");
+#ifdef LOCAL_MSG_DBG
+    errhand_log_print_zmq_msg (send_msg);
+#endif
+
+    zerr = zmsg_send (&send_msg, pipe_msg);
+    ASSERT_TEST(zerr == 0, "Could not send message", err_send_msg);
+
+    /* Message is:
+     * frame 0: reply code
+     * frame 1: return code
+     * frame 2: data */
+    uint32_t ret_data = 0;
+    ssize_t ret_size = _thsafe_zmq_client_recv_rw (self, (uint8_t *) &ret_data,
+            sizeof (ret_data), false);
+    ASSERT_TEST(ret_size == sizeof (ret_data), "Data size does not match the expected",
+            err_data_size);
+
+    zmsg_destroy (&send_msg);
+    return ret_data;
+
+err_data_size:
+err_send_msg:
+err_add_data:
+err_add_offset:
+err_add_opcode:
+err_get_pipe_msg:
+    zmsg_destroy (&send_msg);
+err_msg_alloc:
+    return -1;
+}
+
+/**** Execute a transaction of register operations ****/
+ssize_t thsafe_zmq_client_txn (smio_t *self, smio_thsafe_txn_op_t *ops,
+        uint32_t num_ops)
+{
+    assert (self);
+    ssize_t ret_size = -1;
+    uint32_t opcode = THSAFE_OPCODE_TXN;
+    size_t ops_size = num_ops * sizeof (*ops);
+    zmsg_t *send_msg = zmsg_new ();
+    ASSERT_ALLOC(send_msg, err_msg_alloc);
+    zsock_t *pipe_msg = smio_get_pipe_msg (self);
+    ASSERT_TEST(pipe_msg != NULL, "Could not get SMIO PIPE MSG",
+            err_get_pipe_msg);
+
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Calling thsafe_txn\n");
+
+    /* Message is:
+     * frame 0: TXN opcode
+     * frame 1: operations */
+    int zerr = zmsg_addmem (send_msg, &opcode, sizeof (opcode));
+    ASSERT_TEST(zerr == 0, "Could not add TXN opcode in message",
+            err_add_opcode);
+    zerr = zmsg_addmem (send_msg, ops, ops_size);
+    ASSERT_TEST(zerr == 0, "Could not add operations in message",
+            err_add_ops);
+
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Sending message:\n");
+#ifdef LOCAL_MSG_DBG
+    errhand_log_print_zmq_msg (send_msg);
+#endif
+
+    zerr = zmsg_send (&send_msg, pipe_msg);
+    ASSERT_TEST(zerr == 0, "Could not send message", err_send_msg);
+
+    /* Message is:
+     * frame 0: reply code
+     * frame 1: return code
+     * frame 2: operations with the read values */
+    ret_size = _thsafe_zmq_client_recv_rw (self, (uint8_t *) ops, ops_size, false);
+
+err_send_msg:
+err_add_ops:
+err_add_opcode:
+err_get_pipe_msg:
+    zmsg_destroy (&send_msg);
+err_msg_alloc:
+    return ret_size;
+}
+
 static zmsg_t *_thsafe_zmq_client_recv_confirmation (smio_t *self)
 {
     DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_client:zmq] Calling _thsafe_zmq_client_recv_confirmation\n");
@@ -487,6 +573,27 @@ err_get_pipe_msg:
 static ssize_t _thsafe_zmq_client_recv_rw (smio_t *self, uint8_t *data,
         uint32_t size, bool accept_empty_data)
 {
+    zframe_t *data_frame = NULL;
+    ssize_t ret_size = _thsafe_zmq_client_recv_frame (self, size,
+            accept_empty_data, &data_frame);
+
+    if (ret_size > 0) {
+        memcpy (data, zframe_data (data_frame), size);
+    }
+
+    zframe_destroy (&data_frame);
+    return ret_size;
+}
+
+/* Receive a reply and hand its data frame to the caller. On success,
+ * *data_frame is owned by the caller and has at least size bytes. It is set
+ * to NULL if an empty data frame was accepted or in case of error */
+static ssize_t _thsafe_zmq_client_recv_frame (smio_t *self, size_t size,
+        bool accept_empty_data, zframe_t **data_frame_out)
+{
+    assert (data_frame_out);
+    *data_frame_out = NULL;
+
     ssize_t ret_size = -1;
 
     /* Returns NULL if confirmation was not OK or in case of error.
@@ -532,8 +639,9 @@ static ssize_t _thsafe_zmq_client_recv_rw (smio_t *self, uint8_t *data,
                 "Specified buffer size is bigger than the available data",
                 err_buf_size_data);
 
-        uint8_t* raw_data = (uint8_t *) zframe_data (data_frame);
-        memcpy (data, raw_data, size);
+        /* Caller owns the data frame now */
+        *data_frame_out = data_frame;
+        data_frame = NULL;
         ret_size = size;
     }
 
@@ -567,7 +675,15 @@ const smio_thsafe_client_ops_t smio_thsafe_client_zmq_ops = {
                                                                         parameter size in bytes */
     .thsafe_client_read_dma       = thsafe_zmq_client_read_dma,    /* Read arbitrary block size data via DMA,
      _                                                                  parameter size in bytes */
-    .thsafe_client_write_dma      = thsafe_zmq_client_write_dma    /* Write arbitrary block size data via DMA,
+    .thsafe_client_write_dma      = thsafe_zmq_client_write_dma,   /* Write arbitrary block size data via DMA,
                                                                         parameter size in bytes */
     /*.thsafe_client_read_info      = thsafe_zmq_client_read_info */   /* Read device information data */
+    .thsafe_client_txn            = thsafe_zmq_client_txn,         /* Execute a transaction of register
+                                                                        operations atomically */
+    .thsafe_client_read_block_frame = thsafe_zmq_client_read_block_frame,
+                                                                    /* Read arbitrary block size data
+                                                                        into a frame owned by the caller */
+    .thsafe_client_read_dma_frame = thsafe_zmq_client_read_dma_frame
+                                                                    /* Read arbitrary block size data via DMA
+                                                                        into a frame owned by the caller */
 };
@@ -122,7 +122,9 @@ static int _thsafe_zmq_server_read_16 (void *owner, void *args, void *ret)
     uint64_t offset = *(uint64_t *) THSAFE_MSG_ZMQ_FIRST_ARG(args);
 
     /* Call llio to perform the actual operation */
+    devio_lock_llio (self, offset);
     int32_t llio_ret = llio_read_16 (llio, offset, (uint16_t *) ret);
+    devio_unlock_llio (self, offset);
 
     return llio_ret;
 }
@@ -153,7 +155,9 @@ static int _thsafe_zmq_server_read_32 (void *owner, void *args, void *ret)
     uint64_t offset = *(uint64_t *) THSAFE_MSG_ZMQ_FIRST_ARG(args);
 
     /* Call llio to perform the actual operation */
+    devio_lock_llio (self, offset);
     int32_t llio_ret = llio_read_32 (llio, offset, (uint32_t *) ret);
+    devio_unlock_llio (self, offset);
 
     return llio_ret;
 }
@@ -184,7 +188,9 @@ static int _thsafe_zmq_server_read_64 (void *owner, void *args, void *ret)
     uint64_t offset = *(uint64_t *) THSAFE_MSG_ZMQ_FIRST_ARG(args);
 
     /* Call llio to perform the actual operation */
+    devio_lock_llio (self, offset);
     int32_t llio_ret = llio_read_64 (llio, offset, (uint64_t *) ret);
+    devio_unlock_llio (self, offset);
 
     return llio_ret;
 }
@@ -216,7 +222,9 @@ static int _thsafe_zmq_server_write_16 (void *owner, void *args, void *ret)
     uint16_t *data_write = (uint16_t *) THSAFE_MSG_ZMQ_NEXT_ARG(args);
 
     /* Call llio to perform the actual operation */
+    devio_lock_llio (self, offset);
     int32_t llio_ret = llio_write_16 (llio, offset, data_write);
+    devio_unlock_llio (self, offset);
     *(int32_t *) ret = llio_ret;
 
     return sizeof (int32_t);
@@ -248,7 +256,9 @@ static int _thsafe_zmq_server_write_32 (void *owner, void *args, void *ret)
     uint32_t *data_write = (uint32_t *) THSAFE_MSG_ZMQ_NEXT_ARG(args);
 
     /* Call llio to perform the actual operation */
+    devio_lock_llio (self, offset);
     int32_t llio_ret = llio_write_32 (llio, offset, data_write);
+    devio_unlock_llio (self, offset);
     *(int32_t *) ret = llio_ret;
 
     return sizeof (int32_t);
@@ -280,7 +290,9 @@ static int _thsafe_zmq_server_write_64 (void *owner, void *args, void *ret)
     uint64_t *data_write = (uint64_t *) THSAFE_MSG_ZMQ_NEXT_ARG(args);
 
     /* Call llio to perform the actual operation */
+    devio_lock_llio (self, offset);
     int32_t llio_ret = llio_write_64 (llio, offset, data_write);
+    devio_unlock_llio (self, offset);
     *(int32_t *) ret = llio_ret;
 
     return sizeof (int32_t);
@@ -314,8 +326,10 @@ static int _thsafe_zmq_server_read_block (void *owner, void *args, void *ret)
     DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_server:zmq] Offset = %"PRIu64", "
             "size = %zd\n", offset, read_bsize);
     /* Call llio to perform the actual operation */
+    devio_lock_llio (self, offset);
     int32_t llio_ret = llio_read_block (llio, offset, read_bsize,
             (uint32_t *) ret);
+    devio_unlock_llio (self, offset);
 
     return llio_ret;
 }
@@ -354,8 +368,10 @@ static int _thsafe_zmq_server_write_block (void *owner, void *args, void *ret)
 
     /* We must accept every block size. So, we just perform the actual LLIO
      * operation */
+    devio_lock_llio (self, offset);
     int32_t llio_ret = llio_write_block (llio, offset, data_write_size,
             data_write);
+    devio_unlock_llio (self, offset);
     *(int32_t *) ret = llio_ret;
 
     /* Cleanup arguments that we now own */
@@ -381,10 +397,24 @@ disp_op_t thsafe_zmq_server_write_block_exp = {
 /**** Read data block via DMA from device, size in bytes ****/
 static int _thsafe_zmq_server_read_dma (void *owner, void *args, void *ret)
 {
-    (void) owner;
-    (void) args;
-    (void) ret;
-    return -1;
+    assert (owner);
+    assert (args);
+    DEVIO_OWNER_TYPE *self = DEVIO_EXP_OWNER(owner);
+    llio_t *llio = devio_get_llio (self);
+
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_server:zmq] Calling thsafe_read_dma\n");
+    uint64_t offset = *(uint64_t *) THSAFE_MSG_ZMQ_FIRST_ARG(args);
+    size_t read_bsize = *(size_t *) THSAFE_MSG_ZMQ_NEXT_ARG(args);
+
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_server:zmq] Offset = %"PRIu64", "
+            "size = %zd\n", offset, read_bsize);
+    /* Call llio to perform the actual operation */
+    devio_lock_llio_dma (self, offset);
+    int32_t llio_ret = llio_read_dma (llio, offset, read_bsize,
+            (uint32_t *) ret);
+    devio_unlock_llio_dma (self, offset);
+
+    return llio_ret;
 }
 
 disp_op_t thsafe_zmq_server_read_dma_exp = {
@@ -403,10 +433,33 @@ disp_op_t thsafe_zmq_server_read_dma_exp = {
 /**** Write data block via DMA from device, size in bytes ****/
 static int _thsafe_zmq_server_write_dma (void *owner, void *args, void *ret)
 {
-    (void) owner;
-    (void) args;
-    (void) ret;
-    return -1;
+    assert (owner);
+    assert (args);
+    DEVIO_OWNER_TYPE *self = DEVIO_EXP_OWNER(owner);
+    llio_t *llio = devio_get_llio (self);
+
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_server:zmq] Calling thsafe_write_dma\n");
+    THSAFE_MSG_ZMQ_ARG_TYPE offset_arg = THSAFE_MSG_ZMQ_POP_NEXT_ARG(args);
+    uint64_t offset = *(uint64_t *) GEN_MSG_ZMQ_ARG_DATA(offset_arg);
+    /* We now own the argument and must clean it after use */
+    THSAFE_MSG_ZMQ_ARG_TYPE data_write_arg = THSAFE_MSG_ZMQ_POP_NEXT_ARG(args);
+    uint32_t *data_write = (uint32_t *)
+        ((zmq_server_data_block_t *) THSAFE_MSG_ZMQ_ARG_DATA(data_write_arg))->data;
+    uint32_t data_write_size = THSAFE_MSG_ZMQ_ARG_SIZE(data_write_arg);
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_server:zmq] Arg is %u bytes\n",
+            data_write_size);
+
+    devio_lock_llio_dma (self, offset);
+    int32_t llio_ret = llio_write_dma (llio, offset, data_write_size,
+            data_write);
+    devio_unlock_llio_dma (self, offset);
+    *(int32_t *) ret = llio_ret;
+
+    /* Cleanup arguments that we now own */
+    THSAFE_MSG_CLENUP_ARG(&offset_arg);
+    THSAFE_MSG_CLENUP_ARG(&data_write_arg);
+
+    return sizeof (int32_t);
 }
 
 disp_op_t thsafe_zmq_server_write_dma_exp = {
@@ -422,6 +475,52 @@ disp_op_t thsafe_zmq_server_write_dma_exp = {
     }
 };
 
+/**** Execute a transaction of register operations ****/
+static int _thsafe_zmq_server_txn (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
+    DEVIO_OWNER_TYPE *self = DEVIO_EXP_OWNER(owner);
+    int32_t llio_ret = -1;
+
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_server:zmq] Calling thsafe_txn\n");
+    /* We now own the argument and must clean it after use */
+    THSAFE_MSG_ZMQ_ARG_TYPE ops_arg = THSAFE_MSG_ZMQ_POP_NEXT_ARG(args);
+    uint32_t ops_size = THSAFE_MSG_ZMQ_ARG_SIZE(ops_arg);
+    uint32_t num_ops = ops_size / sizeof (smio_thsafe_txn_op_t);
+    DBE_DEBUG (DBG_MSG | DBG_LVL_TRACE, "[smio_thsafe_server:zmq] Transaction "
+            "has %u operations\n", num_ops);
+
+    ASSERT_TEST(ops_size % sizeof (smio_thsafe_txn_op_t) == 0 &&
+            num_ops <= THSAFE_TXN_MAX_OPS, "Malformed transaction",
+            err_ops_size);
+
+    /* Execute the transaction in the reply buffer, so the read values
+     * go back to the client */
+    smio_thsafe_txn_op_t *ops = (smio_thsafe_txn_op_t *) ret;
+    memcpy (ops, ((zmq_server_data_block_t *) THSAFE_MSG_ZMQ_ARG_DATA(ops_arg))->data,
+            ops_size);
+    llio_ret = devio_llio_txn (self, ops, num_ops);
+
+err_ops_size:
+    /* Cleanup arguments that we now own */
+    THSAFE_MSG_CLENUP_ARG(&ops_arg);
+
+    return llio_ret;
+}
+
+disp_op_t thsafe_zmq_server_txn_exp = {
+    .name = THSAFE_NAME_TXN,
+    .opcode = THSAFE_OPCODE_TXN,
+    .func_fp = _thsafe_zmq_server_txn,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_VAR, zmq_server_data_block_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_VAR, zmq_server_data_block_t),
+        DISP_ARG_END
+    }
+};
+
 /**** Read device information function pointer ****/
 /* int thsafe_zmq_server_read_info (void *owner, void *args, void *ret)
  *{
@@ -446,6 +545,7 @@ const disp_op_t *smio_thsafe_zmq_server_ops [] = {
     &thsafe_zmq_server_write_block_exp,
     &thsafe_zmq_server_read_dma_exp,
     &thsafe_zmq_server_write_dma_exp,
+    &thsafe_zmq_server_txn_exp,
     NULL
 };
 
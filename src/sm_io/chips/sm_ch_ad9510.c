@@ -41,15 +41,42 @@
 #define SMCH_AD9510_USECS_WAIT              1000
 #define SMCH_AD9510_WAIT(usecs)             usleep(usecs)
 #define SMCH_AD9510_WAIT_DFLT               SMCH_AD9510_WAIT(SMCH_AD9510_USECS_WAIT)
+#define SMCH_AD9510_BURST_MAX               32
 
 struct _smch_ad9510_t {
     smpr_t *spi;                    /* SPI protocol object */
+    smch_shadow_t *shadow;          /* Register shadow */
+};
+
+/* Registers read back on resync */
+static const uint8_t smch_ad9510_shadow_regs [] = {
+    AD9510_REG_PLL_A_COUNTER, AD9510_REG_PLL_B_MSB_COUNTER,
+    AD9510_REG_PLL_B_LSB_COUNTER, AD9510_REG_PLL_1, AD9510_REG_PLL_2,
+    AD9510_REG_PLL_3, AD9510_REG_PLL_4, AD9510_REG_PLL_R_MSB_COUNTER,
+    AD9510_REG_PLL_R_LSB_COUNTER, AD9510_REG_LVPECL_OUT0,
+    AD9510_REG_LVPECL_OUT1, AD9510_REG_LVPECL_OUT2, AD9510_REG_LVPECL_OUT3,
+    AD9510_REG_LVDS_CMOS_OUT4, AD9510_REG_LVDS_CMOS_OUT5,
+    AD9510_REG_LVDS_CMOS_OUT6, AD9510_REG_LVDS_CMOS_OUT7, AD9510_REG_CLK_OPT,
+    AD9510_REG_DIV0_DCYCLE, AD9510_REG_DIV0_OPT, AD9510_REG_DIV1_DCYCLE,
+    AD9510_REG_DIV1_OPT, AD9510_REG_DIV2_DCYCLE, AD9510_REG_DIV2_OPT,
+    AD9510_REG_DIV3_DCYCLE, AD9510_REG_DIV3_OPT, AD9510_REG_DIV4_DCYCLE,
+    AD9510_REG_DIV4_OPT, AD9510_REG_DIV5_DCYCLE, AD9510_REG_DIV5_OPT,
+    AD9510_REG_DIV6_DCYCLE, AD9510_REG_DIV6_OPT, AD9510_REG_DIV7_DCYCLE,
+    AD9510_REG_DIV7_OPT, AD9510_REG_FUNCTION
 };
 
 static ssize_t _smch_ad9510_write_8 (smch_ad9510_t *self, uint8_t addr,
         const uint8_t *data);
 static ssize_t _smch_ad9510_read_8 (smch_ad9510_t *self, uint8_t addr,
         uint8_t *data);
+static void _smch_ad9510_xfer_add (smch_ad9510_t *self, smpr_xfer_t *xfers,
+        size_t *num_xfers, uint8_t addr, uint8_t data);
+static smch_err_e _smch_ad9510_write_burst (smch_ad9510_t *self,
+        smpr_xfer_t *xfers, size_t num_xfers);
+static smch_err_e _smch_ad9510_shadow_read (void *owner, uint8_t addr,
+        uint8_t *data);
+static smch_err_e _smch_ad9510_shadow_write (void *owner, uint8_t addr,
+        const uint8_t *data);
 static smch_err_e _smch_ad9510_init (smch_ad9510_t *self);
 static bool _smch_ad9510_wait_completion (smch_ad9510_t *self, unsigned int tries);
 static smch_err_e _smch_ad9510_reg_update (smch_ad9510_t *self);
@@ -73,13 +100,32 @@ smch_ad9510_t * smch_ad9510_new (smio_t *parent, uint64_t base,
 
     DBE_DEBUG (DBG_SM_CH | DBG_LVL_INFO, "[sm_ch:ad9510] Created instance of SMCH\n");
 
+    self->shadow = smch_shadow_new (self, _smch_ad9510_shadow_read,
+            _smch_ad9510_shadow_write);
+    ASSERT_ALLOC(self->shadow, err_shadow_alloc);
+    /* Self-clearing registers */
+    smch_shadow_set_volatile (self->shadow, AD9510_REG_CFG_SERIAL, 1);
+    smch_shadow_set_volatile (self->shadow, AD9510_REG_UPDATE_REGS, 1);
+    smch_shadow_track (self->shadow, smch_ad9510_shadow_regs,
+            ARRAY_SIZE(smch_ad9510_shadow_regs));
+
     smch_err_e err = _smch_ad9510_init (self);
     ASSERT_TEST(err == SMCH_SUCCESS, "Could not initialize AD9510",
             err_smch_init);
 
+    /* Registers that can not be read back now are filled on first access */
+    err = smch_shadow_resync (self->shadow);
+    if (err != SMCH_SUCCESS) {
+        DBE_DEBUG (DBG_SM_CH | DBG_LVL_WARN, "[sm_ch:ad9510] Could not read "
+                "AD9510 registers. Register shadow left empty\n");
+        smch_shadow_invalidate (self->shadow);
+    }
+
     return self;
 
 err_smch_init:
+    smch_shadow_destroy (&self->shadow);
+err_shadow_alloc:
     smpr_release (self->spi);
 err_smpr_init:
     smpr_destroy (&self->spi);
@@ -97,6 +143,7 @@ smch_err_e smch_ad9510_destroy (smch_ad9510_t **self_p)
     if (*self_p) {
         smch_ad9510_t *self = *self_p;
 
+        smch_shadow_destroy (&self->shadow);
         smpr_release (self->spi);
         smpr_destroy (&self->spi);
         free (self);
@@ -109,15 +156,13 @@ smch_err_e smch_ad9510_destroy (smch_ad9510_t **self_p)
 smch_err_e smch_ad9510_write_8 (smch_ad9510_t *self, uint8_t addr,
         const uint8_t *data)
 {
-    return (_smch_ad9510_write_8 (self, addr, data) == sizeof(uint8_t))?
-        SMCH_SUCCESS : SMCH_ERR_RW_SMPR;
+    return smch_shadow_write_8 (self->shadow, addr, data);
 }
 
 smch_err_e smch_ad9510_write_8_update (smch_ad9510_t *self, uint8_t addr,
         const uint8_t *data)
 {
-    smch_err_e err = (_smch_ad9510_write_8 (self, addr, data) == sizeof(uint8_t))?
-        SMCH_SUCCESS : SMCH_ERR_RW_SMPR;
+    smch_err_e err = smch_shadow_write_8 (self->shadow, addr, data);
 
     if (err != SMCH_SUCCESS) {
         return err;
@@ -129,15 +174,13 @@ smch_err_e smch_ad9510_write_8_update (smch_ad9510_t *self, uint8_t addr,
 smch_err_e smch_ad9510_read_8 (smch_ad9510_t *self, uint8_t addr,
         uint8_t *data)
 {
-    return (_smch_ad9510_read_8 (self, addr, data) == sizeof(uint8_t))?
-        SMCH_SUCCESS : SMCH_ERR_RW_SMPR;
+    return smch_shadow_read_8 (self->shadow, addr, data);
 }
 
 smch_err_e smch_ad9510_read_8_update (smch_ad9510_t *self, uint8_t addr,
         uint8_t *data)
 {
-    smch_err_e err = (_smch_ad9510_read_8 (self, addr, data) == sizeof(uint8_t))?
-        SMCH_SUCCESS : SMCH_ERR_RW_SMPR;
+    smch_err_e err = smch_shadow_read_8 (self->shadow, addr, data);
 
     if (err != SMCH_SUCCESS) {
         return err;
@@ -151,6 +194,11 @@ smch_err_e smch_ad9510_reg_update (smch_ad9510_t *self)
     return _smch_ad9510_reg_update (self);
 }
 
+smch_err_e smch_ad9510_resync (smch_ad9510_t *self)
+{
+    return smch_shadow_resync (self->shadow);
+}
+
 smch_err_e smch_ad9510_cfg_defaults (smch_ad9510_t *self)
 {
     smch_err_e err = SMCH_SUCCESS;
@@ -159,62 +207,65 @@ smch_err_e smch_ad9510_cfg_defaults (smch_ad9510_t *self)
     ASSERT_TEST(err == SMCH_SUCCESS, "Could not initialize AD9510",
             err_smpr_write, SMCH_ERR_RW_SMPR);
 
+    smpr_xfer_t xfers [SMCH_AD9510_BURST_MAX];
+    size_t num_xfers = 0;
+
     /* Setup A and B PLL divider */
     uint8_t data = AD9510_PLL_A_COUNTER_W(0);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_A_COUNTER, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_A_COUNTER, data);
 
     /* Extract MSB part of the divider */
     data = AD9510_PLL_B_MSB_COUNTER_W(SMCH_AD9510_DFLT_PLL_B_COUNTER >>
             AD9510_PLL_B_LSB_COUNTER_SIZE);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_B_MSB_COUNTER, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_B_MSB_COUNTER, data);
 
         /* Extract LSB part of the divider */
     data = AD9510_PLL_B_LSB_COUNTER_W(SMCH_AD9510_DFLT_PLL_B_COUNTER);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_B_LSB_COUNTER, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_B_LSB_COUNTER, data);
 
     /* Setup MUX status pin */
     data = AD9510_PLL_2_CP_MODE_W(0x03 /* CP normal operation*/) |
         AD9510_PLL_2_MUX_SEL_W(0x01 /* Digital Lock Detect */) |
         AD9510_PLL_2_PFD_POL_POS; /* PFD positive polarity */
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_2, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_2, data);
 
     /* Setup Prescaler and Power PLL Up*/
     data = AD9510_PLL_4_PRESCALER_P_W(0 /* Divide by 1 */) |
         AD9510_PLL_4_PLL_PDOWN_W(0x0);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_4, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_4, data);
 
     /* Setup R divider */
     data = AD9510_PLL_R_MSB_COUNTER_W(SMCH_AD9510_DFLT_PLL_R_COUNTER >>
             AD9510_PLL_R_LSB_COUNTER_SIZE);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_R_MSB_COUNTER, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_R_MSB_COUNTER, data);
     data = AD9510_PLL_R_LSB_COUNTER_W(SMCH_AD9510_DFLT_PLL_R_COUNTER);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_R_LSB_COUNTER, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_R_LSB_COUNTER, data);
 
     /* Power-up LVPECL outputs */
     DBE_DEBUG (DBG_SM_CH | DBG_LVL_INFO,
             "[sm_ch:ad9510] Powering up LVPECL outputs 0-3\n");
     data = AD9510_LVPECL_OUT_LVL_W(0x02) /* 810 mV output */ |
         AD9510_LVPECL_OUT_PDOWN_W(0x0) /* Do not power down */;
-    _smch_ad9510_write_8 (self, AD9510_REG_LVPECL_OUT0, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_LVPECL_OUT1, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_LVPECL_OUT2, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_LVPECL_OUT3, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_LVPECL_OUT0, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_LVPECL_OUT1, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_LVPECL_OUT2, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_LVPECL_OUT3, data);
 
     /* Power-up LVCMOS/LVDS output 4 (DEBUG) */
     DBE_DEBUG (DBG_SM_CH | DBG_LVL_INFO,
             "[sm_ch:ad9510] Powering up LVDS/CMOS output 4\n");
     data = AD9510_LVDS_CMOS_CURR_W(0x1) /* 3.5 mA, 100 Ohm */ & (
         ~AD9510_LVDS_CMOS_PDOWN /* Do not power down */);
-    _smch_ad9510_write_8 (self, AD9510_REG_LVDS_CMOS_OUT4, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_LVDS_CMOS_OUT4, data);
 
     /* Power-down LVCMOS/LVDS outputs 5-7*/
     DBE_DEBUG (DBG_SM_CH | DBG_LVL_INFO,
             "[sm_ch:ad9510] Powering down LVDS/CMOS outputs 5-7\n");
     data = AD9510_LVDS_CMOS_CURR_W(0x1) /* 3.5 mA, 100 Ohm */ | (
         AD9510_LVDS_CMOS_PDOWN /* Power down */);
-    _smch_ad9510_write_8 (self, AD9510_REG_LVDS_CMOS_OUT5, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_LVDS_CMOS_OUT6, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_LVDS_CMOS_OUT7, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_LVDS_CMOS_OUT5, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_LVDS_CMOS_OUT6, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_LVDS_CMOS_OUT7, data);
 
     /* Set-up clock selection (distribution mode)
      * CLK1 - power off
@@ -227,12 +278,18 @@ smch_err_e smch_ad9510_cfg_defaults (smch_ad9510_t *self)
                 ~AD9510_CLK_OPT_REFIN_PD /* Power Reference In Up*/ &
                 ~AD9510_CLK_OPT_PS_PD /* Power Prescaler Up*/ &
                 ~AD9510_CLK_OPT_SEL_CLK1 /* Select CLK2*/);
-    _smch_ad9510_write_8 (self, AD9510_REG_CLK_OPT, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_CLK_OPT, data);
+
+    err = _smch_ad9510_write_burst (self, xfers, num_xfers);
+    ASSERT_TEST(err == SMCH_SUCCESS, "Could not write AD9510 PLL configuration",
+            err_smpr_write);
 
     /* Update registers */
     _smch_ad9510_reg_update (self);
     SMCH_AD9510_WAIT_DFLT;
 
+    num_xfers = 0;
+
     /* Clock dividers OUT0 - OUT7
      * divide = off (bypassed, ratio 1)
      * duty cycle 50%
@@ -240,14 +297,14 @@ smch_err_e smch_ad9510_cfg_defaults (smch_ad9510_t *self)
      */
     data = AD9510_DIV_DCYCLE_LOW_W(0x0) | AD9510_DIV_DCYCLE_HIGH_W(0x0);
 
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV0_DCYCLE, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV1_DCYCLE, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV2_DCYCLE, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV3_DCYCLE, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV4_DCYCLE, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV5_DCYCLE, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV6_DCYCLE, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV7_DCYCLE, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV0_DCYCLE, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV1_DCYCLE, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV2_DCYCLE, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV3_DCYCLE, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV4_DCYCLE, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV5_DCYCLE, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV6_DCYCLE, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV7_DCYCLE, data);
 
     /* Clock dividers OUT0 - OUT7
      * phase offset = 0
@@ -256,18 +313,22 @@ smch_err_e smch_ad9510_cfg_defaults (smch_ad9510_t *self)
      */
     data = AD9510_DIV_BYPASS | AD9510_DIV_START_HIGH | AD9510_DIV_OPT_PHASE_W(0x0);
 
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV0_OPT, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV1_OPT, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV2_OPT, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV3_OPT, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV4_OPT, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV5_OPT, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV6_OPT, &data);
-    _smch_ad9510_write_8 (self, AD9510_REG_DIV7_OPT, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV0_OPT, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV1_OPT, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV2_OPT, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV3_OPT, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV4_OPT, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV5_OPT, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV6_OPT, data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_DIV7_OPT, data);
 
     /* Function pin is SYNCB */
     data = AD9510_FUNCTION_FUNC_SEL_W(0x1);
-    _smch_ad9510_write_8 (self, AD9510_REG_FUNCTION, &data);
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_FUNCTION, data);
+
+    err = _smch_ad9510_write_burst (self, xfers, num_xfers);
+    ASSERT_TEST(err == SMCH_SUCCESS, "Could not write AD9510 divider configuration",
+            err_smpr_write);
 
     /* Update registers */
     _smch_ad9510_reg_update (self);
@@ -275,14 +336,14 @@ smch_err_e smch_ad9510_cfg_defaults (smch_ad9510_t *self)
 
     /* Software sync */
     data |= AD9510_FUNCTION_SYNC_REG;
-    _smch_ad9510_write_8 (self, AD9510_REG_FUNCTION, &data);
+    smch_shadow_write_8 (self->shadow, AD9510_REG_FUNCTION, &data);
 
     /* Update registers */
     _smch_ad9510_reg_update (self);
     SMCH_AD9510_WAIT_DFLT;
 
     data &= ~AD9510_FUNCTION_SYNC_REG;
-    _smch_ad9510_write_8 (self, AD9510_REG_FUNCTION, &data);
+    smch_shadow_write_8 (self->shadow, AD9510_REG_FUNCTION, &data);
 
     _smch_ad9510_reg_update (self);
 
@@ -300,7 +361,7 @@ smch_err_e smch_ad9510_set_pll_a_div (smch_ad9510_t *self, uint32_t *div)
             SMCH_ERR_INV_FUNC_PARAM);
 
     uint8_t data = AD9510_PLL_A_COUNTER_W(__div);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_A_COUNTER, &data);
+    smch_shadow_write_8 (self->shadow, AD9510_REG_PLL_A_COUNTER, &data);
 
     _smch_ad9510_reg_update (self);
     /* Wait for reset to complete */
@@ -314,7 +375,7 @@ smch_err_e smch_ad9510_get_pll_a_div (smch_ad9510_t *self, uint32_t *div)
 {
     smch_err_e err = SMCH_SUCCESS;
 
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_A_COUNTER, (uint8_t *) div);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_A_COUNTER, (uint8_t *) div);
     *div = AD9510_PLL_A_COUNTER_R(*div);
 
     return err;
@@ -333,20 +394,26 @@ smch_err_e smch_ad9510_set_pll_b_div (smch_ad9510_t *self, uint32_t *div)
 
     uint8_t data = 0;
     if (__div == 0) {
-        _smch_ad9510_read_8 (self, AD9510_REG_PLL_4, &data);
+        smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_4, &data);
 
         data |= AD9510_PLL_4_B_BYPASS;
-        _smch_ad9510_write_8 (self, AD9510_REG_PLL_4, &data);
+        smch_shadow_write_8 (self->shadow, AD9510_REG_PLL_4, &data);
     }
     else {
+        smpr_xfer_t xfers [2];
+        size_t num_xfers = 0;
+
         /* Extract MSB part of the divider */
-        data = AD9510_PLL_B_MSB_COUNTER_W(__div >>
-                AD9510_PLL_B_LSB_COUNTER_SIZE);
-        _smch_ad9510_write_8 (self, AD9510_REG_PLL_B_MSB_COUNTER, &data);
+        _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_B_MSB_COUNTER,
+                AD9510_PLL_B_MSB_COUNTER_W(__div >> AD9510_PLL_B_LSB_COUNTER_SIZE));
 
         /* Extract LSB part of the divider */
-        data = AD9510_PLL_B_LSB_COUNTER_W(__div);
-        _smch_ad9510_write_8 (self, AD9510_REG_PLL_B_LSB_COUNTER, &data);
+        _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_B_LSB_COUNTER,
+                AD9510_PLL_B_LSB_COUNTER_W(__div));
+
+        err = _smch_ad9510_write_burst (self, xfers, num_xfers);
+        ASSERT_TEST(err == SMCH_SUCCESS, "Could not write PLL B divider",
+                err_smpr_write);
     }
 
     _smch_ad9510_reg_update (self);
@@ -363,17 +430,17 @@ smch_err_e smch_ad9510_get_pll_b_div (smch_ad9510_t *self, uint32_t *div)
 
     /* Check if divider is in bypass mode */
     uint8_t data = 0;
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_4, &data);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_4, &data);
 
     if (data & AD9510_PLL_4_B_BYPASS) {
         *div = 1; /* No division */
     }
     else {
-        _smch_ad9510_read_8 (self, AD9510_REG_PLL_B_MSB_COUNTER, &data);
+        smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_B_MSB_COUNTER, &data);
         /* Extract MSB part of the divider */
         *div = AD9510_PLL_B_MSB_COUNTER_R(data) << AD9510_PLL_B_LSB_COUNTER_SIZE;
 
-        _smch_ad9510_read_8 (self, AD9510_REG_PLL_B_LSB_COUNTER, &data);
+        smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_B_LSB_COUNTER, &data);
         /* Extract LSB part of the divider */
         *div |= AD9510_PLL_B_LSB_COUNTER_R(data);
     }
@@ -387,11 +454,11 @@ smch_err_e smch_ad9510_set_pll_prescaler (smch_ad9510_t *self, uint32_t *pre)
     uint32_t __pre = *pre;
 
     uint8_t data = 0;
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_4, &data);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_4, &data);
 
     data = (data & ~AD9510_PLL_4_PRESCALER_P_MASK) |
         AD9510_PLL_4_PRESCALER_P_W(__pre);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_4, &data);
+    smch_shadow_write_8 (self->shadow, AD9510_REG_PLL_4, &data);
 
     _smch_ad9510_reg_update (self);
     /* Wait for reset to complete */
@@ -404,7 +471,7 @@ smch_err_e smch_ad9510_get_pll_prescaler (smch_ad9510_t *self, uint32_t *pre)
 {
     smch_err_e err = SMCH_SUCCESS;
 
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_4, (uint8_t *) pre);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_4, (uint8_t *) pre);
     *pre = AD9510_PLL_4_PRESCALER_P_R(*pre);
 
     return err;
@@ -426,11 +493,11 @@ smch_err_e smch_ad9510_set_pll_pdown (smch_ad9510_t *self, uint32_t *pdown)
             SMCH_ERR_INV_FUNC_PARAM);
 
     uint8_t data = 0;
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_4, &data);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_4, &data);
 
     data = (data & ~AD9510_PLL_4_PLL_PDOWN_MASK) |
         AD9510_PLL_4_PLL_PDOWN_W(__pdown);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_4, &data);
+    smch_shadow_write_8 (self->shadow, AD9510_REG_PLL_4, &data);
 
     _smch_ad9510_reg_update (self);
     /* Wait for reset to complete */
@@ -444,7 +511,7 @@ smch_err_e smch_ad9510_get_pll_pdown (smch_ad9510_t *self, uint32_t *pdown)
 {
     smch_err_e err = SMCH_SUCCESS;
 
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_4, (uint8_t *) pdown);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_4, (uint8_t *) pdown);
     *pdown = AD9510_PLL_4_PLL_PDOWN_R(*pdown);
 
     return err;
@@ -456,11 +523,11 @@ smch_err_e smch_ad9510_set_mux_status (smch_ad9510_t *self, uint32_t *mux)
     uint32_t __mux = *mux;
 
     uint8_t data = 0;
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_2, &data);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_2, &data);
 
     data = (data & ~AD9510_PLL_2_MUX_SEL_MASK) |
         AD9510_PLL_2_MUX_SEL_W(__mux);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_2, &data);
+    smch_shadow_write_8 (self->shadow, AD9510_REG_PLL_2, &data);
 
     _smch_ad9510_reg_update (self);
     /* Wait for reset to complete */
@@ -474,7 +541,7 @@ smch_err_e smch_ad9510_get_mux_status (smch_ad9510_t *self, uint32_t *mux)
     smch_err_e err = SMCH_SUCCESS;
 
     uint8_t data = 0;
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_2, &data);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_2, &data);
     *mux = AD9510_PLL_2_MUX_SEL_R(data);
 
     return err;
@@ -489,11 +556,16 @@ smch_err_e smch_ad9510_set_r_div (smch_ad9510_t *self, uint32_t *div)
             "PLL R divider is out of range", err_smpr_write,
             SMCH_ERR_INV_FUNC_PARAM);
 
-    uint8_t data = AD9510_PLL_R_MSB_COUNTER_W(__div >>
-            AD9510_PLL_R_LSB_COUNTER_SIZE);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_R_MSB_COUNTER, &data);
-    data = AD9510_PLL_R_LSB_COUNTER_W(__div);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_R_LSB_COUNTER, &data);
+    smpr_xfer_t xfers [2];
+    size_t num_xfers = 0;
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_R_MSB_COUNTER,
+            AD9510_PLL_R_MSB_COUNTER_W(__div >> AD9510_PLL_R_LSB_COUNTER_SIZE));
+    _smch_ad9510_xfer_add (self, xfers, &num_xfers, AD9510_REG_PLL_R_LSB_COUNTER,
+            AD9510_PLL_R_LSB_COUNTER_W(__div));
+
+    err = _smch_ad9510_write_burst (self, xfers, num_xfers);
+    ASSERT_TEST(err == SMCH_SUCCESS, "Could not write PLL R divider",
+            err_smpr_write);
 
     _smch_ad9510_reg_update (self);
     /* Wait for reset to complete */
@@ -508,11 +580,11 @@ smch_err_e smch_ad9510_get_r_div (smch_ad9510_t *self, uint32_t *div)
     smch_err_e err = SMCH_SUCCESS;
 
     uint8_t data = 0;
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_R_MSB_COUNTER, &data);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_R_MSB_COUNTER, &data);
     /* Extract MSB part of the divider */
     *div = AD9510_PLL_R_MSB_COUNTER_R(data) << AD9510_PLL_R_LSB_COUNTER_SIZE;
 
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_R_LSB_COUNTER, &data);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_R_LSB_COUNTER, &data);
     /* Extract LSB part of the divider */
     *div |= AD9510_PLL_R_LSB_COUNTER_R(data);
 
@@ -535,13 +607,13 @@ smch_err_e smch_ad9510_set_cp_current (smch_ad9510_t *self, uint32_t *cp_current
     /* If we are here, cp_current has one of the possible CP current
      * values. Just read the register and write the new CP value */
     uint8_t data = 0;
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_3, &data);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_3, &data);
 
     data = (data & ~AD9510_PLL_3_CP_CURRENT_MASK) |
         /* Get the respective code to be written in the register */
         AD9510_PLL_3_CP_CURRENT_W(
             __cp_current/AD9510_PLL3_CP_CURRENT_MIN - 1);
-    _smch_ad9510_write_8 (self, AD9510_REG_PLL_3, &data);
+    smch_shadow_write_8 (self->shadow, AD9510_REG_PLL_3, &data);
 
     _smch_ad9510_reg_update (self);
     /* Wait for reset to complete */
@@ -555,7 +627,7 @@ smch_err_e smch_ad9510_get_cp_current (smch_ad9510_t *self, uint32_t *cp_current
 {
     smch_err_e err = SMCH_SUCCESS;
 
-    _smch_ad9510_read_8 (self, AD9510_REG_PLL_3, (uint8_t *) cp_current);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_PLL_3, (uint8_t *) cp_current);
     /* Get the CP current in uA */
     *cp_current = (AD9510_PLL_3_CP_CURRENT_R(*cp_current) + 1) *
         AD9510_PLL3_CP_CURRENT_MIN;
@@ -586,7 +658,7 @@ smch_err_e smch_ad9510_set_outputs (smch_ad9510_t *self, uint32_t *out_en)
     for (i = 0; i < AD9510_NUM_LVPECL_OUTPUTS; ++i, __out_en >>=
             AD9510_OUTPUT_EN_LSB_SIZE) {
 
-        _smch_ad9510_read_8 (self, AD9510_REG_OUTPUT_START+i, &data);
+        smch_shadow_read_8 (self->shadow, AD9510_REG_OUTPUT_START+i, &data);
 
         /* Output disabled */
         if ((__out_en & AD9510_OUTPUT_EN_LSB_MASK) == 0) {
@@ -602,14 +674,14 @@ smch_err_e smch_ad9510_set_outputs (smch_ad9510_t *self, uint32_t *out_en)
             data = (data & ~AD9510_LVPECL_OUT_PDOWN_MASK) |
                 AD9510_LVPECL_OUT_PDOWN_W(0x00); /* Power up */
         }
-        _smch_ad9510_write_8 (self, AD9510_REG_OUTPUT_START+i, &data);
+        smch_shadow_write_8 (self->shadow, AD9510_REG_OUTPUT_START+i, &data);
     }
 
     /* LVDS/CMOS Outputs */
     for ( ; i < AD9510_NUM_OUTPUTS; ++i, __out_en >>=
             AD9510_OUTPUT_EN_LSB_SIZE) {
         data = 0;
-        _smch_ad9510_read_8 (self, AD9510_REG_OUTPUT_START+i, &data);
+        smch_shadow_read_8 (self->shadow, AD9510_REG_OUTPUT_START+i, &data);
 
         /* Output disabled */
         if ((__out_en & AD9510_OUTPUT_EN_LSB_MASK) == 0) {
@@ -623,7 +695,7 @@ smch_err_e smch_ad9510_set_outputs (smch_ad9510_t *self, uint32_t *out_en)
                     "[sm_ch:ad9510] Output #%u is going to be enabled\n", i);
             data &= ~AD9510_LVDS_CMOS_PDOWN;
         }
-        _smch_ad9510_write_8 (self, AD9510_REG_OUTPUT_START+i, &data);
+        smch_shadow_write_8 (self->shadow, AD9510_REG_OUTPUT_START+i, &data);
     }
 
     _smch_ad9510_reg_update (self);
@@ -643,7 +715,7 @@ smch_err_e smch_ad9510_get_outputs (smch_ad9510_t *self, uint32_t *out_en)
     uint32_t i;
     /* LVPECL outputs */
     for (i = 0; i < AD9510_NUM_LVPECL_OUTPUTS; ++i) {
-        _smch_ad9510_read_8 (self, AD9510_REG_OUTPUT_START+i, &data);
+        smch_shadow_read_8 (self->shadow, AD9510_REG_OUTPUT_START+i, &data);
 
         /* Output enable */
         if (AD9510_LVPECL_OUT_PDOWN_R(data) == 0x0 /* Enabled */) {
@@ -653,7 +725,7 @@ smch_err_e smch_ad9510_get_outputs (smch_ad9510_t *self, uint32_t *out_en)
 
     /* LVDS/CMOS Outputs */
     for ( ; i < AD9510_NUM_OUTPUTS; ++i) {
-        _smch_ad9510_read_8 (self, AD9510_REG_OUTPUT_START+i, &data);
+        smch_shadow_read_8 (self->shadow, AD9510_REG_OUTPUT_START+i, &data);
 
         /* Output enabled */
         if ((data & AD9510_LVDS_CMOS_PDOWN) == 0) {
@@ -675,7 +747,7 @@ smch_err_e smch_ad9510_set_pll_clk_sel (smch_ad9510_t *self, uint32_t *clk_num)
             SMCH_ERR_INV_FUNC_PARAM);
 
     uint8_t data = 0;
-    _smch_ad9510_read_8 (self, AD9510_REG_CLK_OPT, &data);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_CLK_OPT, &data);
 
     switch (__clk_num) {
         case AD9510_PLL_CLK1_SEL:
@@ -688,7 +760,7 @@ smch_err_e smch_ad9510_set_pll_clk_sel (smch_ad9510_t *self, uint32_t *clk_num)
             data |= AD9510_CLK_OPT_SEL_CLK1;
     }
 
-    _smch_ad9510_write_8 (self, AD9510_REG_CLK_OPT, &data);
+    smch_shadow_write_8 (self->shadow, AD9510_REG_CLK_OPT, &data);
 
     _smch_ad9510_reg_update (self);
     /* Wait for reset to complete */
@@ -703,7 +775,7 @@ smch_err_e smch_ad9510_get_pll_clk_sel (smch_ad9510_t *self, uint32_t *clk_num)
     smch_err_e err = SMCH_SUCCESS;
 
     uint8_t data = 0;
-    _smch_ad9510_read_8 (self, AD9510_REG_CLK_OPT, &data);
+    smch_shadow_read_8 (self->shadow, AD9510_REG_CLK_OPT, &data);
 
     if (data & AD9510_CLK_OPT_SEL_CLK1) {
         *clk_num = AD9510_PLL_CLK1_SEL;
@@ -749,10 +821,27 @@ static smch_err_e _smch_ad9510_init (smch_ad9510_t *self)
     /* Wait for reset to complete */
     SMCH_AD9510_WAIT_DFLT;
 
+    /* Registers are back to their reset values */
+    smch_shadow_invalidate (self->shadow);
+
 err_smpr_write:
     return err;
 }
 
+static smch_err_e _smch_ad9510_shadow_read (void *owner, uint8_t addr,
+        uint8_t *data)
+{
+    return (_smch_ad9510_read_8 ((smch_ad9510_t *) owner, addr, data) ==
+            sizeof(uint8_t))? SMCH_SUCCESS : SMCH_ERR_RW_SMPR;
+}
+
+static smch_err_e _smch_ad9510_shadow_write (void *owner, uint8_t addr,
+        const uint8_t *data)
+{
+    return (_smch_ad9510_write_8 ((smch_ad9510_t *) owner, addr, data) ==
+            sizeof(uint8_t))? SMCH_SUCCESS : SMCH_ERR_RW_SMPR;
+}
+
 static ssize_t _smch_ad9510_write_8 (smch_ad9510_t *self, uint8_t addr,
         const uint8_t *data)
 {
@@ -784,6 +873,54 @@ err_smpr_write:
     return err;
 }
 
+/* Append a burst transfer writing data to addr, unless the chip already
+ * holds it */
+static void _smch_ad9510_xfer_add (smch_ad9510_t *self, smpr_xfer_t *xfers,
+        size_t *num_xfers, uint8_t addr, uint8_t data)
+{
+    size_t first = 0;
+    if (smch_shadow_diff (self->shadow, addr, &data, sizeof (data), &first) == 0) {
+        return;
+    }
+
+    /* Same 24-bit cycle as _smch_ad9510_write_8 () */
+    smpr_xfer_t *xfer = &xfers [(*num_xfers)++];
+    xfer->offs = ~AD9510_HDR_RW & (
+                AD9510_HDR_BT_W(0x0) |
+                AD9510_HDR_ADDR_W(addr)
+            );
+    xfer->data = AD9510_DATA_W(data);
+    xfer->read = false;
+
+    /* Dropped by _smch_ad9510_write_burst () if the burst fails */
+    smch_shadow_update (self->shadow, addr, &data, sizeof (data));
+}
+
+/* Write a list of registers in a single SPI burst */
+static smch_err_e _smch_ad9510_write_burst (smch_ad9510_t *self,
+        smpr_xfer_t *xfers, size_t num_xfers)
+{
+    smch_err_e err = SMCH_SUCCESS;
+    size_t __addr_size = AD9510_INSTADDR_SIZE/SMPR_BYTE_2_BIT;
+    size_t __data_size = AD9510_DATA_SIZE/SMPR_BYTE_2_BIT;
+
+    if (num_xfers == 0) {
+        goto err_smpr_write;
+    }
+
+    ssize_t smpr_err = smpr_burst (self->spi, __addr_size, __data_size,
+            xfers, num_xfers);
+    if (smpr_err < 0 || (size_t) smpr_err != num_xfers) {
+        /* We don't know how far the burst went */
+        smch_shadow_invalidate (self->shadow);
+    }
+    ASSERT_TEST(smpr_err >= 0 && (size_t) smpr_err == num_xfers,
+            "Could not write burst to SMPR", err_smpr_write, SMCH_ERR_RW_SMPR);
+
+err_smpr_write:
+    return err;
+}
+
 static ssize_t _smch_ad9510_read_8 (smch_ad9510_t *self, uint8_t addr,
         uint8_t *data)
 {
@@ -38,9 +38,21 @@
 
 struct _smch_isla216p_t {
     smpr_t *proto;                    /* PROTO protocol object */
+    smch_shadow_t *shadow;            /* Register shadow */
+};
+
+/* Registers read back on resync */
+static const uint8_t smch_isla216p_shadow_regs [] = {
+    ISLA216P_REG_CHIPID, ISLA216P_REG_CHIPVER, ISLA216P_REG_NAPSLP,
+    ISLA216P_REG_MODESADC1, ISLA216P_REG_CLKDIV, ISLA216P_REG_OUTMODEA,
+    ISLA216P_REG_TESTIO
 };
 
 static smch_err_e _smch_isla216p_init (smch_isla216p_t *self);
+static smch_err_e _smch_isla216p_shadow_read (void *owner, uint8_t addr,
+        uint8_t *data);
+static smch_err_e _smch_isla216p_shadow_write (void *owner, uint8_t addr,
+        const uint8_t *data);
 /* Read/Write 1-byte functions */
 static ssize_t _smch_isla216p_write_8 (smch_isla216p_t *self, uint8_t addr,
         const uint8_t *data);
@@ -66,12 +78,31 @@ smch_isla216p_t * smch_isla216p_new (smio_t *parent, uint64_t base,
 
     DBE_DEBUG (DBG_SM_CH | DBG_LVL_INFO, "[sm_ch:isla216p] Created instance of SMCH\n");
 
+    self->shadow = smch_shadow_new (self, _smch_isla216p_shadow_read,
+            _smch_isla216p_shadow_write);
+    ASSERT_ALLOC(self->shadow, err_shadow_alloc);
+    /* Soft reset and calibration status change on their own */
+    smch_shadow_set_volatile (self->shadow, ISLA216P_REG_PORTCONFIG, 1);
+    smch_shadow_set_volatile (self->shadow, ISLA216P_REG_CALSTATUS, 1);
+    smch_shadow_track (self->shadow, smch_isla216p_shadow_regs,
+            ARRAY_SIZE(smch_isla216p_shadow_regs));
+
     smch_err_e err =  _smch_isla216p_init (self);
     ASSERT_TEST(err == SMCH_SUCCESS, "Could not initialize ISLA216P", err_smch_init);
 
+    /* Registers that can not be read back now are filled on first access */
+    err = smch_shadow_resync (self->shadow);
+    if (err != SMCH_SUCCESS) {
+        DBE_DEBUG (DBG_SM_CH | DBG_LVL_WARN, "[sm_ch:isla216p] Could not read "
+                "ISLA216P registers. Register shadow left empty\n");
+        smch_shadow_invalidate (self->shadow);
+    }
+
     return self;
 
 err_smch_init:
+    smch_shadow_destroy (&self->shadow);
+err_shadow_alloc:
     smpr_release (self->proto);
 err_smpr_init:
     smpr_destroy (&self->proto);
@@ -89,6 +120,7 @@ smch_err_e smch_isla216p_destroy (smch_isla216p_t **self_p)
     if (*self_p) {
         smch_isla216p_t *self = *self_p;
 
+        smch_shadow_destroy (&self->shadow);
         smpr_release (self->proto);
         smpr_destroy (&self->proto);
         free (self);
@@ -101,47 +133,42 @@ smch_err_e smch_isla216p_destroy (smch_isla216p_t **self_p)
 smch_err_e smch_isla216p_write_8 (smch_isla216p_t *self, uint8_t addr,
         const uint8_t *data)
 {
-    return (_smch_isla216p_write_8 (self, addr, data) == sizeof(uint8_t))?
-        SMCH_SUCCESS : SMCH_ERR_RW_SMPR;
+    return smch_shadow_write_8 (self->shadow, addr, data);
 }
 
 smch_err_e smch_isla216p_read_8 (smch_isla216p_t *self, uint8_t addr,
         uint8_t *data)
 {
-    return (_smch_isla216p_read_8 (self, addr, data) == sizeof(uint8_t))?
-        SMCH_SUCCESS : SMCH_ERR_RW_SMPR;
+    return smch_shadow_read_8 (self->shadow, addr, data);
+}
+
+smch_err_e smch_isla216p_resync (smch_isla216p_t *self)
+{
+    return smch_shadow_resync (self->shadow);
 }
 
 smch_err_e smch_isla216p_set_test_mode (smch_isla216p_t *self, uint8_t mode)
 {
     smch_err_e err = SMCH_SUCCESS;
-    ssize_t rw_err = -1;
-
-    uint8_t data = 0;
-    rw_err = _smch_isla216p_read_8 (self, ISLA216P_REG_TESTIO, &data);
-    ASSERT_TEST(rw_err == sizeof(uint8_t), "Could not read from TESTIO register",
-            err_smpr_read, SMCH_ERR_RW_SMPR);
 
-    data = (data & ~ISLA216P_TESTIO_OUTMODE_MASK) | ISLA216P_TESTIO_OUTMODE_W(mode);
-    rw_err = _smch_isla216p_write_8 (self, ISLA216P_REG_TESTIO, &data);
-    ASSERT_TEST(rw_err == sizeof(uint8_t), "Could not write to TESTIO register",
-            err_smpr_write, SMCH_ERR_RW_SMPR);
+    err = smch_shadow_rmw_8 (self->shadow, ISLA216P_REG_TESTIO,
+            ISLA216P_TESTIO_OUTMODE_MASK, ISLA216P_TESTIO_OUTMODE_W(mode));
+    ASSERT_TEST(err == SMCH_SUCCESS, "Could not update TESTIO register",
+            err_smpr_write);
 
     SMCH_ISLA216P_WAIT_DFLT;
 
 err_smpr_write:
-err_smpr_read:
     return err;
 }
 
 smch_err_e smch_isla216p_get_chipid (smch_isla216p_t *self, uint8_t *chipid)
 {
     smch_err_e err = SMCH_SUCCESS;
-    ssize_t rw_err = -1;
 
-    rw_err = _smch_isla216p_read_8 (self, ISLA216P_REG_CHIPID, chipid);
-    ASSERT_TEST(rw_err == sizeof(uint8_t), "Could not read from CHIPID register",
-            err_smpr_read, SMCH_ERR_RW_SMPR);
+    err = smch_shadow_read_8 (self->shadow, ISLA216P_REG_CHIPID, chipid);
+    ASSERT_TEST(err == SMCH_SUCCESS, "Could not read from CHIPID register",
+            err_smpr_read);
 
     SMCH_ISLA216P_WAIT_DFLT;
 
@@ -152,11 +179,10 @@ err_smpr_read:
 smch_err_e smch_isla216p_get_chipver (smch_isla216p_t *self, uint8_t *chipver)
 {
     smch_err_e err = SMCH_SUCCESS;
-    ssize_t rw_err = -1;
 
-    rw_err = _smch_isla216p_read_8 (self, ISLA216P_REG_CHIPVER, chipver);
-    ASSERT_TEST(rw_err == sizeof(uint8_t), "Could not read from CHIPVER register",
-            err_smpr_read, SMCH_ERR_RW_SMPR);
+    err = smch_shadow_read_8 (self->shadow, ISLA216P_REG_CHIPVER, chipver);
+    ASSERT_TEST(err == SMCH_SUCCESS, "Could not read from CHIPVER register",
+            err_smpr_read);
 
     SMCH_ISLA216P_WAIT_DFLT;
 
@@ -208,6 +234,20 @@ err_smpr_write:
     return err;
 }
 
+static smch_err_e _smch_isla216p_shadow_read (void *owner, uint8_t addr,
+        uint8_t *data)
+{
+    return (_smch_isla216p_read_8 ((smch_isla216p_t *) owner, addr, data) ==
+            sizeof(uint8_t))? SMCH_SUCCESS : SMCH_ERR_RW_SMPR;
+}
+
+static smch_err_e _smch_isla216p_shadow_write (void *owner, uint8_t addr,
+        const uint8_t *data)
+{
+    return (_smch_isla216p_write_8 ((smch_isla216p_t *) owner, addr, data) ==
+            sizeof(uint8_t))? SMCH_SUCCESS : SMCH_ERR_RW_SMPR;
+}
+
 static ssize_t _smch_isla216p_write_8 (smch_isla216p_t *self, uint8_t addr,
         const uint8_t *data)
 {
@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2014 LNLS (www.lnls.br)
+ * Author: Lucas Russo <lucas.russo@lnls.br>
+ *
+ * Released according to the GNU GPL, version 3 or any later version.
+ */
+
+/* Description: Software copy of the register map of SPI/I2C chips, so
+ * read-modify-write cycles and unchanged writes do not go to the bus */
+
+#include "halcs_server.h"
+
+/* Undef ASSERT_ALLOC to avoid conflicting with other ASSERT_ALLOC */
+#ifdef ASSERT_TEST
+#undef ASSERT_TEST
+#endif
+#define ASSERT_TEST(test_boolean, err_str, err_goto_label, /* err_core */ ...) \
+    ASSERT_HAL_TEST(test_boolean, SM_CH, "[sm_ch:shadow]",          \
+            err_str, err_goto_label, /* err_core */ __VA_ARGS__)
+
+#ifdef ASSERT_ALLOC
+#undef ASSERT_ALLOC
+#endif
+#define ASSERT_ALLOC(ptr, err_goto_label, /* err_core */ ...)       \
+    ASSERT_HAL_ALLOC(ptr, SM_CH, "[sm_ch:shadow]",                  \
+            smch_err_str(SMCH_ERR_ALLOC),                           \
+            err_goto_label, /* err_core */ __VA_ARGS__)
+
+#ifdef CHECK_ERR
+#undef CHECK_ERR
+#endif
+#define CHECK_ERR(err, err_type)                                    \
+    CHECK_HAL_ERR(err, SM_CH, "[sm_ch:shadow]",                     \
+            smch_err_str (err_type))
+
+/* Register flags */
+#define SMCH_SHADOW_VALID                   (1 << 0)    /* Cached value is current */
+#define SMCH_SHADOW_VOLATILE                (1 << 1)    /* Changed by the device */
+#define SMCH_SHADOW_TRACKED                 (1 << 2)    /* Read back on resync */
+
+struct _smch_shadow_t {
+    void *owner;                                /* Chip driver instance */
+    smch_shadow_read_fp read_fp;                /* Read from device */
+    smch_shadow_write_fp write_fp;              /* Write to device */
+    uint8_t regs [SMCH_SHADOW_NUM_REGS];        /* Register values */
+    uint8_t flags [SMCH_SHADOW_NUM_REGS];       /* SMCH_SHADOW_* */
+};
+
+static bool _smch_shadow_cached (smch_shadow_t *self, uint8_t addr);
+
+/* Creates a new register shadow */
+smch_shadow_t * smch_shadow_new (void *owner, smch_shadow_read_fp read_fp,
+        smch_shadow_write_fp write_fp)
+{
+    assert (owner);
+    assert (read_fp);
+    assert (write_fp);
+
+    smch_shadow_t *self = (smch_shadow_t *) zmalloc (sizeof *self);
+    ASSERT_ALLOC(self, err_self_alloc);
+
+    self->owner = owner;
+    self->read_fp = read_fp;
+    self->write_fp = write_fp;
+
+    return self;
+
+err_self_alloc:
+    return NULL;
+}
+
+/* Destroy a register shadow */
+smch_err_e smch_shadow_destroy (smch_shadow_t **self_p)
+{
+    assert (self_p);
+
+    if (*self_p) {
+        smch_shadow_t *self = *self_p;
+
+        free (self);
+        *self_p = NULL;
+    }
+
+    return SMCH_SUCCESS;
+}
+
+smch_err_e smch_shadow_set_volatile (smch_shadow_t *self, uint8_t addr,
+        size_t num_regs)
+{
+    assert (self);
+
+    smch_err_e err = SMCH_SUCCESS;
+    ASSERT_TEST(addr + num_regs <= SMCH_SHADOW_NUM_REGS, "Register range out of bounds",
+            err_inv_range, SMCH_ERR_INV_FUNC_PARAM);
+
+    size_t i;
+    for (i = addr; i < addr + num_regs; ++i) {
+        self->flags [i] = (self->flags [i] & ~SMCH_SHADOW_VALID) | SMCH_SHADOW_VOLATILE;
+    }
+
+err_inv_range:
+    return err;
+}
+
+smch_err_e smch_shadow_track (smch_shadow_t *self, const uint8_t *addrs,
+        size_t num_addrs)
+{
+    assert (self);
+    assert (addrs);
+
+    size_t i;
+    for (i = 0; i < num_addrs; ++i) {
+        self->flags [addrs [i]] |= SMCH_SHADOW_TRACKED;
+    }
+
+    return SMCH_SUCCESS;
+}
+
+void smch_shadow_invalidate (smch_shadow_t *self)
+{
+    assert (self);
+
+    size_t i;
+    for (i = 0; i < SMCH_SHADOW_NUM_REGS; ++i) {
+        self->flags [i] &= ~SMCH_SHADOW_VALID;
+    }
+}
+
+smch_err_e smch_shadow_resync (smch_shadow_t *self)
+{
+    assert (self);
+
+    smch_err_e err = SMCH_SUCCESS;
+    smch_shadow_invalidate (self);
+
+    size_t i;
+    for (i = 0; i < SMCH_SHADOW_NUM_REGS; ++i) {
+        if (!(self->flags [i] & SMCH_SHADOW_TRACKED) ||
+                (self->flags [i] & SMCH_SHADOW_VOLATILE)) {
+            continue;
+        }
+
+        err = self->read_fp (self->owner, i, &self->regs [i]);
+        ASSERT_TEST(err == SMCH_SUCCESS, "Could not read register back from device",
+                err_read);
+        self->flags [i] |= SMCH_SHADOW_VALID;
+    }
+
+    DBE_DEBUG (DBG_SM_CH | DBG_LVL_TRACE, "[sm_ch:shadow] Register shadow resynced\n");
+
+err_read:
+    return err;
+}
+
+smch_err_e smch_shadow_read_8 (smch_shadow_t *self, uint8_t addr, uint8_t *data)
+{
+    assert (self);
+    assert (data);
+
+    smch_err_e err = SMCH_SUCCESS;
+
+    if (_smch_shadow_cached (self, addr)) {
+        *data = self->regs [addr];
+        goto err_exit;
+    }
+
+    err = self->read_fp (self->owner, addr, data);
+    ASSERT_TEST(err == SMCH_SUCCESS, "Could not read register from device",
+            err_exit);
+
+    if (!(self->flags [addr] & SMCH_SHADOW_VOLATILE)) {
+        self->regs [addr] = *data;
+        self->flags [addr] |= SMCH_SHADOW_VALID;
+    }
+
+err_exit:
+    return err;
+}
+
+smch_err_e smch_shadow_write_8 (smch_shadow_t *self, uint8_t addr,
+        const uint8_t *data)
+{
+    assert (self);
+    assert (data);
+
+    smch_err_e err = SMCH_SUCCESS;
+
+    if (_smch_shadow_cached (self, addr) && self->regs [addr] == *data) {
+        DBE_DEBUG (DBG_SM_CH | DBG_LVL_TRACE, "[sm_ch:shadow] Skipping write "
+                "of 0x%02X to addr 0x%02X, value unchanged\n", *data, addr);
+        goto err_exit;
+    }
+
+    err = self->write_fp (self->owner, addr, data);
+    /* We don't know what the device holds now */
+    self->flags [addr] &= ~SMCH_SHADOW_VALID;
+    ASSERT_TEST(err == SMCH_SUCCESS, "Could not write register to device",
+            err_exit);
+
+    if (!(self->flags [addr] & SMCH_SHADOW_VOLATILE)) {
+        self->regs [addr] = *data;
+        self->flags [addr] |= SMCH_SHADOW_VALID;
+    }
+
+err_exit:
+    return err;
+}
+
+smch_err_e smch_shadow_rmw_8 (smch_shadow_t *self, uint8_t addr, uint8_t mask,
+        uint8_t data)
+{
+    assert (self);
+
+    uint8_t value = 0;
+    smch_err_e err = smch_shadow_read_8 (self, addr, &value);
+    ASSERT_TEST(err == SMCH_SUCCESS, "Could not get register value", err_exit);
+
+    value = (value & ~mask) | (data & mask);
+    err = smch_shadow_write_8 (self, addr, &value);
+
+err_exit:
+    return err;
+}
+
+bool smch_shadow_get (smch_shadow_t *self, uint8_t addr, uint8_t *data,
+        size_t size)
+{
+    assert (self);
+    assert (data);
+
+    size_t i;
+    for (i = 0; i < size; ++i) {
+        if (addr + i >= SMCH_SHADOW_NUM_REGS || !_smch_shadow_cached (self, addr + i)) {
+            return false;
+        }
+    }
+
+    memcpy (data, self->regs + addr, size);
+    return true;
+}
+
+void smch_shadow_update (smch_shadow_t *self, uint8_t addr, const uint8_t *data,
+        size_t size)
+{
+    assert (self);
+
+    size_t i;
+    for (i = 0; i < size && addr + i < SMCH_SHADOW_NUM_REGS; ++i) {
+        if (data == NULL || (self->flags [addr + i] & SMCH_SHADOW_VOLATILE)) {
+            self->flags [addr + i] &= ~SMCH_SHADOW_VALID;
+            continue;
+        }
+
+        self->regs [addr + i] = data [i];
+        self->flags [addr + i] |= SMCH_SHADOW_VALID;
+    }
+}
+
+size_t smch_shadow_diff (smch_shadow_t *self, uint8_t addr, const uint8_t *data,
+        size_t size, size_t *first)
+{
+    assert (self);
+    assert (data);
+    assert (first);
+
+    size_t i;
+    size_t last = 0;
+    bool found = false;
+
+    for (i = 0; i < size; ++i) {
+        if (addr + i < SMCH_SHADOW_NUM_REGS && _smch_shadow_cached (self, addr + i) &&
+                self->regs [addr + i] == data [i]) {
+            continue;
+        }
+
+        if (!found) {
+            *first = i;
+            found = true;
+        }
+        last = i;
+    }
+
+    return found ? last - *first + 1 : 0;
+}
+
+/**************** Helper Functions ***************/
+
+static bool _smch_shadow_cached (smch_shadow_t *self, uint8_t addr)
+{
+    return (self->flags [addr] & (SMCH_SHADOW_VALID | SMCH_SHADOW_VOLATILE)) ==
+        SMCH_SHADOW_VALID;
+}
@@ -49,6 +49,13 @@ struct _smch_si57x_t {
     unsigned int hs_div;            /* High Speed divider value */
     uint64_t rfreq;                 /* RFreq value */
     double frequency;               /* Output crystal frequency */
+    smch_shadow_t *shadow;          /* Register shadow */
+};
+
+/* Registers read back on resync */
+static const uint8_t smch_si57x_shadow_regs [] = {
+    SI57X_REG_HS_N1, SI57X_REG_HS_N1 + 1, SI57X_REG_HS_N1 + 2,
+    SI57X_REG_HS_N1 + 3, SI57X_REG_HS_N1 + 4, SI57X_REG_HS_N1 + 5
 };
 
 static smch_err_e _smch_si57x_write_8 (smch_si57x_t *self, uint8_t addr,
@@ -65,6 +72,11 @@ static smch_err_e _smch_si57x_read_block (smch_si57x_t *self, uint8_t addr,
 static ssize_t _smch_si57x_read_generic (smch_si57x_t *self, uint8_t addr,
         uint8_t *data, size_t size);
 
+static smch_err_e _smch_si57x_shadow_read (void *owner, uint8_t addr,
+        uint8_t *data);
+static smch_err_e _smch_si57x_shadow_write (void *owner, uint8_t addr,
+        const uint8_t *data);
+
 static smch_err_e _smch_si57x_get_divs (smch_si57x_t *self, uint64_t *rfreq,
         unsigned int *n1, unsigned int *hs_div);
 static smch_err_e _smch_si57x_get_defaults (smch_si57x_t *self, double fout);
@@ -98,9 +110,28 @@ smch_si57x_t * smch_si57x_new (smio_t *parent, uint64_t base,
     self->rfreq     = SMCH_SI57X_DFLT_RFREQ;
     self->frequency = SMCH_SI57X_DFLT_FREQUENCY;
 
+    self->shadow = smch_shadow_new (self, _smch_si57x_shadow_read,
+            _smch_si57x_shadow_write);
+    ASSERT_ALLOC(self->shadow, err_shadow_alloc);
+    /* RECALL and NEWFREQ are self-clearing */
+    smch_shadow_set_volatile (self->shadow, SI57X_REG_CONTROL, 1);
+    smch_shadow_track (self->shadow, smch_si57x_shadow_regs,
+            ARRAY_SIZE(smch_si57x_shadow_regs));
+
+    /* The oscillator might not be reachable yet. The shadow will then be
+     * filled on first access */
+    smch_err_e err = smch_shadow_resync (self->shadow);
+    if (err != SMCH_SUCCESS) {
+        DBE_DEBUG (DBG_SM_CH | DBG_LVL_WARN, "[sm_ch:si57x] Could not read "
+                "Si57x registers. Register shadow left empty\n");
+        smch_shadow_invalidate (self->shadow);
+    }
+
     DBE_DEBUG (DBG_SM_CH | DBG_LVL_INFO, "[sm_ch:si57x] Created instance of SMCH\n");
     return self;
 
+err_shadow_alloc:
+    smpr_release (self->proto);
 err_smpr_init:
     smpr_destroy (&self->proto);
 err_proto_alloc:
@@ -117,6 +148,7 @@ smch_err_e smch_si57x_destroy (smch_si57x_t **self_p)
     if (*self_p) {
         smch_si57x_t *self = *self_p;
 
+        smch_shadow_destroy (&self->shadow);
         smpr_release (self->proto);
         smpr_destroy (&self->proto);
         free (self);
@@ -129,25 +161,37 @@ smch_err_e smch_si57x_destroy (smch_si57x_t **self_p)
 smch_err_e smch_si57x_write_8 (smch_si57x_t *self, uint8_t addr,
         const uint8_t *data)
 {
-    return _smch_si57x_write_8 (self, addr, data);
+    return smch_shadow_write_8 (self->shadow, addr, data);
 }
 
 smch_err_e smch_si57x_write_block (smch_si57x_t *self, uint8_t addr,
         const uint8_t *data, size_t size)
 {
-    return _smch_si57x_write_block (self, addr, data, size);
+    smch_err_e err = _smch_si57x_write_block (self, addr, data, size);
+    smch_shadow_update (self->shadow, addr, (err == SMCH_SUCCESS)? data : NULL,
+            size);
+    return err;
 }
 
 smch_err_e smch_si57x_read_8 (smch_si57x_t *self, uint8_t addr,
         uint8_t *data)
 {
-    return _smch_si57x_read_8 (self, addr, data);
+    return smch_shadow_read_8 (self->shadow, addr, data);
 }
 
 smch_err_e smch_si57x_read_block (smch_si57x_t *self, uint8_t addr,
         uint8_t *data, size_t size)
 {
-    return _smch_si57x_read_block (self, addr, data, size);
+    smch_err_e err = _smch_si57x_read_block (self, addr, data, size);
+    if (err == SMCH_SUCCESS) {
+        smch_shadow_update (self->shadow, addr, data, size);
+    }
+    return err;
+}
+
+smch_err_e smch_si57x_resync (smch_si57x_t *self)
+{
+    return smch_shadow_resync (self->shadow);
 }
 
 smch_err_e smch_si57x_get_divs (smch_si57x_t *self, uint64_t *rfreq,
@@ -321,11 +365,17 @@ static smch_err_e _smch_si57x_get_divs (smch_si57x_t *self, uint64_t *rfreq,
     uint8_t divs[SI57X_NUM_DIV_REGS] = {0};
     smch_err_e err = SMCH_SUCCESS;
 
-    /* Read all divider and RFreq registers */
-    ssize_t smpr_err = _smch_si57x_read_generic (self, SI57X_REG_HS_N1, divs,
-            SI57X_NUM_DIV_REGS);
-    ASSERT_TEST(smpr_err == SI57X_NUM_DIV_REGS, "Could not get divider values",
-            err_exit, SMCH_ERR_RW_SMPR);
+    /* Read all divider and RFreq registers, unless we already know them */
+    if (!smch_shadow_get (self->shadow, SI57X_REG_HS_N1, divs,
+                SI57X_NUM_DIV_REGS)) {
+        ssize_t smpr_err = _smch_si57x_read_generic (self, SI57X_REG_HS_N1, divs,
+                SI57X_NUM_DIV_REGS);
+        ASSERT_TEST(smpr_err == SI57X_NUM_DIV_REGS, "Could not get divider values",
+                err_exit, SMCH_ERR_RW_SMPR);
+
+        smch_shadow_update (self->shadow, SI57X_REG_HS_N1, divs,
+                SI57X_NUM_DIV_REGS);
+    }
 
     /* Get divider values */
     *hs_div = SI57X_HS_N1_HS_R(divs[0]) + SI57X_HS_N1_HS_OFFSET;
@@ -365,6 +415,9 @@ static smch_err_e _smch_si57x_get_defaults (smch_si57x_t *self, double fout)
     /* Si57x takes up to 30ms to return to initial conditions. To be safe, use 300ms */
     SMCH_SI57X_WAIT(300000);
 
+    /* Dividers were reloaded from NVM */
+    smch_shadow_invalidate (self->shadow);
+
     /* Read dividers */
     err = _smch_si57x_get_divs (self, &self->rfreq, &self->n1, &self->hs_div);
     ASSERT_TEST(err == SMCH_SUCCESS, "Could not get divider values", err_exit);
@@ -387,6 +440,16 @@ static smch_err_e _smch_si57x_set_freq_raw (smch_si57x_t *self, uint8_t *data,
     assert (self);
     smch_err_e err = SMCH_SUCCESS;
 
+    /* Only write the registers that actually change */
+    size_t first = 0;
+    size_t span = smch_shadow_diff (self->shadow, SI57X_REG_START, data, size,
+            &first);
+    if (span == 0) {
+        DBE_DEBUG (DBG_SM_CH | DBG_LVL_INFO, "[sm_ch:si57x_set_freq_raw] "
+                "Frequency registers unchanged. Skipping update\n");
+        goto err_exit;
+    }
+
     /* Freeze DCO */
     uint8_t __data = SI57X_FREEZE_DCO;
     err = _smch_si57x_write_8 (self, SI57X_REG_FREEZE_DCO, &__data);
@@ -395,7 +458,10 @@ static smch_err_e _smch_si57x_set_freq_raw (smch_si57x_t *self, uint8_t *data,
     SMCH_SI57X_WAIT_DFLT;
 
     /* Write frequency registers to Chip (for 20ppm and 50ppm devices) */
-    err = _smch_si57x_write_block (self, SI57X_REG_START, data, size);
+    err = _smch_si57x_write_block (self, SI57X_REG_START + first, data + first,
+            span);
+    smch_shadow_update (self->shadow, SI57X_REG_START + first,
+            (err == SMCH_SUCCESS)? data + first : NULL, span);
     ASSERT_TEST(err == SMCH_SUCCESS, "Could not write frequency registers to chip",
             err_exit);
 
@@ -425,6 +491,18 @@ err_exit:
 
 /******************************* Helper Functions ****************************/
 
+static smch_err_e _smch_si57x_shadow_read (void *owner, uint8_t addr,
+        uint8_t *data)
+{
+    return _smch_si57x_read_8 ((smch_si57x_t *) owner, addr, data);
+}
+
+static smch_err_e _smch_si57x_shadow_write (void *owner, uint8_t addr,
+        const uint8_t *data)
+{
+    return _smch_si57x_write_8 ((smch_si57x_t *) owner, addr, data);
+}
+
 static smch_err_e _smch_si57x_wait_new_freq (smch_si57x_t *self)
 {
     assert (self);
@@ -43,7 +43,21 @@ struct _smio_acq_data_block_t {
 #define ACQ_NAME_FSM_STOP               "acq_fsm_stop"
 #define ACQ_OPCODE_HW_DATA_TRIG_CHAN    11
 #define ACQ_NAME_HW_DATA_TRIG_CHAN      "acq_hw_data_trig_chan"
-#define ACQ_OPCODE_END                  12
+#define ACQ_OPCODE_GET_CURVE_STREAM     12
+#define ACQ_NAME_GET_CURVE_STREAM       "acq_get_curve_stream"
+#define ACQ_OPCODE_DATA_ACQUIRE_MULTI   13
+#define ACQ_NAME_DATA_ACQUIRE_MULTI     "acq_data_acquire_multi"
+#define ACQ_OPCODE_GET_CURVE_REDUCED    14
+#define ACQ_NAME_GET_CURVE_REDUCED      "acq_get_curve_reduced"
+#define ACQ_OPCODE_GET_SAMPLES          15
+#define ACQ_NAME_GET_SAMPLES            "acq_get_samples"
+#define ACQ_OPCODE_GET_SHOT             16
+#define ACQ_NAME_GET_SHOT               "acq_get_shot"
+#define ACQ_OPCODE_CACHE_SIZE           17
+#define ACQ_NAME_CACHE_SIZE             "acq_cache_size"
+#define ACQ_OPCODE_CURVE_STREAM_CREDIT  18
+#define ACQ_NAME_CURVE_STREAM_CREDIT    "acq_curve_stream_credit"
+#define ACQ_OPCODE_END                  19
 
 /* Messaging Reply OPCODES */
 #define ACQ_REPLY_TYPE                  uint32_t
@@ -57,6 +71,51 @@ struct _smio_acq_data_block_t {
 #define ACQ_NUM_CHAN_OOR                5   /* Channel number out of range */
 #define ACQ_COULD_NOT_READ              6   /* Could not read memory block */
 #define ACQ_TRIG_TYPE                   7   /* Incompatible trigger type */
-#define ACQ_REPLY_END                   8   /* End marker */
+#define ACQ_INV_REDUCTION               8   /* Invalid decimation or reduction */
+#define ACQ_CHAN_OVERLAP                9   /* Channels share acquisition memory */
+#define ACQ_NO_STREAM                   10  /* No curve stream to the client */
+#define ACQ_REPLY_END                   11  /* End marker */
+
+/* Streamed curves. ACQ_NAME_GET_CURVE_STREAM takes a channel, a sample range
+ * and a number of block credits and replies with the size of the range in
+ * bytes, as an uint64_t. The server pushes the range in blocks of up to
+ * BLOCK_SIZE bytes, one per credit, with no further requests. The client
+ * grants more credits with ACQ_NAME_CURVE_STREAM_CREDIT as it consumes the
+ * blocks, which replies with the number of bytes still to be pushed.
+ *
+ * Each data message has the subject of the ACQ_NAME_GET_CURVE_STREAM request,
+ * prefixed by ACQ_STREAM_SUBJECT and ':', and is:
+ * frame 0: reply code (ACQ_OK)
+ * frame 1: block sequence number
+ * frame 2: number of bytes in block
+ * frame 3: data */
+#define ACQ_STREAM_SUBJECT              "ACQ_STREAM"
+#define ACQ_STREAM_MSG_SIZE             4   /* 4 frames */
+#define ACQ_STREAM_SEQ_TYPE             uint32_t
+#define ACQ_STREAM_SIZE_TYPE            uint32_t
+
+/* Reductions applied to each bucket of decimation factor samples by
+ * ACQ_NAME_GET_CURVE_REDUCED. The reduced curve has the same sample format
+ * as the channel. A single request only reduces a bounded part of the range,
+ * in whole buckets, so the client resumes it after the last bucket replied */
+#define ACQ_REDUCE_PICK                 0   /* First sample of the bucket */
+#define ACQ_REDUCE_MEAN                 1   /* Mean of each sample component */
+#define ACQ_REDUCE_MINMAX               2   /* Two samples, with the minimum and
+                                               the maximum of each component */
+#define ACQ_REDUCE_END                  3   /* End marker */
+
+/* Multi-channel acquisitions take a bit mask of channels, acquired one
+ * after the other, from the lowest to the highest, with the same
+ * parameters. An ACQ_EVENT_DONE is published for each channel. Only the
+ * skip and the software triggers are supported (ACQ_TRIG_TYPE otherwise) */
+#define ACQ_CHAN_MASK(chan)             (1 << (chan))
+
+/* Acquisition done event. This is published on the Malamute stream named
+ * after the SMIO service, with subject ACQ_EVENT_DONE. Message is:
+ * frame 0: channel
+ * frame 1: trigger address
+ * frame 2: timestamp (ms since epoch) */
+#define ACQ_EVENT_DONE                  "ACQ_DONE"
+#define ACQ_EVENT_DONE_SIZE             3   /* 3 frames */
 
 #endif
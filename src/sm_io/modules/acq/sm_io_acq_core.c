@@ -43,6 +43,12 @@ smio_acq_t * smio_acq_new (smio_t *parent, uint32_t num_samples_pre,
 
     self->acq_buf = __acq_buf[inst_id];
     self->curr_chan = 0;
+    self->acq_pending = false;
+    self->dma_failures = 0;
+    self->dma_reprobe_in = 0;
+    self->seq_chan_mask = 0;
+    self->cache_budget = (uint64_t) ACQ_CACHE_DFLT_SIZE << 20;
+    self->cache_used = 0;
 
     /* Set default value for all channels */
     for (uint32_t i = 0; i < END_CHAN_ID; i++) {
@@ -73,6 +79,8 @@ smio_err_e smio_acq_destroy (smio_acq_t **self_p)
     if (*self_p) {
         smio_acq_t *self = *self_p;
 
+        smio_acq_stream_reset (self);
+        smio_acq_cache_invalidate (self);
         self->acq_buf = NULL;
         free (self);
         *self_p = NULL;
@@ -81,3 +89,85 @@ smio_err_e smio_acq_destroy (smio_acq_t **self_p)
     return SMIO_SUCCESS;
 }
 
+
+static void _smio_acq_cache_free (smio_acq_t *self, acq_cache_t *cache)
+{
+    if (cache->data != NULL) {
+        self->cache_used -= cache->size;
+    }
+
+    free (cache->data);
+    cache->data = NULL;
+    free (cache->block_valid);
+    cache->block_valid = NULL;
+    cache->size = 0;
+}
+
+acq_cache_t *smio_acq_cache_get (smio_acq_t *self, uint32_t chan,
+        uint64_t curve_size)
+{
+    assert (self);
+    assert (chan < END_CHAN_ID);
+
+    acq_cache_t *cache = &self->cache[chan];
+
+    /* Cached curve still belongs to the last acquisition of the channel */
+    if (cache->data != NULL && cache->size == curve_size &&
+            memcmp (&cache->params, &self->acq_params[chan],
+                sizeof (cache->params)) == 0) {
+        return cache;
+    }
+
+    _smio_acq_cache_free (self, cache);
+    if (curve_size == 0 || curve_size > self->cache_budget - self->cache_used) {
+        return NULL;
+    }
+
+    uint64_t num_blocks = (curve_size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    cache->data = (uint8_t *) malloc (curve_size);
+    cache->block_valid = (uint8_t *) zmalloc (num_blocks);
+    if (cache->data == NULL || cache->block_valid == NULL) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq_core] "
+                "Could not allocate %"PRIu64 " bytes for the curve cache of "
+                "channel %u\n", curve_size, chan);
+        free (cache->data);
+        cache->data = NULL;
+        free (cache->block_valid);
+        cache->block_valid = NULL;
+        return NULL;
+    }
+
+    cache->size = curve_size;
+    cache->params = self->acq_params[chan];
+    self->cache_used += curve_size;
+
+    return cache;
+}
+
+void smio_acq_cache_invalidate (smio_acq_t *self)
+{
+    assert (self);
+
+    for (uint32_t i = 0; i < END_CHAN_ID; i++) {
+        _smio_acq_cache_free (self, &self->cache[i]);
+    }
+}
+
+void smio_acq_cache_set_budget (smio_acq_t *self, uint64_t budget)
+{
+    assert (self);
+
+    if (budget < self->cache_used) {
+        smio_acq_cache_invalidate (self);
+    }
+    self->cache_budget = budget;
+}
+
+void smio_acq_stream_reset (smio_acq_t *self)
+{
+    assert (self);
+
+    free (self->stream.client);
+    free (self->stream.subject);
+    memset (&self->stream, 0, sizeof (self->stream));
+}
@@ -15,6 +15,23 @@
  * from the FPGA firmware nothing will break, but we will loose
  * context of the error */
 #define ACQ_CORE_MULTISHOT_MEM_SIZE         2048
+/* Period for checking if a started acquisition has completed, so its done
+ * event can be published. Each check is a register read through DEVIO, so
+ * this bounds the done event latency without hogging DEVIO */
+#define ACQ_DONE_POLL_INTERVAL              10          /* in ms */
+/* Maximum range of a curve reduced by a single ACQ_NAME_GET_CURVE_REDUCED
+ * request. Larger ranges are reduced by resuming the request */
+#define ACQ_REDUCE_MAX_SIZE                 (8*BLOCK_SIZE) /* in bytes */
+/* Default memory budget of the curve cache, per ACQ SMIO. Enough for a
+ * few full curves of the usual acquisitions. ACQ_NAME_CACHE_SIZE changes it,
+ * or disables the cache with 0 */
+#define ACQ_CACHE_DFLT_SIZE                 32          /* in MiB */
+/* After a failed DMA read, memory is read with regular block reads and DMA
+ * is tried again after this many of them. The interval doubles on every
+ * consecutive failure, up to ACQ_DMA_REPROBE_MAX_READS, so DEVIOs without
+ * DMA (e.g., Ethernet boards) rarely pay for a failed attempt */
+#define ACQ_DMA_REPROBE_READS               16
+#define ACQ_DMA_REPROBE_MAX_READS           4096
 
 typedef enum {
     TYPE_ACQ_CORE_SKIP=0,
@@ -35,9 +52,43 @@ typedef struct {
     uint32_t trig_addr;
 } acq_params_t;
 
+/* Last completed curve of a channel, kept in host memory so readers don't
+ * go to the acquisition memory again. Filled block by block, as read */
+typedef struct {
+    uint8_t *data;                          /* Curve, from its first sample */
+    uint8_t *block_valid;                   /* One flag per BLOCK_SIZE block */
+    uint64_t size;                          /* Curve size in bytes */
+    acq_params_t params;                    /* Acquisition the curve belongs to */
+} acq_cache_t;
+
+/* Curve range being pushed to a client by ACQ_NAME_GET_CURVE_STREAM. Blocks
+ * are only sent against the credits granted by the client */
+typedef struct {
+    char *client;                           /* Address of the client. NULL if
+                                               there is no stream */
+    char *subject;                          /* Subject of the stream messages */
+    uint32_t chan;                          /* Channel being streamed */
+    uint64_t offset;                        /* Curve offset of the next block */
+    uint64_t bytes_left;                    /* Bytes still to be sent */
+    ACQ_STREAM_SEQ_TYPE seq;                /* Sequence number of the next block */
+    uint32_t credits;                       /* Blocks the client is ready for */
+} acq_stream_t;
+
 typedef struct {
     acq_params_t acq_params[END_CHAN_ID];   /* Parameters for each channel */
     uint32_t curr_chan;                     /* Current channel being acquired */
+    bool acq_pending;                       /* Acquisition started and its done
+                                               event was not published yet */
+    uint32_t dma_failures;                  /* Consecutive failed DMA reads */
+    uint32_t dma_reprobe_in;                /* Block reads left before DMA is
+                                               tried again. 0 uses DMA */
+    uint32_t seq_chan_mask;                 /* Channels of a sequence still to
+                                               be acquired */
+    acq_params_t seq_params;                /* Parameters of the sequence */
+    acq_cache_t cache[END_CHAN_ID];         /* Curve cache of each channel */
+    uint64_t cache_budget;                  /* Curve cache memory budget */
+    uint64_t cache_used;                    /* Curve cache memory in use */
+    acq_stream_t stream;                    /* Curve stream in progress */
     const acq_buf_t *acq_buf;               /* Channel properties */
 } smio_acq_t;
 
@@ -49,4 +100,16 @@ smio_acq_t * smio_acq_new (smio_t *parent, uint32_t num_samples_pre,
 /* Destroys the smio realizationn */
 smio_err_e smio_acq_destroy (smio_acq_t **self_p);
 
+/* Returns the curve cache of channel chan, if it holds the last acquisition
+ * of the channel, or a new empty one for a curve of curve_size bytes.
+ * Returns NULL if the curve does not fit in the cache budget */
+acq_cache_t *smio_acq_cache_get (smio_acq_t *self, uint32_t chan,
+        uint64_t curve_size);
+/* Drops the cached curves of all channels */
+void smio_acq_cache_invalidate (smio_acq_t *self);
+/* Sets the curve cache memory budget, in bytes. 0 disables the cache */
+void smio_acq_cache_set_budget (smio_acq_t *self, uint64_t budget);
+/* Drops the curve stream in progress, if any */
+void smio_acq_stream_reset (smio_acq_t *self);
+
 #endif
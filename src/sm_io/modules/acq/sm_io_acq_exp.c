@@ -55,6 +55,18 @@
 #define ACQ_CORE_COMPLETE_VALUE (ACQ_CORE_STA_FSM_STATE_W(0x1) | ACQ_CORE_STA_FSM_ACQ_DONE | \
                                     ACQ_CORE_STA_FC_TRANS_DONE | ACQ_CORE_STA_DDR3_TRANS_DONE)
 
+/* Samples are made of up to 8 signed components (e.g., MIXIQ: I/Q of 4
+ * antennas). See acq_chan.h */
+#define ACQ_SAMPLE_MAX_ELEMS    8
+
+/* Reduction state of the decimation bucket being built */
+typedef struct {
+    uint32_t count;
+    int64_t sum [ACQ_SAMPLE_MAX_ELEMS];
+    int64_t min [ACQ_SAMPLE_MAX_ELEMS];
+    int64_t max [ACQ_SAMPLE_MAX_ELEMS];
+} acq_bucket_t;
+
 static int _acq_check_status (SMIO_OWNER_TYPE *self, uint32_t status_mask,
         uint32_t status_value);
 static int _acq_set_trigger_type (SMIO_OWNER_TYPE *self, uint32_t trigger_type);
@@ -64,42 +76,77 @@ static uint64_t _acq_get_start_address (uint64_t acq_core_trig_addr,
         uint64_t end_mem_space_addr);
 static uint64_t _acq_get_read_block_addr (uint64_t start_addr, uint64_t offset,
         uint64_t channel_start_addr, uint64_t end_mem_space_addr);
+static int _acq_send_stream_block (mlm_client_t *worker, acq_stream_t *stream,
+        zframe_t **data_frm_p);
+static ssize_t _acq_read_mem (SMIO_OWNER_TYPE *self, smio_acq_t *acq,
+        uint64_t addr, size_t size, uint32_t *data);
+static ssize_t _acq_read_curve (SMIO_OWNER_TYPE *self, smio_acq_t *acq,
+        uint32_t chan, uint64_t offset, size_t size, uint8_t *data);
 
 /************************************************************/
 /***************** Specific ACQ Operations ******************/
 /************************************************************/
 
-static int _acq_data_acquire (void *owner, void *args, void *ret)
+/* Returns the lowest channel set in chan_mask, which must not be empty */
+static uint32_t _acq_seq_next_chan (uint32_t chan_mask)
 {
-    (void) ret;
-    assert (owner);
-    assert (args);
-    int err = -ACQ_OK;
+    uint32_t chan = 0;
+    while (!(chan_mask & (1 << chan))) {
+        ++chan;
+    }
+    return chan;
+}
 
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] "
-            "Calling _acq_data_acquire\n");
-    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
-    smio_acq_t *acq = smio_get_handler (self);
-    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
-            err_get_acq_handler, -ACQ_ERR);
+/* The acquisition core has a single channel selector, so the channels of a
+ * sequence are armed one after the other and never wait for the same
+ * trigger. Only triggers the sequence can drive by itself are supported:
+ * none at all (skip) or the software trigger, which the sequence fires for
+ * every channel after the first one */
+static bool _acq_seq_trigger_supported (uint32_t trigger_type)
+{
+    return trigger_type == TYPE_ACQ_CORE_SKIP || trigger_type == TYPE_ACQ_CORE_SW;
+}
 
-    /* First step is to check if the FPGA is already doing an acquisition. If it
-     * is, then return an error. Otherwise proceed normally. */
-    err = _acq_check_status (self, ACQ_CORE_IDLE_MASK, ACQ_CORE_IDLE_VALUE);
-    ASSERT_TEST(err == -ACQ_OK, "Previous acquisition in progress. "
-            "New acquisition not started", err_acq_not_completed);
+/* Returns true if any two channels in chan_mask have overlapping regions
+ * in the acquisition memory. Acquiring them in sequence would overwrite
+ * the data of the channels acquired first */
+static bool _acq_seq_chans_overlap (smio_acq_t *acq, uint32_t chan_mask)
+{
+    for (uint32_t i = 0; i < SMIO_ACQ_NUM_CHANNELS; ++i) {
+        if (!(chan_mask & (1 << i))) {
+            continue;
+        }
 
-    /* Message is:
-     * frame 0: operation code
-     * frame 1: number of pre-trigger samples
-     * frame 2: number of post-trigger samples
-     * frame 3: number of shots
-     * frame 4: channel                 */
-    uint32_t num_samples_pre = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
-    uint32_t num_samples_post = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
-    uint32_t num_shots = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
-    uint32_t chan = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+        uint64_t start_i = acq->acq_buf[i].start_addr;
+        uint64_t end_i = start_i + (uint64_t) acq->acq_buf[i].max_samples*
+            acq->acq_buf[i].sample_size;
+
+        for (uint32_t j = i+1; j < SMIO_ACQ_NUM_CHANNELS; ++j) {
+            if (!(chan_mask & (1 << j))) {
+                continue;
+            }
+
+            uint64_t start_j = acq->acq_buf[j].start_addr;
+            uint64_t end_j = start_j + (uint64_t) acq->acq_buf[j].max_samples*
+                acq->acq_buf[j].sample_size;
+
+            if (start_i < end_j && start_j < end_i) {
+                DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] data_acquire_multi: "
+                        "Channels %u and %u share acquisition memory\n", i, j);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
 
+/* Check if an acquisition with the given parameters can be started on
+ * channel chan */
+static int _acq_check_params (smio_acq_t *acq, uint32_t num_samples_pre,
+        uint32_t num_samples_post, uint32_t num_shots, uint32_t chan,
+        uint32_t trigger_type)
+{
     /* channel required is out of the limit */
     if (chan > SMIO_ACQ_NUM_CHANNELS-1) {
         DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] data_acquire: "
@@ -130,15 +177,38 @@ static int _acq_data_acquire (void *owner, void *args, void *ret)
         return -ACQ_NUM_SAMPLES_OOR;
     }
 
+    if (trigger_type == TYPE_ACQ_CORE_SKIP && num_samples_post > 0) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] data_acquire: "
+                "Incompatible trigger type. Post trigger samples is greater than 0\n");
+        return -ACQ_TRIG_TYPE;
+    }
+
+    return -ACQ_OK;
+}
+
+/* Program the acquisition core and start an acquisition of a single
+ * channel */
+static int _acq_start (SMIO_OWNER_TYPE *self, smio_acq_t *acq,
+        uint32_t num_samples_pre, uint32_t num_samples_post, uint32_t num_shots,
+        uint32_t chan)
+{
+    int err = -ACQ_OK;
+
+    /* First step is to check if the FPGA is already doing an acquisition. If it
+     * is, then return an error. Otherwise proceed normally. */
+    err = _acq_check_status (self, ACQ_CORE_IDLE_MASK, ACQ_CORE_IDLE_VALUE);
+    ASSERT_TEST(err == -ACQ_OK, "Previous acquisition in progress. "
+            "New acquisition not started", err_acq_not_completed);
+
     /* If skip trigger is set, we must set post_trigger_samples to 0 */
     uint32_t trigger_type = 0;
     err = _acq_get_trigger_type (self, &trigger_type);
     ASSERT_TEST(err == -ACQ_OK, "Could not check for trigger type",
             err_acq_get_trig);
-    if (trigger_type == TYPE_ACQ_CORE_SKIP && num_samples_post > 0) {
-        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] data_acquire: "
-                "Incompatible trigger type. Post trigger samples is greater than 0\n");
-        return -ACQ_TRIG_TYPE;
+    err = _acq_check_params (acq, num_samples_pre, num_samples_post, num_shots,
+            chan, trigger_type);
+    if (err != -ACQ_OK) {
+        return err;
     }
 
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] data_acquire:\n"
@@ -153,11 +223,22 @@ static int _acq_data_acquire (void *owner, void *args, void *ret)
             acq->acq_params[chan].num_samples_post,
             acq->acq_params[chan].num_shots);
 
+    /* The new acquisition overwrites the acquisition memory, which is
+     * shared between channels */
+    smio_acq_cache_invalidate (acq);
+    smio_acq_stream_reset (acq);
+
+    /* All of the acquisition registers are programmed in a single
+     * transaction, so we pay for only one DEVIO round trip and no other
+     * SMIO can interleave accesses with ours */
+    smio_thsafe_txn_t txn;
+    smio_thsafe_txn_init (&txn);
+
     /* Setting the number of shots */
     uint32_t acq_core_shots = ACQ_CORE_SHOTS_NB_W(num_shots);
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] data_acquire: "
             "Number of shots = %u\n", acq_core_shots);
-    smio_thsafe_client_write_32 (self, ACQ_CORE_REG_SHOTS, &acq_core_shots);
+    smio_thsafe_txn_write_32 (self, &txn, ACQ_CORE_REG_SHOTS, acq_core_shots);
 
     /* FIXME FPGA Firmware requires number of samples to be divisible by
      * acquisition channel sample size */
@@ -179,13 +260,13 @@ static int _acq_data_acquire (void *owner, void *args, void *ret)
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] data_acquire: "
             "Number of pre-trigger samples (aligned to sample size) = %u\n",
             num_samples_pre_aligned);
-    smio_thsafe_client_write_32 (self, ACQ_CORE_REG_PRE_SAMPLES, &num_samples_pre_aligned);
+    smio_thsafe_txn_write_32 (self, &txn, ACQ_CORE_REG_PRE_SAMPLES, num_samples_pre_aligned);
 
     /* Post trigger samples */
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] data_acquire: "
             "Number of post-trigger samples = %u\n",
             num_samples_post_aligned);
-    smio_thsafe_client_write_32 (self, ACQ_CORE_REG_POST_SAMPLES, &num_samples_post_aligned);
+    smio_thsafe_txn_write_32 (self, &txn, ACQ_CORE_REG_POST_SAMPLES, num_samples_post_aligned);
 
     /* DDR3 start address. Byte addressed */
     uint32_t start_addr = (uint32_t) acq->acq_buf[chan].start_addr;
@@ -194,38 +275,162 @@ static int _acq_data_acquire (void *owner, void *args, void *ret)
     /* Start address */
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] data_acquire: "
             "DDR3 start address: 0x%08x\n", start_addr);
-    smio_thsafe_client_write_32 (self, ACQ_CORE_REG_DDR3_START_ADDR, &start_addr);
+    smio_thsafe_txn_write_32 (self, &txn, ACQ_CORE_REG_DDR3_START_ADDR, start_addr);
 
     /* End address */
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] data_acquire: "
             "DDR3 end address: 0x%08x\n", end_addr);
-    smio_thsafe_client_write_32 (self, ACQ_CORE_REG_DDR3_END_ADDR, &end_addr);
+    smio_thsafe_txn_write_32 (self, &txn, ACQ_CORE_REG_DDR3_END_ADDR, end_addr);
 
     /* Prepare acquisition channel control */
     uint32_t acq_chan_ctl = 0;
-    smio_thsafe_client_read_32 (self, ACQ_CORE_REG_ACQ_CHAN_CTL, &acq_chan_ctl);
-    acq_chan_ctl = (acq_chan_ctl & ~ACQ_CORE_ACQ_CHAN_CTL_WHICH_MASK) |
-         ACQ_CORE_ACQ_CHAN_CTL_WHICH_W(chan);
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] data_acquire: "
-            "Channel control register is: 0x%08x\n",
-            acq_chan_ctl);
-    smio_thsafe_client_write_32 (self, ACQ_CORE_REG_ACQ_CHAN_CTL, &acq_chan_ctl);
+    smio_thsafe_txn_rmw_32 (self, &txn, ACQ_CORE_REG_ACQ_CHAN_CTL,
+            ACQ_CORE_ACQ_CHAN_CTL_WHICH_MASK, ACQ_CORE_ACQ_CHAN_CTL_WHICH_W(chan),
+            &acq_chan_ctl);
 
     /* Starting acquisition... */
-    uint32_t acq_core_ctl_reg = 0;
-    smio_thsafe_client_read_32 (self, ACQ_CORE_REG_CTL, &acq_core_ctl_reg);
-    acq_core_ctl_reg |= ACQ_CORE_CTL_FSM_START_ACQ;
-    smio_thsafe_client_write_32 (self, ACQ_CORE_REG_CTL, &acq_core_ctl_reg);
+    smio_thsafe_txn_rmw_32 (self, &txn, ACQ_CORE_REG_CTL,
+            ACQ_CORE_CTL_FSM_START_ACQ, ACQ_CORE_CTL_FSM_START_ACQ, NULL);
+
+    ssize_t txn_ret = smio_thsafe_client_txn (self, &txn);
+    ASSERT_TEST(txn_ret >= 0, "Could not start acquisition", err_acq_txn,
+            -ACQ_ERR);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] data_acquire: "
+            "Previous channel control register was: 0x%08x\n",
+            acq_chan_ctl);
 
     /* If we are here, the FPGA is acquiring samples from the
-     * specified channel. Set current channel field */
+     * specified channel. Set current channel field and arm the done
+     * event */
     acq->curr_chan = chan;
+    acq->acq_pending = true;
 
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] data_acquire: "
             "Acquisition Started!\n");
 
     return -ACQ_OK;
 
+err_acq_txn:
+err_acq_get_trig:
+err_acq_not_completed:
+    return err;
+}
+
+static int _acq_data_acquire (void *owner, void *args, void *ret)
+{
+    (void) ret;
+    assert (owner);
+    assert (args);
+    int err = -ACQ_OK;
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] "
+            "Calling _acq_data_acquire\n");
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_acq_t *acq = smio_get_handler (self);
+    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
+            err_get_acq_handler, -ACQ_ERR);
+
+    /* Message is:
+     * frame 0: operation code
+     * frame 1: number of pre-trigger samples
+     * frame 2: number of post-trigger samples
+     * frame 3: number of shots
+     * frame 4: channel                 */
+    uint32_t num_samples_pre = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+    uint32_t num_samples_post = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t num_shots = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t chan = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+
+    /* The acquisition core is briefly idle between the channels of a
+     * sequence. Don't let a new acquisition in */
+    ASSERT_TEST(acq->seq_chan_mask == 0, "Acquisition sequence in progress. "
+            "New acquisition not started", err_acq_not_completed,
+            -ACQ_NOT_COMPLETED);
+
+    err = _acq_start (self, acq, num_samples_pre, num_samples_post, num_shots,
+            chan);
+
+err_acq_not_completed:
+err_get_acq_handler:
+    return err;
+}
+
+static int _acq_data_acquire_multi (void *owner, void *args, void *ret)
+{
+    (void) ret;
+    assert (owner);
+    assert (args);
+    int err = -ACQ_OK;
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] "
+            "Calling _acq_data_acquire_multi\n");
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_acq_t *acq = smio_get_handler (self);
+    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
+            err_get_acq_handler, -ACQ_ERR);
+
+    /* Message is:
+     * frame 0: operation code
+     * frame 1: number of pre-trigger samples
+     * frame 2: number of post-trigger samples
+     * frame 3: number of shots
+     * frame 4: channel mask            */
+    uint32_t num_samples_pre = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+    uint32_t num_samples_post = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t num_shots = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t chan_mask = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+
+    if (chan_mask == 0 || (chan_mask >> SMIO_ACQ_NUM_CHANNELS) != 0) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] data_acquire_multi: "
+                "Channel mask 0x%08x is out of range\n", chan_mask);
+        return -ACQ_NUM_CHAN_OOR;
+    }
+
+    if (_acq_seq_chans_overlap (acq, chan_mask)) {
+        return -ACQ_CHAN_OVERLAP;
+    }
+
+    err = _acq_check_status (self, ACQ_CORE_IDLE_MASK, ACQ_CORE_IDLE_VALUE);
+    ASSERT_TEST(err == -ACQ_OK && acq->seq_chan_mask == 0,
+            "Previous acquisition in progress. New acquisition not started",
+            err_acq_not_completed, -ACQ_NOT_COMPLETED);
+
+    /* Check all of the channels up front, so we don't stop halfway through
+     * the sequence */
+    uint32_t trigger_type = 0;
+    err = _acq_get_trigger_type (self, &trigger_type);
+    ASSERT_TEST(err == -ACQ_OK, "Could not check for trigger type",
+            err_acq_get_trig);
+    if (!_acq_seq_trigger_supported (trigger_type)) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] data_acquire_multi: "
+                "Trigger type %u is not supported by acquisition sequences. "
+                "Use the skip or the software trigger\n", trigger_type);
+        return -ACQ_TRIG_TYPE;
+    }
+    for (uint32_t chan = 0; chan < SMIO_ACQ_NUM_CHANNELS; ++chan) {
+        if (chan_mask & (1 << chan)) {
+            err = _acq_check_params (acq, num_samples_pre, num_samples_post,
+                    num_shots, chan, trigger_type);
+            if (err != -ACQ_OK) {
+                return err;
+            }
+        }
+    }
+
+    /* Start the first channel now. The others are started by the done
+     * timer as soon as the previous one completes */
+    uint32_t chan = _acq_seq_next_chan (chan_mask);
+    err = _acq_start (self, acq, num_samples_pre, num_samples_post, num_shots,
+            chan);
+    ASSERT_TEST(err == -ACQ_OK, "Could not start acquisition sequence",
+            err_acq_start);
+
+    acq->seq_chan_mask = chan_mask & ~(1 << chan);
+    acq->seq_params.num_samples_pre = num_samples_pre;
+    acq->seq_params.num_samples_post = num_samples_post;
+    acq->seq_params.num_shots = num_shots;
+
+err_acq_start:
 err_acq_get_trig:
 err_acq_not_completed:
 err_get_acq_handler:
@@ -253,6 +458,11 @@ static int _acq_check_data_acquire (void *owner, void *args, void *ret)
     uint32_t chan = acq->curr_chan;
 
     err = _acq_check_status (self, ACQ_CORE_COMPLETE_MASK, ACQ_CORE_COMPLETE_VALUE);
+    /* A sequence is completed only after its last channel */
+    if (err == -ACQ_OK && acq->seq_chan_mask != 0) {
+        err = -ACQ_NOT_COMPLETED;
+    }
+
     if (err != -ACQ_OK) {
         DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] acq_check_data_acquire: "
                 "Acquisition is not done for channel %u\n", chan);
@@ -280,24 +490,878 @@ static int _acq_check_status (SMIO_OWNER_TYPE *self, uint32_t status_mask,
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] data_acquire: "
             "Status done = 0x%08x\n", status_done);
 
-    if ((status_done & status_mask) != status_value) {
-        err = -ACQ_NOT_COMPLETED;
-        goto err_not_completed;
+    if ((status_done & status_mask) != status_value) {
+        err = -ACQ_NOT_COMPLETED;
+        goto err_not_completed;
+    }
+
+    err = -ACQ_OK;
+
+err_not_completed:
+    return err;
+}
+
+static int _acq_get_data_block (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] "
+            "Calling _acq_get_data_block\n");
+
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_acq_t *acq = smio_get_handler (self);
+    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
+            err_get_acq_handler);
+
+    /* Message is:
+     * frame 0: channel
+     * frame 1: block required      */
+    uint32_t chan = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+    uint32_t block_n = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
+            "chan = %u, block_n = %u\n", chan, block_n);
+
+    /* channel required is out of the limit */
+    if (chan > SMIO_ACQ_NUM_CHANNELS-1) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] data_acquire: "
+                "Channel required is out of the maximum limit\n");
+
+        return -ACQ_NUM_CHAN_OOR;
+    }
+
+    /* Channel features */
+    uint32_t channel_sample_size = acq->acq_buf[chan].sample_size;
+    uint32_t channel_start_addr = acq->acq_buf[chan].start_addr;
+    uint32_t channel_end_addr = acq->acq_buf[chan].end_addr;
+    uint32_t channel_max_samples = acq->acq_buf[chan].max_samples;
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
+            "\t[channel = %u], id = %u, start addr = 0x%08x\n"
+            "\tend addr = 0x%08x, max samples = %u, sample size = %u\n",
+            chan,
+            acq->acq_buf[chan].id,
+            channel_start_addr,
+            channel_end_addr,
+            channel_max_samples,
+            channel_sample_size);
+
+    uint32_t block_n_max = (channel_max_samples*channel_sample_size) /
+        BLOCK_SIZE;
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
+            "block_n_max = %u\n", block_n_max);
+
+    if (block_n > block_n_max) {    /* block required out of the limits */
+        /* TODO error level in this case */
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:acq] get_data_block: "
+                "Block %u of channel %u is out of range\n", block_n, chan);
+        return -ACQ_BLOCK_OOR;
+    }
+
+    /* Get number of samples and shots */
+    uint32_t num_samples_pre =
+        acq->acq_params[chan].num_samples_pre;
+    uint32_t num_samples_post =
+        acq->acq_params[chan].num_samples_post;
+    uint32_t num_samples_shot = num_samples_pre + num_samples_post;
+    uint32_t num_shots =
+        acq->acq_params[chan].num_shots;
+    uint32_t num_samples_multishot = num_samples_shot*num_shots;
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
+            "last num_samples_pre = %u\n", num_samples_pre);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
+            "last num_samples_post = %u\n", num_samples_post);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
+            "last num_shots = %u\n", num_shots);
+
+    uint32_t n_max_samples = BLOCK_SIZE/channel_sample_size;
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
+            "n_max_samples = %u\n", n_max_samples);
+
+    uint32_t over_samples = num_samples_multishot % n_max_samples;
+    uint32_t block_n_valid = num_samples_multishot / n_max_samples;
+    /* When the last block is full 'block_n_valid' exceeds by one */
+    if (block_n_valid != 0 && over_samples == 0) {
+        block_n_valid--;
+    }
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
+            "block_n_valid= %u, over_samples= %u\n",
+            block_n_valid, over_samples);
+
+    /* check if block required is valid and if it is full or not */
+    if (block_n > block_n_valid) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:acq] get_data_block: "
+                "Block %u of channel %u is not valid\n", block_n, chan);
+        return -ACQ_BLOCK_OOR;
+    }   /* Last valid data conditions check done */
+
+    uint32_t reply_size;
+    if (block_n == block_n_valid && over_samples > 0){
+        reply_size = over_samples*channel_sample_size;
+    }
+    else { /* if block_n < block_n_valid */
+        reply_size = BLOCK_SIZE;
+    }
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
+            "Reading block %u of channel %u with %u valid samples\n",
+            block_n, chan, reply_size);
+
+    smio_acq_data_block_t *data_block = (smio_acq_data_block_t *) ret;
+
+    ssize_t valid_bytes = _acq_read_curve (self, acq, chan,
+            (uint64_t) block_n * BLOCK_SIZE, reply_size, data_block->data);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
+            "%zd bytes read\n", valid_bytes);
+
+    /* Check if we could read successfully */
+    int retf = 0;
+    if (valid_bytes >= 0) {
+        data_block->valid_bytes = (uint32_t) valid_bytes;
+        retf = valid_bytes + (ssize_t) sizeof (data_block->valid_bytes);
+    }
+    else {
+        data_block->valid_bytes = 0;
+        retf = -ACQ_COULD_NOT_READ;
+    }
+
+    return retf;
+
+err_get_acq_handler:
+    return -ACQ_ERR;
+}
+
+static uint64_t _acq_get_start_address (uint64_t acq_core_trig_addr,
+        uint64_t acq_size_bytes, uint64_t start_mem_space_addr,
+        uint64_t end_mem_space_addr)
+{
+    uint64_t addr = 0;
+
+    /* Trigger address relative to the start of the memory space */
+    uint64_t rel_start_trig_addr = acq_core_trig_addr - start_mem_space_addr;
+    /* Check if an address wrap can occur */
+    if (rel_start_trig_addr >= acq_size_bytes) {
+        addr = acq_core_trig_addr - acq_size_bytes;
+    }
+    else {
+        addr = end_mem_space_addr - (acq_size_bytes - rel_start_trig_addr);
+    }
+
+    return addr;
+}
+
+static uint64_t _acq_get_read_block_addr (uint64_t start_addr, uint64_t offset,
+        uint64_t channel_start_addr, uint64_t end_mem_space_addr)
+{
+    uint64_t addr = 0;
+
+    /* Memory space last address relative to the start address */
+    uint64_t rel_end_mem_space_addr = end_mem_space_addr - start_addr;
+    /* Check if an address wrap can occur */
+    if (offset <= rel_end_mem_space_addr) {
+        addr = start_addr + offset;
+    }
+    else {
+        addr = channel_start_addr + (offset - rel_end_mem_space_addr);
+    }
+
+    return addr;
+}
+
+/* Read acquisition memory, preferring DMA. If the DEVIO does not support it
+ * (e.g., Ethernet boards) or a DMA read fails, we fall back to regular block
+ * reads, and try DMA again after a while */
+static ssize_t _acq_read_mem (SMIO_OWNER_TYPE *self, smio_acq_t *acq,
+        uint64_t addr, size_t size, uint32_t *data)
+{
+    ssize_t valid_bytes = -1;
+
+    /* Here we must use the "raw" version, as we can't have
+     * LARGE_MEM_ADDR mangled with the bas address of this SMIO */
+    if (acq->dma_reprobe_in == 0) {
+        valid_bytes = smio_thsafe_raw_client_read_dma (self, LARGE_MEM_ADDR | addr,
+                size, data);
+        if (valid_bytes >= 0) {
+            acq->dma_failures = 0;
+            return valid_bytes;
+        }
+
+        /* Back off exponentially while DMA keeps failing */
+        uint32_t reprobe_in = ACQ_DMA_REPROBE_READS;
+        for (uint32_t i = 0; i < acq->dma_failures &&
+                reprobe_in < ACQ_DMA_REPROBE_MAX_READS; ++i) {
+            reprobe_in <<= 1;
+        }
+        acq->dma_reprobe_in = (reprobe_in < ACQ_DMA_REPROBE_MAX_READS) ?
+            reprobe_in : ACQ_DMA_REPROBE_MAX_READS;
+        acq->dma_failures++;
+
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] read_mem: "
+                "DMA read failed %u time(s). Using regular block reads for "
+                "the next %u reads\n", acq->dma_failures, acq->dma_reprobe_in);
+    }
+    else {
+        acq->dma_reprobe_in--;
+    }
+
+    valid_bytes = smio_thsafe_raw_client_read_block (self, LARGE_MEM_ADDR | addr,
+            size, data);
+
+    return valid_bytes;
+}
+
+/* Absolute start address of the last acquisition of channel chan */
+static uint64_t _acq_get_curve_start_addr (smio_acq_t *acq, uint32_t chan)
+{
+    /* Channel features */
+    uint32_t channel_sample_size = acq->acq_buf[chan].sample_size;
+    uint32_t channel_start_addr = acq->acq_buf[chan].start_addr;
+    uint32_t channel_end_addr = acq->acq_buf[chan].end_addr;
+
+    /* Get number of samples and shots */
+    uint32_t num_samples_pre = acq->acq_params[chan].num_samples_pre;
+    uint32_t num_samples_post = acq->acq_params[chan].num_samples_post;
+    uint32_t num_samples_shot = num_samples_pre + num_samples_post;
+    uint32_t num_shots = acq->acq_params[chan].num_shots;
+
+    /* For all modes the start valid address is given by:
+     * start_addr = trigger_addr -
+     * ((num_samples_pre+num_samples_post)*(num_shots-1) + num_samples_pre)*
+     * sample_size
+     * */
+
+    /* First step if to get the trigger address from the channel.
+     * Even on skip trigger mode, this will contain the address after
+     * the last valid sample (end of acquisition address) */
+    uint32_t acq_core_trig_addr = acq->acq_params[chan].trig_addr;
+
+    /* Second step is to calculate the size of the whole acquisition in bytes */
+    uint32_t acq_size_bytes = (num_samples_shot*(num_shots-1) +
+            num_samples_pre)*channel_sample_size;
+    /* Our "end address" is the start of the last valid address available for a
+     * sample. So, our "end address" needs to be accounted for one sample more */
+    uint32_t end_mem_space_addr = channel_end_addr + channel_sample_size;
+
+    /* Third step is to get the absolute start address of the acquisition, taking
+     * care for wraps in the beginning of the current memory space */
+    uint64_t start_addr = _acq_get_start_address (acq_core_trig_addr,
+            acq_size_bytes, channel_start_addr, end_mem_space_addr);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_curve_start_addr:\n"
+            "\tChannel %u:\n"
+            "\tChannel start address = 0x%08x,\n"
+            "\tTrigger address = 0x%08x,\n"
+            "\tAcquisition read start address\n"
+            "\t\t(trig_addr - ((num_samples_pre+num_samples_post)*(num_shots-1)\n"
+            "\t\t+ num_samples_pre)*sample_size = 0x%"PRIx64 "\n",
+            chan,
+            channel_start_addr,
+            acq_core_trig_addr,
+            start_addr);
+
+    return start_addr;
+}
+
+/* Read size bytes at offset of the last curve of channel chan, straight
+ * from the acquisition memory */
+static ssize_t _acq_read_curve_mem (SMIO_OWNER_TYPE *self, smio_acq_t *acq,
+        uint32_t chan, uint64_t offset, size_t size, uint8_t *data)
+{
+    uint32_t channel_start_addr = acq->acq_buf[chan].start_addr;
+    uint64_t end_mem_space_addr = (uint64_t) acq->acq_buf[chan].end_addr +
+        acq->acq_buf[chan].sample_size;
+    uint64_t start_addr = _acq_get_curve_start_addr (acq, chan);
+    size_t bytes_left = size;
+
+    /* Forth step is to calculate the offset from the start_addr, taking care
+     * for wraps in the end of the current memory space. The range may cross
+     * the end of it, so it might take two reads */
+    while (bytes_left > 0) {
+        uint64_t addr_i = _acq_get_read_block_addr (start_addr, offset,
+                channel_start_addr, end_mem_space_addr);
+        if (addr_i >= end_mem_space_addr) {
+            addr_i = channel_start_addr + (addr_i - end_mem_space_addr);
+        }
+
+        size_t chunk_size = bytes_left;
+        if (chunk_size > end_mem_space_addr - addr_i) {
+            chunk_size = end_mem_space_addr - addr_i;
+        }
+
+        ssize_t valid_bytes = _acq_read_mem (self, acq, addr_i, chunk_size,
+                (uint32_t *) data);
+        if (valid_bytes < 0 || (size_t) valid_bytes != chunk_size) {
+            return -1;
+        }
+
+        offset += chunk_size;
+        bytes_left -= chunk_size;
+        data += chunk_size;
+    }
+
+    return size;
+}
+
+/* Read size bytes at offset of the last curve of channel chan. Whole blocks
+ * are kept in the curve cache, if it is enabled and the curve fits in it, so
+ * the next readers of the same curve are served from host memory. While an
+ * acquisition is pending the memory is still being written, so it is read
+ * directly and nothing is cached */
+static ssize_t _acq_read_curve (SMIO_OWNER_TYPE *self, smio_acq_t *acq,
+        uint32_t chan, uint64_t offset, size_t size, uint8_t *data)
+{
+    uint64_t curve_size = (uint64_t) (acq->acq_params[chan].num_samples_pre +
+            acq->acq_params[chan].num_samples_post)*
+        acq->acq_params[chan].num_shots*acq->acq_buf[chan].sample_size;
+
+    acq_cache_t *cache = acq->acq_pending ? NULL :
+        smio_acq_cache_get (acq, chan, curve_size);
+    if (cache == NULL || offset + size > curve_size) {
+        return _acq_read_curve_mem (self, acq, chan, offset, size, data);
+    }
+
+    size_t bytes_left = size;
+    while (bytes_left > 0) {
+        uint64_t block_n = offset / BLOCK_SIZE;
+        uint64_t block_offset = block_n*BLOCK_SIZE;
+        uint64_t block_size = curve_size - block_offset;
+        if (block_size > BLOCK_SIZE) {
+            block_size = BLOCK_SIZE;
+        }
+
+        if (!cache->block_valid[block_n]) {
+            ssize_t valid_bytes = _acq_read_curve_mem (self, acq, chan,
+                    block_offset, block_size, cache->data + block_offset);
+            if (valid_bytes < 0) {
+                return valid_bytes;
+            }
+            cache->block_valid[block_n] = 1;
+        }
+
+        size_t chunk_size = block_offset + block_size - offset;
+        if (chunk_size > bytes_left) {
+            chunk_size = bytes_left;
+        }
+        memcpy (data, cache->data + offset, chunk_size);
+
+        offset += chunk_size;
+        bytes_left -= chunk_size;
+        data += chunk_size;
+    }
+
+    return size;
+}
+
+/* Push the next blocks of the curve stream, as far as the credits of the
+ * client allow. Blocks go through the curve cache, so a curve streamed more
+ * than once is only read from the acquisition memory the first time */
+static int _acq_stream_push (SMIO_OWNER_TYPE *self, smio_acq_t *acq)
+{
+    acq_stream_t *stream = &acq->stream;
+    mlm_client_t *worker = smio_get_worker (self);
+    ASSERT_TEST(worker != NULL, "Could not get SMIO worker",
+            err_get_worker);
+
+    while (stream->credits > 0 && stream->bytes_left > 0) {
+        uint64_t chunk_size = (stream->bytes_left < BLOCK_SIZE) ?
+            stream->bytes_left : BLOCK_SIZE;
+
+        zframe_t *data_frm = zframe_new (NULL, chunk_size);
+        ASSERT_ALLOC(data_frm, err_data_frm_alloc);
+
+        ssize_t valid_bytes = _acq_read_curve (self, acq, stream->chan,
+                stream->offset, chunk_size, zframe_data (data_frm));
+        if (valid_bytes < 0 || (uint64_t) valid_bytes != chunk_size) {
+            DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:acq] stream_push: "
+                    "Could not read block %u of channel %u\n", stream->seq,
+                    stream->chan);
+            zframe_destroy (&data_frm);
+            goto err_read_curve;
+        }
+
+        int err = _acq_send_stream_block (worker, stream, &data_frm);
+        ASSERT_TEST(err == -ACQ_OK, "Could not send curve stream block",
+                err_send_block);
+
+        stream->offset += chunk_size;
+        stream->bytes_left -= chunk_size;
+        stream->credits--;
+        stream->seq++;
+    }
+
+    return -ACQ_OK;
+
+err_send_block:
+err_read_curve:
+err_data_frm_alloc:
+    smio_acq_stream_reset (acq);
+    return -ACQ_COULD_NOT_READ;
+err_get_worker:
+    return -ACQ_ERR;
+}
+
+static int _acq_get_curve_stream (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] "
+            "Calling _acq_get_curve_stream\n");
+
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_acq_t *acq = smio_get_handler (self);
+    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
+            err_get_acq_handler);
+    mlm_client_t *worker = smio_get_worker (self);
+    ASSERT_TEST(worker != NULL, "Could not get SMIO worker",
+            err_get_worker);
+
+    /* Message is:
+     * frame 0: channel
+     * frame 1: first sample
+     * frame 2: number of samples (0 means up to the end of the acquisition)
+     * frame 3: number of blocks the client is ready to receive */
+    uint32_t chan = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+    uint32_t first_sample = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t num_samples = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t credits = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_curve_stream: "
+            "chan = %u, first_sample = %u, num_samples = %u, credits = %u\n",
+            chan, first_sample, num_samples, credits);
+
+    /* channel required is out of the limit */
+    if (chan > SMIO_ACQ_NUM_CHANNELS-1) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] get_curve_stream: "
+                "Channel required is out of the maximum limit\n");
+        return -ACQ_NUM_CHAN_OOR;
+    }
+
+    uint32_t num_samples_multishot = (acq->acq_params[chan].num_samples_pre +
+            acq->acq_params[chan].num_samples_post)*acq->acq_params[chan].num_shots;
+
+    /* Sample range must be inside the last acquisition */
+    if (first_sample >= num_samples_multishot) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:acq] get_curve_stream: "
+                "First sample %u of channel %u is out of range\n", first_sample,
+                chan);
+        return -ACQ_NUM_SAMPLES_OOR;
+    }
+
+    if (num_samples == 0 || num_samples > num_samples_multishot - first_sample) {
+        num_samples = num_samples_multishot - first_sample;
+    }
+
+    /* A client has a single stream at a time, and so do we. A new request
+     * replaces any stream left behind */
+    smio_acq_stream_reset (acq);
+    acq_stream_t *stream = &acq->stream;
+    stream->client = strdup (mlm_client_sender (worker));
+    ASSERT_ALLOC(stream->client, err_stream_alloc);
+    const char *subject = mlm_client_subject (worker);
+    stream->subject = hutils_concat_strings (ACQ_STREAM_SUBJECT,
+            (subject == NULL) ? "" : subject, ':');
+    ASSERT_ALLOC(stream->subject, err_stream_alloc);
+
+    uint32_t sample_size = acq->acq_buf[chan].sample_size;
+    uint64_t total_bytes = (uint64_t) num_samples*sample_size;
+    stream->chan = chan;
+    stream->offset = (uint64_t) first_sample*sample_size;
+    stream->bytes_left = total_bytes;
+    stream->seq = 0;
+    stream->credits = credits;
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_curve_stream: "
+            "Streaming %"PRIu64 " bytes from offset %"PRIu64 " of channel %u\n",
+            total_bytes, stream->offset, chan);
+
+    int err = _acq_stream_push (self, acq);
+    if (err != -ACQ_OK) {
+        return err;
+    }
+
+    /* The client knows the stream is complete once it has got this
+     * many bytes */
+    *((uint64_t *) ret) = total_bytes;
+    return sizeof (total_bytes);
+
+err_stream_alloc:
+    smio_acq_stream_reset (acq);
+err_get_worker:
+err_get_acq_handler:
+    return -ACQ_ERR;
+}
+
+static int _acq_curve_stream_credit (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
+
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_acq_t *acq = smio_get_handler (self);
+    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
+            err_get_acq_handler);
+    mlm_client_t *worker = smio_get_worker (self);
+    ASSERT_TEST(worker != NULL, "Could not get SMIO worker",
+            err_get_worker);
+
+    /* Message is:
+     * frame 0: number of blocks the client is ready to receive */
+    uint32_t credits = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+
+    /* The stream is gone if it failed or a new acquisition was started */
+    acq_stream_t *stream = &acq->stream;
+    if (stream->client == NULL || !streq (stream->client,
+                mlm_client_sender (worker))) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] curve_stream_credit: "
+                "No curve stream to client %s\n", mlm_client_sender (worker));
+        return -ACQ_NO_STREAM;
+    }
+
+    stream->credits += credits;
+    int err = _acq_stream_push (self, acq);
+    if (err != -ACQ_OK) {
+        return err;
+    }
+
+    *((uint64_t *) ret) = stream->bytes_left;
+    return sizeof (uint64_t);
+
+err_get_worker:
+err_get_acq_handler:
+    return -ACQ_ERR;
+}
+
+static int _acq_send_stream_block (mlm_client_t *worker, acq_stream_t *stream,
+        zframe_t **data_frm_p)
+{
+    assert (worker);
+    assert (stream);
+    assert (data_frm_p);
+
+    zmsg_t *msg = zmsg_new ();
+    ASSERT_ALLOC(msg, err_msg_alloc);
+
+    /* Message is:
+     * frame 0: reply code
+     * frame 1: block sequence number
+     * frame 2: number of bytes in block
+     * frame 3: data */
+    ACQ_REPLY_TYPE reply_code = ACQ_OK;
+    ACQ_STREAM_SIZE_TYPE block_size = zframe_size (*data_frm_p);
+    int zerr = zmsg_addmem (msg, &reply_code, sizeof (reply_code));
+    ASSERT_TEST(zerr == 0, "Could not add reply code in message", err_msg_build);
+    zerr = zmsg_addmem (msg, &stream->seq, sizeof (stream->seq));
+    ASSERT_TEST(zerr == 0, "Could not add sequence number in message", err_msg_build);
+    zerr = zmsg_addmem (msg, &block_size, sizeof (block_size));
+    ASSERT_TEST(zerr == 0, "Could not add block size in message", err_msg_build);
+    /* The message takes ownership of the data frame */
+    zerr = zmsg_append (msg, data_frm_p);
+    ASSERT_TEST(zerr == 0, "Could not add data in message", err_msg_build);
+
+    int rc = mlm_client_sendto (worker, stream->client, stream->subject, NULL,
+            0, &msg);
+    ASSERT_TEST(rc == 0, "Could not send curve stream message", err_send);
+
+    return -ACQ_OK;
+
+err_send:
+err_msg_build:
+    zmsg_destroy (&msg);
+err_msg_alloc:
+    zframe_destroy (data_frm_p);
+    return -ACQ_ERR;
+}
+
+/* Size of each sample component. The 8-byte ADC samples are made of 16-bit
+ * components and all of the others of 32-bit ones. See acq_chan.h */
+static uint32_t _acq_sample_elem_size (uint32_t sample_size)
+{
+    return (sample_size <= 8) ? sizeof (int16_t) : sizeof (int32_t);
+}
+
+static int64_t _acq_sample_elem_get (const uint8_t *sample, uint32_t elem_size,
+        uint32_t i)
+{
+    return (elem_size == sizeof (int16_t)) ?
+        ((const int16_t *) sample) [i] : ((const int32_t *) sample) [i];
+}
+
+static void _acq_sample_elem_set (uint8_t *sample, uint32_t elem_size,
+        uint32_t i, int64_t value)
+{
+    if (elem_size == sizeof (int16_t)) {
+        ((int16_t *) sample) [i] = (int16_t) value;
+    }
+    else {
+        ((int32_t *) sample) [i] = (int32_t) value;
+    }
+}
+
+static void _acq_bucket_add (acq_bucket_t *bucket, const uint8_t *sample,
+        uint32_t elem_size, uint32_t num_elems)
+{
+    for (uint32_t i = 0; i < num_elems; ++i) {
+        int64_t value = _acq_sample_elem_get (sample, elem_size, i);
+
+        if (bucket->count == 0 || value < bucket->min [i]) {
+            bucket->min [i] = value;
+        }
+        if (bucket->count == 0 || value > bucket->max [i]) {
+            bucket->max [i] = value;
+        }
+        bucket->sum [i] = (bucket->count == 0) ? value : bucket->sum [i] + value;
+    }
+
+    bucket->count++;
+}
+
+/* Write the reduced samples of a bucket to out. Returns the number of bytes
+ * written */
+static uint32_t _acq_bucket_emit (acq_bucket_t *bucket, uint32_t reduction,
+        uint8_t *out, uint32_t sample_size, uint32_t elem_size,
+        uint32_t num_elems)
+{
+    for (uint32_t i = 0; i < num_elems; ++i) {
+        if (reduction == ACQ_REDUCE_MEAN) {
+            _acq_sample_elem_set (out, elem_size, i,
+                    bucket->sum [i] / bucket->count);
+        }
+        else {
+            _acq_sample_elem_set (out, elem_size, i, bucket->min [i]);
+            _acq_sample_elem_set (out + sample_size, elem_size, i,
+                    bucket->max [i]);
+        }
+    }
+
+    bucket->count = 0;
+    return (reduction == ACQ_REDUCE_MEAN) ? sample_size : 2*sample_size;
+}
+
+static int _acq_get_curve_reduced (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] "
+            "Calling _acq_get_curve_reduced\n");
+
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_acq_t *acq = smio_get_handler (self);
+    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
+            err_get_acq_handler);
+
+    /* Message is:
+     * frame 0: channel
+     * frame 1: first sample
+     * frame 2: number of samples (0 means up to the end of the acquisition)
+     * frame 3: decimation factor
+     * frame 4: reduction */
+    uint32_t chan = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+    uint32_t first_sample = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t num_samples = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t decim = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t reduction = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_curve_reduced: "
+            "chan = %u, first_sample = %u, num_samples = %u, decim = %u, "
+            "reduction = %u\n", chan, first_sample, num_samples, decim,
+            reduction);
+
+    /* channel required is out of the limit */
+    if (chan > SMIO_ACQ_NUM_CHANNELS-1) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] get_curve_reduced: "
+                "Channel required is out of the maximum limit\n");
+        return -ACQ_NUM_CHAN_OOR;
+    }
+
+    if (decim == 0 || reduction >= ACQ_REDUCE_END) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] get_curve_reduced: "
+                "Invalid decimation factor or reduction\n");
+        return -ACQ_INV_REDUCTION;
+    }
+
+    /* Channel features */
+    uint32_t channel_sample_size = acq->acq_buf[chan].sample_size;
+    uint32_t elem_size = _acq_sample_elem_size (channel_sample_size);
+    uint32_t num_elems = channel_sample_size / elem_size;
+    if (num_elems > ACQ_SAMPLE_MAX_ELEMS) {
+        num_elems = ACQ_SAMPLE_MAX_ELEMS;
+    }
+
+    /* Get number of samples and shots */
+    uint32_t num_samples_multishot = (acq->acq_params[chan].num_samples_pre +
+            acq->acq_params[chan].num_samples_post)*acq->acq_params[chan].num_shots;
+
+    /* Sample range must be inside the last acquisition */
+    if (first_sample >= num_samples_multishot) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:acq] get_curve_reduced: "
+                "First sample %u of channel %u is out of range\n", first_sample,
+                chan);
+        return -ACQ_NUM_SAMPLES_OOR;
+    }
+
+    if (num_samples == 0 || num_samples > num_samples_multishot - first_sample) {
+        num_samples = num_samples_multishot - first_sample;
+    }
+
+    /* Bound the work of a single request, so it is answered well within
+     * the client timeout. A bucket costs decim samples, except for picking,
+     * which reads at most a block per bucket. Only whole buckets are
+     * reduced, so the client resumes the range where the reply ends */
+    uint64_t bucket_bytes = (uint64_t) decim*channel_sample_size;
+    if (reduction == ACQ_REDUCE_PICK && bucket_bytes > BLOCK_SIZE) {
+        bucket_bytes = BLOCK_SIZE;
+    }
+    if (bucket_bytes > ACQ_REDUCE_MAX_SIZE) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] get_curve_reduced: "
+                "Buckets of %u samples are too large to be reduced. Use a "
+                "smaller decimation factor\n", decim);
+        return -ACQ_INV_REDUCTION;
+    }
+
+    uint32_t reduced_bucket_size = channel_sample_size*
+        ((reduction == ACQ_REDUCE_MINMAX) ? 2 : 1);
+    uint64_t max_buckets = ACQ_REDUCE_MAX_SIZE / bucket_bytes;
+    if (max_buckets > BLOCK_SIZE / reduced_bucket_size) {
+        max_buckets = BLOCK_SIZE / reduced_bucket_size;
+    }
+    if ((uint64_t) num_samples > max_buckets*decim) {
+        num_samples = max_buckets*decim;
+    }
+
+    /* Picking only needs the first sample of each bucket. Read as many
+     * buckets as fit in a block, but skip the samples after the last pick */
+    uint64_t stride_bytes = (uint64_t) decim*channel_sample_size;
+    uint64_t strides_per_chunk = BLOCK_SIZE / stride_bytes;
+    if (strides_per_chunk == 0) {
+        strides_per_chunk = 1;
+    }
+    uint64_t chunk_max_samples = (reduction == ACQ_REDUCE_PICK) ?
+        (strides_per_chunk - 1)*decim + 1 : BLOCK_SIZE/channel_sample_size;
+
+    /* Samples are read through the curve cache, so reducing the same curve
+     * again, or streaming it afterwards, does not go to the memory again */
+    uint8_t *chunk = malloc (chunk_max_samples*channel_sample_size);
+    ASSERT_ALLOC(chunk, err_chunk_alloc);
+
+    smio_acq_data_block_t *data_block = (smio_acq_data_block_t *) ret;
+    uint8_t *out = data_block->data;
+    acq_bucket_t bucket = {0};
+    uint64_t sample_i = 0;
+
+    while (sample_i < num_samples) {
+        uint64_t offset = ((uint64_t) first_sample + sample_i)*channel_sample_size;
+        uint64_t chunk_samples = num_samples - sample_i;
+        if (chunk_samples > chunk_max_samples) {
+            chunk_samples = chunk_max_samples;
+        }
+        uint64_t chunk_size = chunk_samples*channel_sample_size;
+
+        ssize_t valid_bytes = _acq_read_curve (self, acq, chan, offset,
+                chunk_size, chunk);
+        if (valid_bytes < 0 || (uint64_t) valid_bytes != chunk_size) {
+            DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:acq] get_curve_reduced: "
+                    "Could not read sample %"PRIu64 " of channel %u\n",
+                    first_sample + sample_i, chan);
+            goto err_read_curve;
+        }
+
+        const uint8_t *sample = chunk;
+        for (uint64_t j = 0; j < chunk_samples; ++j, sample += channel_sample_size) {
+            uint64_t bucket_pos = (sample_i + j) % decim;
+
+            if (reduction == ACQ_REDUCE_PICK) {
+                if (bucket_pos == 0) {
+                    memcpy (out, sample, channel_sample_size);
+                    out += channel_sample_size;
+                }
+                continue;
+            }
+
+            _acq_bucket_add (&bucket, sample, elem_size, num_elems);
+            if (bucket_pos == decim - 1 || sample_i + j == num_samples - 1) {
+                out += _acq_bucket_emit (&bucket, reduction, out,
+                        channel_sample_size, elem_size, num_elems);
+            }
+        }
+
+        sample_i += chunk_samples;
+        /* Skip to the next bucket */
+        if (reduction == ACQ_REDUCE_PICK) {
+            sample_i = ((sample_i + decim - 1) / decim)*decim;
+        }
+    }
+    free (chunk);
+
+    data_block->valid_bytes = out - data_block->data;
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_curve_reduced: "
+            "%u samples of channel %u reduced to %u bytes\n", num_samples,
+            chan, data_block->valid_bytes);
+
+    return data_block->valid_bytes + sizeof (data_block->valid_bytes);
+
+err_read_curve:
+    free (chunk);
+    return -ACQ_COULD_NOT_READ;
+err_chunk_alloc:
+err_get_acq_handler:
+    return -ACQ_ERR;
+}
+
+/* Read num_samples samples of channel chan, starting at first_sample of the
+ * last acquisition, into data_block. At most one block is read, so
+ * num_samples is clamped to it and to the end of the acquisition. Returns
+ * the size of the reply or a negative error code */
+static int _acq_read_samples (SMIO_OWNER_TYPE *self, smio_acq_t *acq,
+        uint32_t chan, uint32_t first_sample, uint32_t num_samples,
+        smio_acq_data_block_t *data_block)
+{
+    /* Channel features */
+    uint32_t channel_sample_size = acq->acq_buf[chan].sample_size;
+
+    /* Get number of samples and shots */
+    uint32_t num_samples_pre = acq->acq_params[chan].num_samples_pre;
+    uint32_t num_samples_post = acq->acq_params[chan].num_samples_post;
+    uint32_t num_samples_shot = num_samples_pre + num_samples_post;
+    uint32_t num_shots = acq->acq_params[chan].num_shots;
+    uint32_t num_samples_multishot = num_samples_shot*num_shots;
+
+    /* Sample range must be inside the last acquisition */
+    if (first_sample >= num_samples_multishot) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:acq] read_samples: "
+                "First sample %u of channel %u is out of range\n", first_sample,
+                chan);
+        return -ACQ_NUM_SAMPLES_OOR;
+    }
+
+    if (num_samples == 0 || num_samples > num_samples_multishot - first_sample) {
+        num_samples = num_samples_multishot - first_sample;
+    }
+    if (num_samples > BLOCK_SIZE/channel_sample_size) {
+        num_samples = BLOCK_SIZE/channel_sample_size;
     }
 
-    err = -ACQ_OK;
+    size_t size = (size_t) num_samples*channel_sample_size;
+    ssize_t valid_bytes = _acq_read_curve (self, acq, chan,
+            (uint64_t) first_sample*channel_sample_size, size, data_block->data);
+    if (valid_bytes < 0 || (size_t) valid_bytes != size) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:acq] read_samples: "
+                "Could not read samples of channel %u\n", chan);
+        data_block->valid_bytes = 0;
+        return -ACQ_COULD_NOT_READ;
+    }
 
-err_not_completed:
-    return err;
+    data_block->valid_bytes = size;
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] read_samples: "
+            "%u samples of channel %u read from sample %u\n", num_samples,
+            chan, first_sample);
+
+    return data_block->valid_bytes + sizeof (data_block->valid_bytes);
 }
 
-static int _acq_get_data_block (void *owner, void *args, void *ret)
+static int _acq_get_samples (void *owner, void *args, void *ret)
 {
     assert (owner);
     assert (args);
 
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] "
-            "Calling _acq_get_data_block\n");
+            "Calling _acq_get_samples\n");
 
     SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
     smio_acq_t *acq = smio_get_handler (self);
@@ -306,198 +1370,117 @@ static int _acq_get_data_block (void *owner, void *args, void *ret)
 
     /* Message is:
      * frame 0: channel
-     * frame 1: block required      */
+     * frame 1: first sample
+     * frame 2: number of samples (0 means as many as fit in a block) */
     uint32_t chan = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
-    uint32_t block_n = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
-            "chan = %u, block_n = %u\n", chan, block_n);
+    uint32_t first_sample = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t num_samples = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_samples: "
+            "chan = %u, first_sample = %u, num_samples = %u\n", chan,
+            first_sample, num_samples);
 
     /* channel required is out of the limit */
     if (chan > SMIO_ACQ_NUM_CHANNELS-1) {
-        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] data_acquire: "
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] get_samples: "
                 "Channel required is out of the maximum limit\n");
-
         return -ACQ_NUM_CHAN_OOR;
     }
 
-    /* Channel features */
-    uint32_t channel_sample_size = acq->acq_buf[chan].sample_size;
-    uint32_t channel_start_addr = acq->acq_buf[chan].start_addr;
-    uint32_t channel_end_addr = acq->acq_buf[chan].end_addr;
-    uint32_t channel_max_samples = acq->acq_buf[chan].max_samples;
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
-            "\t[channel = %u], id = %u, start addr = 0x%08x\n"
-            "\tend addr = 0x%08x, max samples = %u, sample size = %u\n",
-            chan,
-            acq->acq_buf[chan].id,
-            channel_start_addr,
-            channel_end_addr,
-            channel_max_samples,
-            channel_sample_size);
-
-    uint32_t block_n_max = (channel_max_samples*channel_sample_size) /
-        BLOCK_SIZE;
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
-            "block_n_max = %u\n", block_n_max);
+    return _acq_read_samples (self, acq, chan, first_sample, num_samples,
+            (smio_acq_data_block_t *) ret);
 
-    if (block_n > block_n_max) {    /* block required out of the limits */
-        /* TODO error level in this case */
-        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:acq] get_data_block: "
-                "Block %u of channel %u is out of range\n", block_n, chan);
-        return -ACQ_BLOCK_OOR;
-    }
+err_get_acq_handler:
+    return -ACQ_ERR;
+}
 
-    /* Get number of samples and shots */
-    uint32_t num_samples_pre =
-        acq->acq_params[chan].num_samples_pre;
-    uint32_t num_samples_post =
-        acq->acq_params[chan].num_samples_post;
-    uint32_t num_samples_shot = num_samples_pre + num_samples_post;
-    uint32_t num_shots =
-        acq->acq_params[chan].num_shots;
-    uint32_t num_samples_multishot = num_samples_shot*num_shots;
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
-            "last num_samples_pre = %u\n", num_samples_pre);
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
-            "last num_samples_post = %u\n", num_samples_post);
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
-            "last num_shots = %u\n", num_shots);
+static int _acq_get_shot (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
 
-    uint32_t n_max_samples = BLOCK_SIZE/channel_sample_size;
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
-            "n_max_samples = %u\n", n_max_samples);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] "
+            "Calling _acq_get_shot\n");
 
-    uint32_t over_samples = num_samples_multishot % n_max_samples;
-    uint32_t block_n_valid = num_samples_multishot / n_max_samples;
-    /* When the last block is full 'block_n_valid' exceeds by one */
-    if (block_n_valid != 0 && over_samples == 0) {
-        block_n_valid--;
-    }
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
-            "block_n_valid= %u, over_samples= %u\n",
-            block_n_valid, over_samples);
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_acq_t *acq = smio_get_handler (self);
+    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
+            err_get_acq_handler);
 
-    /* check if block required is valid and if it is full or not */
-    if (block_n > block_n_valid) {
-        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:acq] get_data_block: "
-                "Block %u of channel %u is not valid\n", block_n, chan);
-        return -ACQ_BLOCK_OOR;
-    }   /* Last valid data conditions check done */
+    /* Message is:
+     * frame 0: channel
+     * frame 1: shot */
+    uint32_t chan = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+    uint32_t shot = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_shot: "
+            "chan = %u, shot = %u\n", chan, shot);
 
-    uint32_t reply_size;
-    if (block_n == block_n_valid && over_samples > 0){
-        reply_size = over_samples*channel_sample_size;
-    }
-    else { /* if block_n < block_n_valid */
-        reply_size = BLOCK_SIZE;
+    /* channel required is out of the limit */
+    if (chan > SMIO_ACQ_NUM_CHANNELS-1) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] get_shot: "
+                "Channel required is out of the maximum limit\n");
+        return -ACQ_NUM_CHAN_OOR;
     }
 
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
-            "Reading block %u of channel %u with %u valid samples\n",
-            block_n, chan, reply_size);
-
-    /* For all modes the start valid address is given by:
-     * start_addr = trigger_addr -
-     * ((num_samples_pre+num_samples_post)*(num_shots-1) + num_samples_pre)*
-     * sample_size
-     * */
-
-    /* First step if to get the trigger address from the channel.
-     * Even on skip trigger mode, this will contain the address after
-     * the last valid sample (end of acquisition address) */
-    uint32_t acq_core_trig_addr = acq->acq_params[chan].trig_addr;
-
-    /* Second step is to calculate the size of the whole acquisition in bytes */
-    uint32_t acq_size_bytes = (num_samples_shot*(num_shots-1) +
-            num_samples_pre)*channel_sample_size;
-    /* Our "end address" is the start of the last valid address available for a
-     * sample. So, our "end address" needs to be accounted for one sample more */
-    uint32_t end_mem_space_addr = channel_end_addr + channel_sample_size;
-
-    /* Third step is to get the absolute start address of the acquisition, taking
-     * care for wraps in the beginning of the current memory space */
-    uint64_t start_addr = _acq_get_start_address (acq_core_trig_addr,
-            acq_size_bytes, channel_start_addr, end_mem_space_addr);
-
-    /* Forth step is to calculate the offset from the start_addr, taking care
-     * for wraps in the end of the current memory space */
-    uint64_t addr_i = _acq_get_read_block_addr (start_addr, block_n * BLOCK_SIZE,
-            channel_start_addr, end_mem_space_addr);
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block:\n"
-            "\tBlock %u of channel %u:\n"
-            "\tChannel start address = 0x%08x,\n"
-            "\tTrigger address = 0x%08x,\n"
-            "\tAcquisition read start address\n"
-            "\t\t(trig_addr - ((num_samples_pre+num_samples_post)*(num_shots-1)\n"
-            "\t\t+ num_samples_pre)*sample_size = 0x%"PRIx64 ",\n"
-            "\tCurrent block start address (read_start_addr + block_n*BLOCK_SIZE) = 0x%"PRIx64 "\n",
-            block_n, chan,
-            channel_start_addr,
-            acq_core_trig_addr,
-            start_addr,
-            addr_i);
-
-    smio_acq_data_block_t *data_block = (smio_acq_data_block_t *) ret;
-
-    /* Here we must use the "raw" version, as we can't have
-     * LARGE_MEM_ADDR mangled with the bas address of this SMIO */
-    ssize_t valid_bytes = smio_thsafe_raw_client_read_block (self, LARGE_MEM_ADDR | addr_i,
-            reply_size, (uint32_t *) data_block->data);
-    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] get_data_block: "
-            "%zd bytes read\n", valid_bytes);
-
-    /* Check if we could read successfully */
-    int retf = 0;
-    if (valid_bytes >= 0) {
-        data_block->valid_bytes = (uint32_t) valid_bytes;
-        retf = valid_bytes + (ssize_t) sizeof (data_block->valid_bytes);
+    if (shot >= acq->acq_params[chan].num_shots) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] get_shot: "
+                "Shot %u of channel %u is out of range\n", shot, chan);
+        return -ACQ_NUM_SAMPLES_OOR;
     }
-    else {
-        data_block->valid_bytes = 0;
-        retf = -ACQ_COULD_NOT_READ;
+
+    /* The number of samples of each shot is the one programmed into the
+     * core, after alignment, so clients can't work it out by themselves.
+     * Multishot acquisitions are limited to ACQ_CORE_MULTISHOT_MEM_SIZE
+     * samples, but a single shot can be much longer. Refuse those instead
+     * of returning the first block of it */
+    uint32_t num_samples_shot = acq->acq_params[chan].num_samples_pre +
+        acq->acq_params[chan].num_samples_post;
+    if (num_samples_shot > BLOCK_SIZE/acq->acq_buf[chan].sample_size) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] get_shot: "
+                "Shot of %u samples of channel %u does not fit in a block\n",
+                num_samples_shot, chan);
+        return -ACQ_NUM_SAMPLES_OOR;
     }
 
-    return retf;
+    return _acq_read_samples (self, acq, chan, shot*num_samples_shot,
+            num_samples_shot, (smio_acq_data_block_t *) ret);
 
 err_get_acq_handler:
     return -ACQ_ERR;
 }
 
-static uint64_t _acq_get_start_address (uint64_t acq_core_trig_addr,
-        uint64_t acq_size_bytes, uint64_t start_mem_space_addr,
-        uint64_t end_mem_space_addr)
+static int _acq_cache_size (void *owner, void *args, void *ret)
 {
-    uint64_t addr = 0;
-
-    /* Trigger address relative to the start of the memory space */
-    uint64_t rel_start_trig_addr = acq_core_trig_addr - start_mem_space_addr;
-    /* Check if an address wrap can occur */
-    if (rel_start_trig_addr >= acq_size_bytes) {
-        addr = acq_core_trig_addr - acq_size_bytes;
-    }
-    else {
-        addr = end_mem_space_addr - (acq_size_bytes - rel_start_trig_addr);
-    }
+    assert (owner);
+    assert (args);
+    int err = -ACQ_OK;
 
-    return addr;
-}
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] "
+            "Calling _acq_cache_size\n");
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_acq_t *acq = smio_get_handler (self);
+    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
+            err_get_acq_handler, -ACQ_ERR);
 
-static uint64_t _acq_get_read_block_addr (uint64_t start_addr, uint64_t offset,
-        uint64_t channel_start_addr, uint64_t end_mem_space_addr)
-{
-    uint64_t addr = 0;
+    /* Message is:
+     * frame 0: operation code
+     * frame 1: rw
+     * frame 2: curve cache memory budget, in MiB (0 disables the cache) */
+    uint32_t rw = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+    uint32_t cache_size = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
 
-    /* Memory space last address relative to the start address */
-    uint64_t rel_end_mem_space_addr = end_mem_space_addr - start_addr;
-    /* Check if an address wrap can occur */
-    if (offset <= rel_end_mem_space_addr) {
-        addr = start_addr + offset;
+    if (rw) {
+        /* Return value to caller */
+        *((uint32_t *) ret) = (uint32_t) (acq->cache_budget >> 20);
+        err = sizeof (uint32_t);
     }
     else {
-        addr = channel_start_addr + (offset - rel_end_mem_space_addr);
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] "
+                "Curve cache size = %u MiB\n", cache_size);
+        smio_acq_cache_set_budget (acq, (uint64_t) cache_size << 20);
     }
 
-    return addr;
+err_get_acq_handler:
+    return err;
 }
 
 static int _acq_cfg_trigger (void *owner, void *args, void *ret)
@@ -727,12 +1710,46 @@ RW_PARAM_FUNC(acq, sw_trig) {
 
 #define ACQ_FSM_STOP_MIN                            0
 #define ACQ_FSM_STOP_MAX                            1
-RW_PARAM_FUNC(acq, fsm_stop) {
+RW_PARAM_FUNC(acq, fsm_stop_raw) {
     SET_GET_PARAM(acq, 0x0, ACQ_CORE, CTL,
             FSM_STOP_ACQ, SINGLE_BIT_PARAM, ACQ_FSM_STOP_MIN,
             ACQ_FSM_STOP_MAX, NO_CHK_FUNC, NO_FMT_FUNC, SET_FIELD);
 }
 
+/* Stopping the acquisition core also aborts a running sequence and
+ * the wait for the pending acquisition, which will never complete */
+static int _acq_fsm_stop (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
+
+    /* Message is:
+     * frame 0: operation code
+     * frame 1: rw      R /W    1 = read mode, 0 = write mode
+     * frame 2: value to be written (rw = 0) or dummy value (rw = 1) */
+    uint32_t rw = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+    uint32_t value = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+
+    int err = RW_PARAM_FUNC_NAME(acq, fsm_stop_raw) (owner, args, ret);
+    if (rw || value == 0 || err < 0) {
+        return err;
+    }
+
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_acq_t *acq = smio_get_handler (self);
+    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
+            err_get_acq_handler, -ACQ_ERR);
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] fsm_stop: "
+            "Acquisition stopped. Dropping pending acquisition and sequence\n");
+    acq->seq_chan_mask = 0;
+    memset (&acq->seq_params, 0, sizeof (acq->seq_params));
+    acq->acq_pending = false;
+
+err_get_acq_handler:
+    return err;
+}
+
 #define ACQ_DATA_DRIVEN_CHAN_MIN                    0
 #define ACQ_DATA_DRIVEN_CHAN_MAX                    (SMIO_ACQ_NUM_CHANNELS-1)
 RW_PARAM_FUNC(acq, hw_data_trig_chan) {
@@ -753,8 +1770,15 @@ const disp_table_func_fp acq_exp_fp [] = {
     RW_PARAM_FUNC_NAME(acq, hw_data_trig_thres),
     RW_PARAM_FUNC_NAME(acq, hw_trig_dly),
     RW_PARAM_FUNC_NAME(acq, sw_trig),
-    RW_PARAM_FUNC_NAME(acq, fsm_stop),
+    _acq_fsm_stop,
     RW_PARAM_FUNC_NAME(acq, hw_data_trig_chan),
+    _acq_get_curve_stream,
+    _acq_data_acquire_multi,
+    _acq_get_curve_reduced,
+    _acq_get_samples,
+    _acq_get_shot,
+    _acq_cache_size,
+    _acq_curve_stream_credit,
     NULL
 };
 
@@ -817,6 +1841,106 @@ const smio_ops_t acq_ops = {
     .do_op              = acq_do_op            /* Generic wrapper for handling specific operations */
 };
 
+/************************************************************/
+/******************** Periodic Operations *******************/
+/************************************************************/
+
+/* Start the next channel of an acquisition sequence. If the acquisition
+ * core is not idle yet, we try again on the next tick */
+static void _acq_seq_start_next (smio_t *self, smio_acq_t *acq)
+{
+    uint32_t chan = _acq_seq_next_chan (acq->seq_chan_mask);
+
+    /* The trigger might have been reconfigured in the middle of the
+     * sequence. Anything but skip or software would never fire */
+    uint32_t trigger_type = 0;
+    int err = _acq_get_trigger_type (self, &trigger_type);
+    if (err != -ACQ_OK || !_acq_seq_trigger_supported (trigger_type)) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] seq_start_next: "
+                "Trigger type not supported by acquisition sequences. Aborting "
+                "sequence\n");
+        acq->seq_chan_mask = 0;
+        return;
+    }
+
+    err = _acq_start (self, acq, acq->seq_params.num_samples_pre,
+            acq->seq_params.num_samples_post, acq->seq_params.num_shots, chan);
+
+    if (err == -ACQ_OK) {
+        acq->seq_chan_mask &= ~(1 << chan);
+
+        /* The client only triggers the first channel */
+        if (trigger_type == TYPE_ACQ_CORE_SW) {
+            uint32_t sw_trig = ACQ_CORE_SW_TRIG_W(1);
+            smio_thsafe_client_write_32 (self, ACQ_CORE_REG_SW_TRIG, &sw_trig);
+        }
+    }
+    else if (err != -ACQ_NOT_COMPLETED) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io:acq] seq_start_next: "
+                "Could not start acquisition of channel %u. Aborting "
+                "sequence\n", chan);
+        acq->seq_chan_mask = 0;
+    }
+}
+
+/* Publish an event as soon as a pending acquisition is completed. This
+ * spares clients from polling ACQ_NAME_CHECK_DATA_ACQUIRE */
+static smio_err_e _acq_handle_done_timer (smio_t *self)
+{
+    smio_err_e err = SMIO_SUCCESS;
+    smio_acq_t *acq = smio_get_handler (self);
+    ASSERT_TEST(acq != NULL, "Could not get SMIO ACQ handler",
+            err_get_acq_handler, SMIO_ERR_ALLOC);
+
+    if (!acq->acq_pending) {
+        goto no_acq_pending;
+    }
+
+    int acq_err = _acq_check_status (self, ACQ_CORE_COMPLETE_MASK,
+            ACQ_CORE_COMPLETE_VALUE);
+    if (acq_err != -ACQ_OK) {
+        goto acq_not_completed;
+    }
+
+    uint32_t chan = acq->curr_chan;
+    uint32_t acq_core_trig_addr = 0;
+    smio_thsafe_client_read_32 (self, ACQ_CORE_REG_TRIG_POS, &acq_core_trig_addr);
+    acq->acq_params[chan].trig_addr = acq_core_trig_addr;
+    acq->acq_pending = false;
+    /* Drop anything cached from the memory while it was being written */
+    smio_acq_cache_invalidate (acq);
+    uint64_t timestamp = zclock_time ();
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:acq] handle_done_timer: "
+            "Acquisition is done for channel %u. Publishing event\n", chan);
+
+    /* Message is:
+     * frame 0: channel
+     * frame 1: trigger address
+     * frame 2: timestamp */
+    zmsg_t *msg = zmsg_new ();
+    ASSERT_ALLOC(msg, err_msg_alloc, SMIO_ERR_ALLOC);
+    zmsg_addmem (msg, &chan, sizeof (chan));
+    zmsg_addmem (msg, &acq_core_trig_addr, sizeof (acq_core_trig_addr));
+    zmsg_addmem (msg, &timestamp, sizeof (timestamp));
+
+    int rc = mlm_client_send (smio_get_worker (self), ACQ_EVENT_DONE, &msg);
+    ASSERT_TEST(rc == 0, "Could not publish acquisition done event",
+            err_send_msg, SMIO_ERR_PUBLISH_EVENT);
+
+err_send_msg:
+    zmsg_destroy (&msg);
+err_msg_alloc:
+no_acq_pending:
+    /* Start the next channel of a sequence right away */
+    if (!acq->acq_pending && acq->seq_chan_mask != 0) {
+        _acq_seq_start_next (self, acq);
+    }
+acq_not_completed:
+err_get_acq_handler:
+    return err;
+}
+
 /************************************************************/
 /****************** Bootstrap Operations ********************/
 /************************************************************/
@@ -836,7 +1960,8 @@ smio_err_e acq_init (smio_t * self)
     err = smio_set_ops (self, &acq_ops);
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO operations",
             err_smio_set_ops);
-    err = smio_set_thsafe_client_ops (self, &smio_thsafe_client_zmq_ops);
+    err = smio_set_thsafe_client_ops (self,
+            devio_get_thsafe_client_ops (smio_get_parent (self)));
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO thsafe operations",
             err_smio_set_thsafe_ops);
 
@@ -861,8 +1986,23 @@ smio_err_e acq_init (smio_t * self)
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO handler",
             err_smio_set_handler);
 
+    /* Acquisition done events are published on a stream with our
+     * own service name */
+    int rc = mlm_client_set_producer (smio_get_worker (self),
+            smio_get_service (self));
+    ASSERT_TEST(rc == 0, "Could not set SMIO as stream producer",
+            err_set_producer, SMIO_ERR_PUBLISH_EVENT);
+
+    err = smio_set_timer_handler (self, ACQ_DONE_POLL_INTERVAL,
+            _acq_handle_done_timer);
+    ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO timer handler",
+            err_set_timer_handler);
+
     return err;
 
+err_set_timer_handler:
+err_set_producer:
+    smio_set_handler (self, NULL);
 err_smio_set_handler:
     smio_acq_destroy (&smio_handler);
 err_smio_handler_alloc:
@@ -888,6 +2028,8 @@ smio_err_e acq_shutdown (smio_t *self)
     ASSERT_TEST(acq != NULL, "Could not get ACQ handler",
             err_acq_handler, SMIO_ERR_ALLOC /* FIXME: improve return code */);
 
+    /* Stop watching for completed acquisitions */
+    smio_set_timer_handler (self, 0, NULL);
     /* Destroy SMIO instance */
     smio_acq_destroy (&acq);
     /* Nullify operation pointers */
@@ -154,6 +154,97 @@ disp_op_t acq_hw_data_trig_chan_exp = {
     }
 };
 
+disp_op_t acq_get_curve_stream_exp = {
+    .name = ACQ_NAME_GET_CURVE_STREAM,
+    .opcode = ACQ_OPCODE_GET_CURVE_STREAM,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_UINT64, uint64_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t acq_data_acquire_multi_exp = {
+    .name = ACQ_NAME_DATA_ACQUIRE_MULTI,
+    .opcode = ACQ_OPCODE_DATA_ACQUIRE_MULTI,
+    .retval = DISP_ARG_END,
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t acq_get_curve_reduced_exp = {
+    .name = ACQ_NAME_GET_CURVE_REDUCED,
+    .opcode = ACQ_OPCODE_GET_CURVE_REDUCED,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_STRUCT, smio_acq_data_block_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t acq_get_samples_exp = {
+    .name = ACQ_NAME_GET_SAMPLES,
+    .opcode = ACQ_OPCODE_GET_SAMPLES,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_STRUCT, smio_acq_data_block_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t acq_get_shot_exp = {
+    .name = ACQ_NAME_GET_SHOT,
+    .opcode = ACQ_OPCODE_GET_SHOT,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_STRUCT, smio_acq_data_block_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t acq_cache_size_exp = {
+    .name = ACQ_NAME_CACHE_SIZE,
+    .opcode = ACQ_OPCODE_CACHE_SIZE,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t acq_curve_stream_credit_exp = {
+    .name = ACQ_NAME_CURVE_STREAM_CREDIT,
+    .opcode = ACQ_OPCODE_CURVE_STREAM_CREDIT,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_UINT64, uint64_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
 /* Exported function description */
 const disp_op_t *acq_exp_ops [] = {
     &acq_data_acquire_exp,
@@ -168,6 +259,13 @@ const disp_op_t *acq_exp_ops [] = {
     &acq_sw_trig_exp,
     &acq_fsm_stop_exp,
     &acq_hw_data_trig_chan_exp,
+    &acq_get_curve_stream_exp,
+    &acq_data_acquire_multi_exp,
+    &acq_get_curve_reduced_exp,
+    &acq_get_samples_exp,
+    &acq_get_shot_exp,
+    &acq_cache_size_exp,
+    &acq_curve_stream_credit_exp,
     NULL
 };
 
@@ -22,6 +22,13 @@ extern disp_op_t acq_hw_trig_dly_exp;
 extern disp_op_t acq_sw_trig_exp;
 extern disp_op_t acq_fsm_stop_exp;
 extern disp_op_t acq_hw_data_trig_chan_exp;
+extern disp_op_t acq_get_curve_stream_exp;
+extern disp_op_t acq_data_acquire_multi_exp;
+extern disp_op_t acq_get_curve_reduced_exp;
+extern disp_op_t acq_get_samples_exp;
+extern disp_op_t acq_get_shot_exp;
+extern disp_op_t acq_cache_size_exp;
+extern disp_op_t acq_curve_stream_credit_exp;
 
 extern const disp_op_t *acq_exp_ops [];
 
@@ -217,7 +217,8 @@ smio_err_e afc_diag_init (smio_t * self)
     err = smio_set_ops (self, &afc_diag_ops);
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO operations",
             err_smio_set_ops);
-    err = smio_set_thsafe_client_ops (self, &smio_thsafe_client_zmq_ops);
+    err = smio_set_thsafe_client_ops (self,
+            devio_get_thsafe_client_ops (smio_get_parent (self)));
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO thsafe operations",
             err_smio_set_thsafe_ops);
 
@@ -8,6 +8,20 @@
 #ifndef _SM_IO_DSP_CODES_H_
 #define _SM_IO_DSP_CODES_H_
 
+/* Monitoring amplitudes and positions, all latched by the same update */
+struct _smio_dsp_monit_t {
+    uint32_t amp_ch0;                   /* Amplitude of channel 0 */
+    uint32_t amp_ch1;                   /* Amplitude of channel 1 */
+    uint32_t amp_ch2;                   /* Amplitude of channel 2 */
+    uint32_t amp_ch3;                   /* Amplitude of channel 3 */
+    uint32_t pos_x;                     /* Horizontal position */
+    uint32_t pos_y;                     /* Vertical position */
+    uint32_t pos_q;                     /* Skew position */
+    uint32_t pos_sum;                   /* Sum */
+    uint32_t updt;                      /* Update counter. Increments on every
+                                           latch performed through the server */
+};
+
 /* Messaging OPCODES */
 #define DSP_OPCODE_TYPE                     uint32_t
 #define DSP_OPCODE_SIZE                     (sizeof (DSP_OPCODE_TYPE))
@@ -42,6 +56,22 @@
 #define DSP_NAME_SET_GET_MONIT_POS_SUM      "dsp_set_get_monit_pos_sum"
 #define DSP_OPCODE_SET_GET_MONIT_UPDT       14
 #define DSP_NAME_SET_GET_MONIT_UPDT         "dsp_set_get_monit_updt"
-#define DSP_OPCODE_END                      15
+#define DSP_OPCODE_MONIT_AMP_POS            15
+#define DSP_NAME_MONIT_AMP_POS              "dsp_monit_amp_pos"
+#define DSP_OPCODE_SET_GET_MONIT_STREAM     16
+#define DSP_NAME_SET_GET_MONIT_STREAM       "dsp_set_get_monit_stream"
+#define DSP_OPCODE_SHADOW_RESYNC            17
+#define DSP_NAME_SHADOW_RESYNC              "dsp_shadow_resync"
+#define DSP_OPCODE_END                      18
+
+/* Monitoring sample event. While dsp_set_get_monit_stream has subscribers, the
+ * monitoring values are latched and published every DSP_MONIT_STREAM_PERIOD ms
+ * on the Malamute stream named after the SMIO service, with subject
+ * DSP_EVENT_MONIT.
+ * Message is:
+ * frame 0: monitoring values (smio_dsp_monit_t)
+ * frame 1: timestamp (ms since epoch) */
+#define DSP_EVENT_MONIT                     "DSP_MONIT"
+#define DSP_EVENT_MONIT_SIZE                2   /* 2 frames */
 
 #endif
@@ -8,8 +8,14 @@
 #ifndef _SM_IO_DSP_CORE_H_
 #define _SM_IO_DSP_CORE_H_
 
+/* Monitoring stream rate. Every period the values are latched and
+ * published, while there is at least one subscriber */
+#define DSP_MONIT_STREAM_PERIOD             10          /* in ms */
+
 typedef struct {
-    const uint32_t example;
+    uint32_t monit_updt_cnt;            /* Number of monitoring latches performed */
+    uint32_t monit_subscribers;         /* Number of clients subscribed to the
+                                           monitoring stream */
 } smio_dsp_t;
 
 /***************** Our methods *****************/
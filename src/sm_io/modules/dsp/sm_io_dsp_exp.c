@@ -167,12 +167,163 @@ RW_PARAM_FUNC(dsp, monit_pos_sum) {
 #define POS_CALC_DSP_MONIT_UPDT_W(val)          (val)
 #define POS_CALC_DSP_MONIT_UPDT_MASK            ((1ULL<<32)-1)
 
-RW_PARAM_FUNC(dsp, monit_updt) {
+RW_PARAM_FUNC(dsp, monit_updt_raw) {
     SET_GET_PARAM(dsp, 0x0, POS_CALC, DSP_MONIT_UPDT, /* No field */,
             MULT_BIT_PARAM, /* No minimum check*/, /* No maximum check */,
             NO_CHK_FUNC, NO_FMT_FUNC, SET_FIELD);
 }
 
+/* A write to the update register latches the AMP/POS values, so count it
+ * for the monitoring stream */
+static int _dsp_monit_updt (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
+
+    /* Message is:
+     * frame 0: operation code
+     * frame 1: rw      R /W    1 = read mode, 0 = write mode
+     * frame 2: value to be written (rw = 0) or dummy value (rw = 1) */
+    uint32_t rw = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+
+    int err = RW_PARAM_FUNC_NAME(dsp, monit_updt_raw) (owner, args, ret);
+    if (rw || err < 0) {
+        return err;
+    }
+
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_dsp_t *dsp = smio_get_handler (self);
+    ASSERT_TEST(dsp != NULL, "Could not get SMIO DSP handler",
+            err_get_dsp_handler, -RW_WRITE_EAGAIN);
+
+    dsp->monit_updt_cnt++;
+
+err_get_dsp_handler:
+    return err;
+}
+
+/* Queue the reads of all of the AMP/POS registers in txn */
+static void _dsp_txn_read_monit_values (smio_t *self, smio_thsafe_txn_t *txn,
+        smio_dsp_monit_t *monit)
+{
+    smio_thsafe_txn_read_32 (self, txn, POS_CALC_REG_DSP_MONIT_AMP_CH0, &monit->amp_ch0);
+    smio_thsafe_txn_read_32 (self, txn, POS_CALC_REG_DSP_MONIT_AMP_CH1, &monit->amp_ch1);
+    smio_thsafe_txn_read_32 (self, txn, POS_CALC_REG_DSP_MONIT_AMP_CH2, &monit->amp_ch2);
+    smio_thsafe_txn_read_32 (self, txn, POS_CALC_REG_DSP_MONIT_AMP_CH3, &monit->amp_ch3);
+    smio_thsafe_txn_read_32 (self, txn, POS_CALC_REG_DSP_MONIT_POS_X, &monit->pos_x);
+    smio_thsafe_txn_read_32 (self, txn, POS_CALC_REG_DSP_MONIT_POS_Y, &monit->pos_y);
+    smio_thsafe_txn_read_32 (self, txn, POS_CALC_REG_DSP_MONIT_POS_Q, &monit->pos_q);
+    smio_thsafe_txn_read_32 (self, txn, POS_CALC_REG_DSP_MONIT_POS_SUM, &monit->pos_sum);
+}
+
+/* Latch all of the monitoring values and read them back in a single
+ * transaction, so they come from the same update and cost a single round
+ * trip to DEVIO. The update register is written with the update counter and
+ * read back before the AMP/POS registers, so the latch has taken effect
+ * whichever access the gateware triggers on */
+static int _dsp_read_monit (smio_t *self, smio_dsp_t *dsp, smio_dsp_monit_t *monit)
+{
+    uint32_t updt = dsp->monit_updt_cnt + 1;
+    uint32_t updt_rd;
+    smio_thsafe_txn_t txn;
+
+    smio_thsafe_txn_init (&txn);
+    smio_thsafe_txn_write_32 (self, &txn, POS_CALC_REG_DSP_MONIT_UPDT, updt);
+    smio_thsafe_txn_read_32 (self, &txn, POS_CALC_REG_DSP_MONIT_UPDT, &updt_rd);
+    _dsp_txn_read_monit_values (self, &txn, monit);
+
+    ssize_t txn_ret = smio_thsafe_client_txn (self, &txn);
+    ASSERT_TEST(txn_ret >= 0, "Could not read monitoring values",
+            err_read_monit);
+
+    dsp->monit_updt_cnt = updt;
+    monit->updt = updt;
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:dsp_exp] "
+            "Monitoring update %u: x = 0x%08x, y = 0x%08x, q = 0x%08x, sum = 0x%08x\n",
+            updt, monit->pos_x, monit->pos_y, monit->pos_q, monit->pos_sum);
+
+    return sizeof (*monit);
+
+err_read_monit:
+    return -RW_READ_EAGAIN;
+}
+
+static int _dsp_monit_amp_pos (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
+    assert (ret);
+
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_dsp_t *dsp = (smio_dsp_t *) smio_get_handler (self);
+    ASSERT_TEST(dsp != NULL, "Could not get SMIO DSP handler",
+            err_get_dsp_handler);
+
+    return _dsp_read_monit (self, dsp, (smio_dsp_monit_t *) ret);
+
+err_get_dsp_handler:
+    return -RW_READ_EAGAIN;
+}
+
+static smio_err_e _dsp_handle_monit_timer (smio_t *self);
+
+/* Subscribe to or unsubscribe from the monitoring stream. The timer
+ * publishing the samples is armed by the first subscriber and disarmed when
+ * the last one leaves */
+static int _dsp_monit_stream (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
+    int err = -RW_OK;
+
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_dsp_t *dsp = smio_get_handler (self);
+    ASSERT_TEST(dsp != NULL, "Could not get SMIO DSP handler",
+            err_get_dsp_handler, -RW_INV);
+
+    /* Message is:
+     * frame 0: operation code
+     * frame 1: rw      R /W    1 = read mode, 0 = write mode
+     * frame 2: 1 to subscribe to the monitoring stream, 0 to unsubscribe */
+    uint32_t rw = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+    uint32_t subscribe = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+
+    if (rw) {
+        /* Return number of subscribers to caller */
+        *((uint32_t *) ret) = dsp->monit_subscribers;
+        err = sizeof (uint32_t);
+        goto out;
+    }
+
+    uint32_t subscribers = dsp->monit_subscribers;
+    if (subscribe) {
+        subscribers++;
+    }
+    else if (subscribers > 0) {
+        subscribers--;
+    }
+
+    /* Only the first subscriber and the last unsubscriber touch the timer */
+    if ((subscribers != 0) != (dsp->monit_subscribers != 0)) {
+        smio_err_e serr = smio_set_timer_handler (self,
+                subscribers? DSP_MONIT_STREAM_PERIOD : 0,
+                subscribers? _dsp_handle_monit_timer : NULL);
+        ASSERT_TEST(serr == SMIO_SUCCESS, "Could not set SMIO timer handler",
+                err_set_timer_handler, -RW_WRITE_EAGAIN);
+
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:dsp_exp] "
+                "Monitoring stream %s\n", subscribers? "enabled" : "disabled");
+    }
+
+    dsp->monit_subscribers = subscribers;
+
+out:
+err_set_timer_handler:
+err_get_dsp_handler:
+    return err;
+}
+
 /* Exported function pointers */
 const disp_table_func_fp dsp_exp_fp [] = {
     RW_PARAM_FUNC_NAME(dsp, kx),
@@ -189,7 +340,10 @@ const disp_table_func_fp dsp_exp_fp [] = {
     RW_PARAM_FUNC_NAME(dsp, monit_pos_y),
     RW_PARAM_FUNC_NAME(dsp, monit_pos_q),
     RW_PARAM_FUNC_NAME(dsp, monit_pos_sum),
-    RW_PARAM_FUNC_NAME(dsp, monit_updt),
+    _dsp_monit_updt,
+    _dsp_monit_amp_pos,
+    _dsp_monit_stream,
+    smio_shadow_resync_exp,
     NULL
 };
 
@@ -252,10 +406,55 @@ const smio_ops_t dsp_ops = {
     .do_op              = dsp_do_op            /* Generic wrapper for handling specific operations */
 };
 
+/************************************************************/
+/******************** Periodic Operations *******************/
+/************************************************************/
+
+/* Latch the monitoring values and publish them, once every
+ * DSP_MONIT_STREAM_PERIOD. Latches requested by the clients in between
+ * (dsp_monit_amp_pos or a write to dsp_set_get_monit_updt) are not published
+ * by themselves; the stream only carries the samples taken here */
+static smio_err_e _dsp_handle_monit_timer (smio_t *self)
+{
+    smio_err_e err = SMIO_SUCCESS;
+    smio_dsp_t *dsp = smio_get_handler (self);
+    ASSERT_TEST(dsp != NULL, "Could not get SMIO DSP handler",
+            err_get_dsp_handler, SMIO_ERR_ALLOC);
+
+    smio_dsp_monit_t monit;
+    int rc = _dsp_read_monit (self, dsp, &monit);
+    ASSERT_TEST(rc == sizeof (monit), "Could not read monitoring values",
+            err_read_monit, SMIO_ERR_LLIO);
+    uint64_t timestamp = zclock_time ();
+
+    /* Message is:
+     * frame 0: monitoring values (smio_dsp_monit_t)
+     * frame 1: timestamp */
+    zmsg_t *msg = zmsg_new ();
+    ASSERT_ALLOC(msg, err_msg_alloc, SMIO_ERR_ALLOC);
+    zmsg_addmem (msg, &monit, sizeof (monit));
+    zmsg_addmem (msg, &timestamp, sizeof (timestamp));
+
+    rc = mlm_client_send (smio_get_worker (self), DSP_EVENT_MONIT, &msg);
+    ASSERT_TEST(rc == 0, "Could not publish monitoring event",
+            err_send_msg, SMIO_ERR_PUBLISH_EVENT);
+
+err_send_msg:
+    zmsg_destroy (&msg);
+err_msg_alloc:
+err_read_monit:
+err_get_dsp_handler:
+    return err;
+}
+
 /************************************************************/
 /****************** Bootstrap Operations ********************/
 /************************************************************/
 
+/* Whole register bank, from DS_TBT_THRES to DSP_MONIT_UPDT */
+#define DSP_SHADOW_NUM_REGS                 ((POS_CALC_REG_DSP_MONIT_UPDT - POS_CALC_REG_DS_TBT_THRES) / \
+                                                sizeof (uint32_t) + 1)
+
 smio_err_e dsp_init (smio_t * self)
 {
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:dsp_exp] Initializing dsp\n");
@@ -271,7 +470,8 @@ smio_err_e dsp_init (smio_t * self)
     err = smio_set_ops (self, &dsp_ops);
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO operations",
             err_smio_set_ops);
-    err = smio_set_thsafe_client_ops (self, &smio_thsafe_client_zmq_ops);
+    err = smio_set_thsafe_client_ops (self,
+            devio_get_thsafe_client_ops (smio_get_parent (self)));
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO thsafe operations",
             err_smio_set_thsafe_ops);
 
@@ -294,8 +494,32 @@ smio_err_e dsp_init (smio_t * self)
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO handler",
             err_smio_set_handler);
 
+    /* Keep a shadow of the register bank, so field updates don't have to
+     * read the register back from hardware first. Counters, error clear and
+     * monitoring registers are driven by hardware and always read from it */
+    const smio_shadow_range_t volatile_regs [] = {
+        {POS_CALC_REG_DSP_CTNR_TBT, (POS_CALC_REG_DSP_ERR_CLR -
+                POS_CALC_REG_DSP_CTNR_TBT) / sizeof (uint32_t) + 1},
+        {POS_CALC_REG_DSP_MONIT_AMP_CH0, (POS_CALC_REG_DSP_MONIT_UPDT -
+                POS_CALC_REG_DSP_MONIT_AMP_CH0) / sizeof (uint32_t) + 1},
+    };
+    smio_shadow_setup (self, POS_CALC_REG_DS_TBT_THRES, DSP_SHADOW_NUM_REGS,
+            volatile_regs, ARRAY_SIZE(volatile_regs));
+
+    /* Monitoring samples are published on a stream with our own
+     * service name */
+    int rc = mlm_client_set_producer (smio_get_worker (self),
+            smio_get_service (self));
+    ASSERT_TEST(rc == 0, "Could not set SMIO as stream producer",
+            err_set_producer, SMIO_ERR_PUBLISH_EVENT);
+
+    /* The timer publishing them is only armed while the monitoring stream
+     * has subscribers (see _dsp_monit_stream ()) */
     return err;
 
+err_set_producer:
+    smio_shadow_free (self);
+    smio_set_handler (self, NULL);
 err_smio_set_handler:
     smio_dsp_destroy (&smio_handler);
 err_smio_handler_alloc:
@@ -321,6 +545,8 @@ smio_err_e dsp_shutdown (smio_t *self)
     ASSERT_TEST(dsp != NULL, "Could not get DSP handler",
             err_dsp_handler, SMIO_ERR_ALLOC /* FIXME: improve return code */);
 
+    /* Stop publishing monitoring samples */
+    smio_set_timer_handler (self, 0, NULL);
     /* Destroy SMIO instance */
     smio_dsp_destroy (&dsp);
     /* Nullify operation pointers */
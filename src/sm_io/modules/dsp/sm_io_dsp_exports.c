@@ -190,6 +190,40 @@ disp_op_t dsp_set_get_monit_updt_exp = {
     }
 };
 
+disp_op_t dsp_monit_amp_pos_exp = {
+    .name = DSP_NAME_MONIT_AMP_POS,
+    .opcode = DSP_OPCODE_MONIT_AMP_POS,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_STRUCT, smio_dsp_monit_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_END
+    }
+};
+
+disp_op_t dsp_set_get_monit_stream_exp = {
+    .name = DSP_NAME_SET_GET_MONIT_STREAM,
+    .opcode = DSP_OPCODE_SET_GET_MONIT_STREAM,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t dsp_shadow_resync_exp = {
+    .name = DSP_NAME_SHADOW_RESYNC,
+    .opcode = DSP_OPCODE_SHADOW_RESYNC,
+    .retval = DISP_ARG_END,
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
 /* Exported function description */
 const disp_op_t *dsp_exp_ops [] = {
     &dsp_set_get_kx_exp,
@@ -207,6 +241,9 @@ const disp_op_t *dsp_exp_ops [] = {
     &dsp_set_get_monit_pos_q_exp,
     &dsp_set_get_monit_pos_sum_exp,
     &dsp_set_get_monit_updt_exp,
+    &dsp_monit_amp_pos_exp,
+    &dsp_set_get_monit_stream_exp,
+    &dsp_shadow_resync_exp,
     NULL
 };
 
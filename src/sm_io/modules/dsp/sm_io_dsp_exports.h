@@ -25,6 +25,9 @@ extern disp_op_t dsp_set_get_monit_pos_y_exp;
 extern disp_op_t dsp_set_get_monit_pos_q_exp;
 extern disp_op_t dsp_set_get_monit_pos_sum_exp;
 extern disp_op_t dsp_set_get_monit_updt_exp;
+extern disp_op_t dsp_monit_amp_pos_exp;
+extern disp_op_t dsp_set_get_monit_stream_exp;
+extern disp_op_t dsp_shadow_resync_exp;
 
 extern const disp_op_t *dsp_exp_ops [];
 
@@ -8,6 +8,25 @@
 #ifndef _SM_IO_FMC130M_4CH_CODES_H_
 #define _SM_IO_FMC130M_4CH_CODES_H_
 
+#define FMC130M_4CH_NUM_CHANNELS                        4
+/* Number of IDELAY taps of each ADC channel */
+#define FMC130M_4CH_IDELAY_TAPS                         32
+/* No tap was good enough in the calibration sweep */
+#define FMC130M_4CH_DLY_CAL_NO_EYE                      0xFFFFFFFF
+
+/* ADC delay calibration results. The spread is the peak-to-peak value of
+ * the samples captured at each tap, with the ADC inputs held at a steady
+ * level. Taps sampling in the middle of the data eye read back a steady
+ * value, so the smaller the spread, the better the tap */
+struct _smio_fmc130m_4ch_dly_cal_t {
+    uint32_t spread[FMC130M_4CH_NUM_CHANNELS][FMC130M_4CH_IDELAY_TAPS];
+                                                /* Eye map, per channel and tap */
+    uint32_t best[FMC130M_4CH_NUM_CHANNELS];    /* Chosen tap, or FMC130M_4CH_DLY_CAL_NO_EYE */
+    uint32_t eye_width[FMC130M_4CH_NUM_CHANNELS];
+                                                /* Number of good taps around the
+                                                   chosen one */
+};
+
 /* Messaging OPCODES */
 #define FMC130M_4CH_OPCODE_TYPE                         uint32_t
 #define FMC130M_4CH_OPCODE_SIZE                         (sizeof (FMC130M_4CH_OPCODE_TYPE))
@@ -60,7 +79,9 @@
 #define FMC130M_4CH_NAME_ADC_DLY2                       "fmc130m_4ch_adc_dly2"
 #define FMC130M_4CH_OPCODE_ADC_DLY3                     28
 #define FMC130M_4CH_NAME_ADC_DLY3                       "fmc130m_4ch_adc_dly3"
-#define FMC130M_4CH_OPCODE_END                          29
+#define FMC130M_4CH_OPCODE_ADC_DLY_CAL                  29
+#define FMC130M_4CH_NAME_ADC_DLY_CAL                    "fmc130m_4ch_adc_dly_cal"
+#define FMC130M_4CH_OPCODE_END                          30
 
 /* Messaging Reply OPCODES */
 #define FMC130M_4CH_REPLY_TYPE                          uint32_t
@@ -361,6 +361,172 @@ FMC130M_4CH_ADC_DLY_FUNC_HEADER(3)
     FMC130M_4CH_ADC_DLY_FUNC_BODY(owner, args, ret, 3);
 }
 
+/************************ ADC Delay Calibration Sweep *************************/
+
+/* Distance between the IDELAY and data registers of consecutive channels */
+#define FMC130M_4CH_CHAN_REG_STRIDE                 (WB_FMC_130M_4CH_CSR_REG_IDELAY1_CAL - \
+                                                        WB_FMC_130M_4CH_CSR_REG_IDELAY0_CAL)
+/* Bounds the sweep time: each tap costs a 1 ms settling wait plus one DEVIO
+ * round trip per THSAFE_TXN_MAX_OPS samples, so the 4 channels x 32 taps of
+ * a full sweep stay within a few hundred ms */
+#define FMC130M_4CH_DLY_CAL_MAX_SAMPLES             1024
+
+/* Capture num_samples samples from the ADC raw data register and return
+ * their peak-to-peak value. Samples are read in transactions, so we pay
+ * one DEVIO round trip per THSAFE_TXN_MAX_OPS samples */
+static int _fmc130m_4ch_adc_spread (smio_t *owner, uint64_t data_addr,
+        uint32_t num_samples, uint32_t *spread)
+{
+    uint32_t samples [THSAFE_TXN_MAX_OPS];
+    int32_t min = INT32_MAX;
+    int32_t max = INT32_MIN;
+    smio_thsafe_txn_t txn;
+
+    while (num_samples > 0) {
+        uint32_t num_reads = (num_samples < THSAFE_TXN_MAX_OPS) ?
+            num_samples : THSAFE_TXN_MAX_OPS;
+        uint32_t i;
+
+        smio_thsafe_txn_init (&txn);
+        for (i = 0; i < num_reads; ++i) {
+            smio_thsafe_txn_read_32 (owner, &txn, data_addr, &samples [i]);
+        }
+
+        ssize_t txn_ret = smio_thsafe_client_txn (owner, &txn);
+        ASSERT_TEST(txn_ret >= 0, "Could not read ADC samples", err_read_samples);
+
+        for (i = 0; i < num_reads; ++i) {
+            int32_t sample = (int32_t) WBGEN2_SIGN_EXTEND(samples [i], 15);
+            if (sample < min) {
+                min = sample;
+            }
+            if (sample > max) {
+                max = sample;
+            }
+        }
+
+        num_samples -= num_reads;
+    }
+
+    *spread = (uint32_t) (max - min);
+    return -FMC130M_4CH_OK;
+
+err_read_samples:
+    return -FMC130M_4CH_ERR;
+}
+
+/* Choose the tap at the center of the longest run of taps whose spread is
+ * at most max_spread */
+static void _fmc130m_4ch_dly_cal_best (const uint32_t *spread, uint32_t max_spread,
+        uint32_t *best, uint32_t *eye_width)
+{
+    uint32_t run_start = 0;
+    uint32_t run_width = 0;
+    uint32_t tap;
+
+    *best = FMC130M_4CH_DLY_CAL_NO_EYE;
+    *eye_width = 0;
+
+    for (tap = 0; tap < FMC130M_4CH_IDELAY_TAPS; ++tap) {
+        if (spread [tap] > max_spread) {
+            run_width = 0;
+            continue;
+        }
+
+        if (run_width == 0) {
+            run_start = tap;
+        }
+        run_width++;
+
+        if (run_width > *eye_width) {
+            *eye_width = run_width;
+            *best = run_start + run_width/2;
+        }
+    }
+}
+
+/* Sweep all IDELAY taps of all channels and leave each channel at the
+ * center of its data eye. Channels with no good tap are restored to their
+ * previous delay. The ADC inputs must be held at a steady level during
+ * the sweep */
+static int _fmc130m_4ch_adc_dly_cal (void *owner, void *args, void *ret)
+{
+    assert (owner);
+    assert (args);
+    assert (ret);
+
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    smio_fmc130m_4ch_dly_cal_t *dly_cal = (smio_fmc130m_4ch_dly_cal_t *) ret;
+    uint32_t dly_type = *(uint32_t *) EXP_MSG_ZMQ_FIRST_ARG(args);
+    uint32_t num_samples = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    uint32_t max_spread = *(uint32_t *) EXP_MSG_ZMQ_NEXT_ARG(args);
+    int err = -FMC130M_4CH_OK;
+    uint32_t chan;
+    /* Delay of the channel being swept, to restore it on error */
+    uint64_t dly_addr = 0;
+    uint32_t prev_dly = 0;
+
+    ASSERT_TEST(dly_type != 0 && (dly_type & ~DLY_TYPE_ALL) == 0,
+            "Delay type is invalid", err_args, -FMC130M_4CH_ERR);
+    ASSERT_TEST(num_samples > 0 && num_samples <= FMC130M_4CH_DLY_CAL_MAX_SAMPLES,
+            "Number of samples is out of range", err_args, -FMC130M_4CH_ERR);
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:fmc130m_4ch] "
+            "Calibrating ADC delays with %u samples per tap\n", num_samples);
+
+    for (chan = 0; chan < FMC130M_4CH_NUM_CHANNELS; ++chan) {
+        uint64_t data_addr = WB_FMC_130M_4CH_CSR_REG_DATA0 +
+            chan*FMC130M_4CH_CHAN_REG_STRIDE;
+        uint32_t tap;
+
+        dly_addr = WB_FMC_130M_4CH_CSR_REG_IDELAY0_CAL +
+            chan*FMC130M_4CH_CHAN_REG_STRIDE;
+        /* Without the previous delay we could not restore the channel, so
+         * do not even start sweeping it */
+        ssize_t rc = smio_thsafe_client_read_32 (self, dly_addr, &prev_dly);
+        ASSERT_TEST(rc == sizeof (prev_dly), "Could not read previous ADC delay",
+                err_read_dly, -FMC130M_4CH_ERR);
+        prev_dly = FMC_130M_4CH_IDELAY_CAL_VAL_R(prev_dly);
+
+        for (tap = 0; tap < FMC130M_4CH_IDELAY_TAPS; ++tap) {
+            err = _fmc130m_4ch_set_adc_dly_ll (self, dly_addr, tap, dly_type);
+            ASSERT_TEST(err == -FMC130M_4CH_OK, "Could not set ADC delay",
+                    err_sweep);
+
+            err = _fmc130m_4ch_adc_spread (self, data_addr, num_samples,
+                    &dly_cal->spread [chan][tap]);
+            ASSERT_TEST(err == -FMC130M_4CH_OK, "Could not capture ADC samples",
+                    err_sweep);
+        }
+
+        _fmc130m_4ch_dly_cal_best (dly_cal->spread [chan], max_spread,
+                &dly_cal->best [chan], &dly_cal->eye_width [chan]);
+
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:fmc130m_4ch] "
+                "Channel %u: best tap = %u, eye width = %u\n", chan,
+                dly_cal->best [chan], dly_cal->eye_width [chan]);
+
+        err = _fmc130m_4ch_set_adc_dly_ll (self, dly_addr,
+                (dly_cal->best [chan] != FMC130M_4CH_DLY_CAL_NO_EYE) ?
+                dly_cal->best [chan] : prev_dly, dly_type);
+        ASSERT_TEST(err == -FMC130M_4CH_OK, "Could not set calibrated ADC delay",
+                err_sweep);
+    }
+
+    return sizeof (*dly_cal);
+
+err_sweep:
+    /* Do not leave the channel at whatever tap the sweep stopped */
+    if (_fmc130m_4ch_set_adc_dly_ll (self, dly_addr, prev_dly, dly_type) !=
+            -FMC130M_4CH_OK) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io:fmc130m_4ch] "
+                "Could not restore ADC delay of channel %u\n", chan);
+    }
+err_read_dly:
+err_args:
+    return err;
+}
+
 /* Exported function pointers */
 const disp_table_func_fp fmc130m_4ch_exp_fp [] = {
     RW_PARAM_FUNC_NAME(fmc130m_4ch, adc_rand),
@@ -387,6 +553,7 @@ const disp_table_func_fp fmc130m_4ch_exp_fp [] = {
     FMC130M_4CH_ADC_DLY_FUNC_NAME(1),
     FMC130M_4CH_ADC_DLY_FUNC_NAME(2),
     FMC130M_4CH_ADC_DLY_FUNC_NAME(3),
+    _fmc130m_4ch_adc_dly_cal,
     NULL
 };
 
@@ -469,7 +636,8 @@ smio_err_e fmc130m_4ch_init (smio_t * self)
     err = smio_set_ops (self, &fmc130m_4ch_ops);
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO operations",
             err_smio_set_ops);
-    err = smio_set_thsafe_client_ops (self, &smio_thsafe_client_zmq_ops);
+    err = smio_set_thsafe_client_ops (self,
+            devio_get_thsafe_client_ops (smio_get_parent (self)));
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO thsafe operations",
             err_smio_set_thsafe_ops);
 
@@ -299,6 +299,19 @@ disp_op_t fmc130m_4ch_adc_dly3_exp = {
     }
 };
 
+disp_op_t fmc130m_4ch_adc_dly_cal_exp = {
+    .name = FMC130M_4CH_NAME_ADC_DLY_CAL,
+    .opcode = FMC130M_4CH_OPCODE_ADC_DLY_CAL,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_STRUCT, smio_fmc130m_4ch_dly_cal_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
 /* Exported function description */
 const disp_op_t *fmc130m_4ch_exp_ops [] = {
     &fmc130m_4ch_adc_rand_exp,
@@ -325,6 +338,7 @@ const disp_op_t *fmc130m_4ch_exp_ops [] = {
     &fmc130m_4ch_adc_dly1_exp,
     &fmc130m_4ch_adc_dly2_exp,
     &fmc130m_4ch_adc_dly3_exp,
+    &fmc130m_4ch_adc_dly_cal_exp,
     NULL
 };
 
@@ -78,7 +78,15 @@
 #define FMC250M_4CH_NAME_TESTMODE2                      "fmc250m_4ch_test_mode2"
 #define FMC250M_4CH_OPCODE_TESTMODE3                    51
 #define FMC250M_4CH_NAME_TESTMODE3                      "fmc350m_4ch_test_mode3"
-#define FMC250M_4CH_OPCODE_END                          52
+#define FMC250M_4CH_OPCODE_ISLA216P_RESYNC0             52
+#define FMC250M_4CH_NAME_ISLA216P_RESYNC0               "fmc250m_4ch_isla216p_resync0"
+#define FMC250M_4CH_OPCODE_ISLA216P_RESYNC1             53
+#define FMC250M_4CH_NAME_ISLA216P_RESYNC1               "fmc250m_4ch_isla216p_resync1"
+#define FMC250M_4CH_OPCODE_ISLA216P_RESYNC2             54
+#define FMC250M_4CH_NAME_ISLA216P_RESYNC2               "fmc250m_4ch_isla216p_resync2"
+#define FMC250M_4CH_OPCODE_ISLA216P_RESYNC3             55
+#define FMC250M_4CH_NAME_ISLA216P_RESYNC3               "fmc250m_4ch_isla216p_resync3"
+#define FMC250M_4CH_OPCODE_END                          56
 
 /* Messaging Reply OPCODES */
 #define FMC250M_4CH_REPLY_TYPE                          uint32_t
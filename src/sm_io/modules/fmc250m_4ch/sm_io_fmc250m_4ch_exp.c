@@ -452,6 +452,37 @@ FMC250M_4CH_ISLA216P_FUNC_NAME_HEADER(test_mode3)
             smch_isla216p_test_mode_compat, "Could not set/get ISLA216P test mode");
 }
 
+static smch_err_e smch_isla216p_resync_compat (smch_isla216p_t *self,
+        uint32_t *param)
+{
+    (void) param;
+    return smch_isla216p_resync (self);
+}
+
+FMC250M_4CH_ISLA216P_FUNC_NAME_HEADER(resync0)
+{
+    FMC250M_4CH_ISLA216P_FUNC_BODY(owner, args, ret, 0, /* No read function */,
+            smch_isla216p_resync_compat, "Could not resync ISLA216P registers");
+}
+
+FMC250M_4CH_ISLA216P_FUNC_NAME_HEADER(resync1)
+{
+    FMC250M_4CH_ISLA216P_FUNC_BODY(owner, args, ret, 1, /* No read function */,
+            smch_isla216p_resync_compat, "Could not resync ISLA216P registers");
+}
+
+FMC250M_4CH_ISLA216P_FUNC_NAME_HEADER(resync2)
+{
+    FMC250M_4CH_ISLA216P_FUNC_BODY(owner, args, ret, 2, /* No read function */,
+            smch_isla216p_resync_compat, "Could not resync ISLA216P registers");
+}
+
+FMC250M_4CH_ISLA216P_FUNC_NAME_HEADER(resync3)
+{
+    FMC250M_4CH_ISLA216P_FUNC_BODY(owner, args, ret, 3, /* No read function */,
+            smch_isla216p_resync_compat, "Could not resync ISLA216P registers");
+}
+
 /* Exported function pointers */
 const disp_table_func_fp fmc250m_4ch_exp_fp [] = {
 #if 0
@@ -489,6 +520,10 @@ const disp_table_func_fp fmc250m_4ch_exp_fp [] = {
     FMC250M_4CH_ISLA216P_FUNC_NAME(test_mode1),
     FMC250M_4CH_ISLA216P_FUNC_NAME(test_mode2),
     FMC250M_4CH_ISLA216P_FUNC_NAME(test_mode3),
+    FMC250M_4CH_ISLA216P_FUNC_NAME(resync0),
+    FMC250M_4CH_ISLA216P_FUNC_NAME(resync1),
+    FMC250M_4CH_ISLA216P_FUNC_NAME(resync2),
+    FMC250M_4CH_ISLA216P_FUNC_NAME(resync3),
     NULL
 };
 
@@ -571,7 +606,8 @@ smio_err_e fmc250m_4ch_init (smio_t * self)
     err = smio_set_ops (self, &fmc250m_4ch_ops);
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO operations",
             err_smio_set_ops);
-    err = smio_set_thsafe_client_ops (self, &smio_thsafe_client_zmq_ops);
+    err = smio_set_thsafe_client_ops (self,
+            devio_get_thsafe_client_ops (smio_get_parent (self)));
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO thsafe operations",
             err_smio_set_thsafe_ops);
 
@@ -387,6 +387,54 @@ disp_op_t fmc250m_4ch_test_mode3_exp = {
     }
 };
 
+disp_op_t fmc250m_4ch_isla216p_resync0_exp = {
+    .name = FMC250M_4CH_NAME_ISLA216P_RESYNC0,
+    .opcode = FMC250M_4CH_OPCODE_ISLA216P_RESYNC0,
+    .retval = DISP_ARG_END,
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t fmc250m_4ch_isla216p_resync1_exp = {
+    .name = FMC250M_4CH_NAME_ISLA216P_RESYNC1,
+    .opcode = FMC250M_4CH_OPCODE_ISLA216P_RESYNC1,
+    .retval = DISP_ARG_END,
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t fmc250m_4ch_isla216p_resync2_exp = {
+    .name = FMC250M_4CH_NAME_ISLA216P_RESYNC2,
+    .opcode = FMC250M_4CH_OPCODE_ISLA216P_RESYNC2,
+    .retval = DISP_ARG_END,
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t fmc250m_4ch_isla216p_resync3_exp = {
+    .name = FMC250M_4CH_NAME_ISLA216P_RESYNC3,
+    .opcode = FMC250M_4CH_OPCODE_ISLA216P_RESYNC3,
+    .retval = DISP_ARG_END,
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
 /* Exported function description */
 const disp_op_t *fmc250m_4ch_exp_ops [] = {
 #if 0
@@ -424,6 +472,10 @@ const disp_op_t *fmc250m_4ch_exp_ops [] = {
     &fmc250m_4ch_test_mode1_exp,
     &fmc250m_4ch_test_mode2_exp,
     &fmc250m_4ch_test_mode3_exp,
+    &fmc250m_4ch_isla216p_resync0_exp,
+    &fmc250m_4ch_isla216p_resync1_exp,
+    &fmc250m_4ch_isla216p_resync2_exp,
+    &fmc250m_4ch_isla216p_resync3_exp,
     NULL
 };
 
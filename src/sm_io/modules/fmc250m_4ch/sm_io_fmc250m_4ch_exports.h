@@ -45,6 +45,10 @@ extern disp_op_t fmc250m_4ch_test_mode0_exp;
 extern disp_op_t fmc250m_4ch_test_mode1_exp;
 extern disp_op_t fmc250m_4ch_test_mode2_exp;
 extern disp_op_t fmc250m_4ch_test_mode3_exp;
+extern disp_op_t fmc250m_4ch_isla216p_resync0_exp;
+extern disp_op_t fmc250m_4ch_isla216p_resync1_exp;
+extern disp_op_t fmc250m_4ch_isla216p_resync2_exp;
+extern disp_op_t fmc250m_4ch_isla216p_resync3_exp;
 
 extern const disp_op_t *fmc250m_4ch_exp_ops [];
 
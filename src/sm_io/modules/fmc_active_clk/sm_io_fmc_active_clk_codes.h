@@ -44,7 +44,11 @@
 #define FMC_ACTIVE_CLK_NAME_SI571_FREQ                     "fmc_active_clk_si571_freq"
 #define FMC_ACTIVE_CLK_OPCODE_SI571_GET_DEFAULTS           15
 #define FMC_ACTIVE_CLK_NAME_SI571_GET_DEFAULTS             "fmc_active_clk_si571_get_defaults"
-#define FMC_ACTIVE_CLK_OPCODE_END                          16
+#define FMC_ACTIVE_CLK_OPCODE_AD9510_RESYNC                16
+#define FMC_ACTIVE_CLK_NAME_AD9510_RESYNC                  "fmc_active_clk_ad9510_resync"
+#define FMC_ACTIVE_CLK_OPCODE_SI571_RESYNC                 17
+#define FMC_ACTIVE_CLK_NAME_SI571_RESYNC                   "fmc_active_clk_si571_resync"
+#define FMC_ACTIVE_CLK_OPCODE_END                          18
 
 /* Messaging Reply OPCODES */
 #define FMC_ACTIVE_CLK_REPLY_TYPE                          uint32_t
@@ -320,6 +320,30 @@ FMC_ACTIVE_CLK_SI571_FUNC_NAME_HEADER(get_defaults)
             smch_si57x_get_defaults_compat, "Could not restart SI571 to its defaults");
 }
 
+static smch_err_e smch_ad9510_resync_compat (smch_ad9510_t *self, uint32_t *param)
+{
+    (void) param;
+    return smch_ad9510_resync (self);
+}
+
+FMC_ACTIVE_CLK_AD9510_FUNC_NAME_HEADER(resync)
+{
+    FMC_ACTIVE_CLK_AD9510_FUNC_BODY(owner, args, ret, /* No read function */,
+            smch_ad9510_resync_compat, "Could not resync AD9510 registers");
+}
+
+static smch_err_e smch_si57x_resync_compat (smch_si57x_t *self, double *param)
+{
+    (void) param;
+    return smch_si57x_resync (self);
+}
+
+FMC_ACTIVE_CLK_SI571_FUNC_NAME_HEADER(resync)
+{
+    FMC_ACTIVE_CLK_SI571_FUNC_BODY(owner, args, ret, /* No read func*/,
+            smch_si57x_resync_compat, "Could not resync SI571 registers");
+}
+
 /* Exported function pointers */
 const disp_table_func_fp fmc_active_clk_exp_fp [] = {
     RW_PARAM_FUNC_NAME(fmc_active_clk, si571_oe),
@@ -338,6 +362,8 @@ const disp_table_func_fp fmc_active_clk_exp_fp [] = {
     FMC_ACTIVE_CLK_AD9510_FUNC_NAME(pll_clk_sel),
     FMC_ACTIVE_CLK_SI571_FUNC_NAME(freq),
     FMC_ACTIVE_CLK_SI571_FUNC_NAME(get_defaults),
+    FMC_ACTIVE_CLK_AD9510_FUNC_NAME(resync),
+    FMC_ACTIVE_CLK_SI571_FUNC_NAME(resync),
     NULL
 };
 
@@ -420,7 +446,8 @@ smio_err_e fmc_active_clk_init (smio_t * self)
     err = smio_set_ops (self, &fmc_active_clk_ops);
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO operations",
             err_smio_set_ops);
-    err = smio_set_thsafe_client_ops (self, &smio_thsafe_client_zmq_ops);
+    err = smio_set_thsafe_client_ops (self,
+            devio_get_thsafe_client_ops (smio_get_parent (self)));
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO thsafe operations",
             err_smio_set_thsafe_ops);
 
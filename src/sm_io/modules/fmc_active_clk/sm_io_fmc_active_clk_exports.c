@@ -202,6 +202,30 @@ disp_op_t fmc_active_clk_si571_get_defaults_exp = {
     }
 };
 
+disp_op_t fmc_active_clk_ad9510_resync_exp = {
+    .name = FMC_ACTIVE_CLK_NAME_AD9510_RESYNC,
+    .opcode = FMC_ACTIVE_CLK_OPCODE_AD9510_RESYNC,
+    .retval = DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
+disp_op_t fmc_active_clk_si571_resync_exp = {
+    .name = FMC_ACTIVE_CLK_NAME_SI571_RESYNC,
+    .opcode = FMC_ACTIVE_CLK_OPCODE_SI571_RESYNC,
+    .retval = DISP_ARG_END,
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_DOUBLE, double),
+        DISP_ARG_END
+    }
+};
+
 /* Exported function description */
 const disp_op_t *fmc_active_clk_exp_ops [] = {
     &fmc_active_clk_si571_oe_exp,
@@ -220,6 +244,8 @@ const disp_op_t *fmc_active_clk_exp_ops [] = {
     &fmc_active_clk_ad9510_pll_clk_sel_exp,
     &fmc_active_clk_si571_freq_exp,
     &fmc_active_clk_si571_get_defaults_exp,
+    &fmc_active_clk_ad9510_resync_exp,
+    &fmc_active_clk_si571_resync_exp,
     NULL
 };
 
@@ -26,6 +26,8 @@ extern disp_op_t fmc_active_clk_ad9510_outputs_exp;
 extern disp_op_t fmc_active_clk_ad9510_pll_clk_sel_exp;
 extern disp_op_t fmc_active_clk_si571_freq_exp;
 extern disp_op_t fmc_active_clk_si571_get_defaults_exp;
+extern disp_op_t fmc_active_clk_ad9510_resync_exp;
+extern disp_op_t fmc_active_clk_si571_resync_exp;
 
 extern const disp_op_t *fmc_active_clk_exp_ops [];
 
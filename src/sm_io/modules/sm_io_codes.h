@@ -20,6 +20,10 @@ typedef struct _smio_afc_diag_revision_data_t smio_afc_diag_revision_data_t;
 typedef struct _smio_rffe_data_block_t smio_rffe_data_block_t;
 /* Forward smio_rffe_version_t declaration structure */
 typedef struct _smio_rffe_version_t smio_rffe_version_t;
+/* Forward smio_fmc130m_4ch_dly_cal_t declaration structure */
+typedef struct _smio_fmc130m_4ch_dly_cal_t smio_fmc130m_4ch_dly_cal_t;
+/* Forward smio_dsp_monit_t declaration structure */
+typedef struct _smio_dsp_monit_t smio_dsp_monit_t;
 
 /* Include all module's codes */
 #include "sm_io_fmc130m_4ch_codes.h"
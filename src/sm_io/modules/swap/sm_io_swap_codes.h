@@ -34,7 +34,9 @@
 #define SWAP_NAME_SET_GET_GAIN_C            "swap_set_get_gain_c"
 #define SWAP_OPCODE_SET_GET_GAIN_D          10
 #define SWAP_NAME_SET_GET_GAIN_D            "swap_set_get_gain_d"
-#define SWAP_OPCODE_END                     11
+#define SWAP_OPCODE_SHADOW_RESYNC           11
+#define SWAP_NAME_SHADOW_RESYNC             "swap_shadow_resync"
+#define SWAP_OPCODE_END                     12
 
 #endif
 
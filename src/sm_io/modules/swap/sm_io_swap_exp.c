@@ -176,6 +176,7 @@ const disp_table_func_fp swap_exp_fp [] = {
     RW_PARAM_FUNC_NAME(swap, gain_b),
     RW_PARAM_FUNC_NAME(swap, gain_c),
     RW_PARAM_FUNC_NAME(swap, gain_d),
+    smio_shadow_resync_exp,
     NULL
 };
 
@@ -242,6 +243,10 @@ const smio_ops_t swap_ops = {
 /****************** Bootstrap Operations ********************/
 /************************************************************/
 
+/* Configuration registers, from CTRL to WDW_CTL */
+#define SWAP_SHADOW_NUM_REGS                ((BPM_SWAP_REG_WDW_CTL - BPM_SWAP_REG_CTRL) / \
+                                                sizeof (uint32_t) + 1)
+
 smio_err_e swap_init (smio_t * self)
 {
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:swap_exp] Initializing swap\n");
@@ -257,7 +262,8 @@ smio_err_e swap_init (smio_t * self)
     err = smio_set_ops (self, &swap_ops);
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO operations",
             err_smio_set_ops);
-    err = smio_set_thsafe_client_ops (self, &smio_thsafe_client_zmq_ops);
+    err = smio_set_thsafe_client_ops (self,
+            devio_get_thsafe_client_ops (smio_get_parent (self)));
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO thsafe operations",
             err_smio_set_thsafe_ops);
 
@@ -282,6 +288,11 @@ smio_err_e swap_init (smio_t * self)
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO handler",
             err_smio_set_handler);
 
+    /* All of the registers are configuration ones, only changed by us. Keep
+     * a shadow of them, so field updates don't have to read the register
+     * back from hardware first */
+    smio_shadow_setup (self, BPM_SWAP_REG_CTRL, SWAP_SHADOW_NUM_REGS, NULL, 0);
+
     return err;
 
 err_smio_set_handler:
@@ -130,6 +130,18 @@ disp_op_t swap_set_get_gain_d_exp = {
     }
 };
 
+disp_op_t swap_shadow_resync_exp = {
+    .name = SWAP_NAME_SHADOW_RESYNC,
+    .opcode = SWAP_OPCODE_SHADOW_RESYNC,
+    .retval = DISP_ARG_END,
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
 /* Exported function description */
 const disp_op_t *swap_exp_ops [] = {
     &swap_set_get_sw_exp,
@@ -142,5 +154,6 @@ const disp_op_t *swap_exp_ops [] = {
     &swap_set_get_gain_b_exp,
     &swap_set_get_gain_c_exp,
     &swap_set_get_gain_d_exp,
+    &swap_shadow_resync_exp,
     NULL
 };
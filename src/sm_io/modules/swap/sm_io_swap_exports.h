@@ -20,6 +20,7 @@ extern disp_op_t swap_set_get_gain_a_exp;
 extern disp_op_t swap_set_get_gain_b_exp;
 extern disp_op_t swap_set_get_gain_c_exp;
 extern disp_op_t swap_set_get_gain_d_exp;
+extern disp_op_t swap_shadow_resync_exp;
 
 extern const disp_op_t *swap_exp_ops [];
 
@@ -28,7 +28,9 @@
 #define TRIGGER_IFACE_NAME_COUNT_RCV                        "trigger_iface_count_rcv"
 #define TRIGGER_IFACE_OPCODE_COUNT_TRANSM                   7
 #define TRIGGER_IFACE_NAME_COUNT_TRANSM                     "trigger_iface_count_transm"
-#define TRIGGER_IFACE_OPCODE_END                            8
+#define TRIGGER_IFACE_OPCODE_SHADOW_RESYNC                  8
+#define TRIGGER_IFACE_NAME_SHADOW_RESYNC                    "trigger_iface_shadow_resync"
+#define TRIGGER_IFACE_OPCODE_END                            9
 
 /* Messaging Reply OPCODES */
 #define TRIGGER_IFACE_REPLY_TYPE                            uint32_t
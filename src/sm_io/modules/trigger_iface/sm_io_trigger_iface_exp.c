@@ -123,6 +123,7 @@ const disp_table_func_fp trigger_iface_exp_fp [] = {
     RW_PARAM_FUNC_NAME(trigger_iface, transm_len),
     RW_PARAM_FUNC_NAME(trigger_iface, count_rcv),
     RW_PARAM_FUNC_NAME(trigger_iface, count_transm),
+    smio_shadow_resync_exp,
     NULL
 };
 
@@ -190,6 +191,10 @@ const smio_ops_t trigger_iface_ops = {
 /****************** Bootstrap Operations ********************/
 /************************************************************/
 
+/* Registers of all channels */
+#define TRIGGER_IFACE_SHADOW_NUM_REGS       (TRIGGER_IFACE_NUM_CHAN * TRIGGER_IFACE_CHAN_OFFSET / \
+                                                sizeof (uint32_t))
+
 smio_err_e trigger_iface_init (smio_t * self)
 {
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:trigger_iface_exp] Initializing trigger_iface\n");
@@ -205,7 +210,8 @@ smio_err_e trigger_iface_init (smio_t * self)
     err = smio_set_ops (self, &trigger_iface_ops);
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO operations",
             err_smio_set_ops);
-    err = smio_set_thsafe_client_ops (self, &smio_thsafe_client_zmq_ops);
+    err = smio_set_thsafe_client_ops (self,
+            devio_get_thsafe_client_ops (smio_get_parent (self)));
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO thsafe operations",
             err_smio_set_thsafe_ops);
 
@@ -231,6 +237,23 @@ smio_err_e trigger_iface_init (smio_t * self)
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO handler",
             err_smio_set_handler);
 
+    /* Keep a shadow of the channel registers, so field updates don't have
+     * to read the register back from hardware first. Pulse counters are
+     * driven by hardware and always read from it. So are the control
+     * registers, as their counter reset bits are cleared by hardware */
+    smio_shadow_range_t volatile_regs [2*TRIGGER_IFACE_NUM_CHAN];
+    uint32_t chan;
+    for (chan = 0; chan < TRIGGER_IFACE_NUM_CHAN; ++chan) {
+        volatile_regs [2*chan].offs = WB_TRIG_IFACE_REG_CH0_CTL +
+            chan * TRIGGER_IFACE_CHAN_OFFSET;
+        volatile_regs [2*chan].num_regs = 1;
+        volatile_regs [2*chan+1].offs = WB_TRIG_IFACE_REG_CH0_COUNT +
+            chan * TRIGGER_IFACE_CHAN_OFFSET;
+        volatile_regs [2*chan+1].num_regs = 1;
+    }
+    smio_shadow_setup (self, WB_TRIG_IFACE_REG_CH0_CTL, TRIGGER_IFACE_SHADOW_NUM_REGS,
+            volatile_regs, ARRAY_SIZE(volatile_regs));
+
     return err;
 
 err_smio_set_handler:
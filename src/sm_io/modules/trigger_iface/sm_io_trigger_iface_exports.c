@@ -114,6 +114,18 @@ disp_op_t trigger_iface_count_transm_exp = {
     }
 };
 
+disp_op_t trigger_iface_shadow_resync_exp = {
+    .name = TRIGGER_IFACE_NAME_SHADOW_RESYNC,
+    .opcode = TRIGGER_IFACE_OPCODE_SHADOW_RESYNC,
+    .retval = DISP_ARG_END,
+    .retval_owner = DISP_OWNER_OTHER,
+    .args = {
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_ENCODE(DISP_ATYPE_UINT32, uint32_t),
+        DISP_ARG_END
+    }
+};
+
 /* Exported function description */
 const disp_op_t *trigger_iface_exp_ops [] = {
     &trigger_iface_dir_exp,
@@ -124,6 +136,7 @@ const disp_op_t *trigger_iface_exp_ops [] = {
     &trigger_iface_transm_len_exp,
     &trigger_iface_count_rcv_exp,
     &trigger_iface_count_transm_exp,
+    &trigger_iface_shadow_resync_exp,
     NULL
 };
 
@@ -18,6 +18,7 @@ extern disp_op_t trigger_iface_rcv_len_exp;
 extern disp_op_t trigger_iface_transm_len_exp;
 extern disp_op_t trigger_iface_count_rcv_exp;
 extern disp_op_t trigger_iface_count_transm_exp;
+extern disp_op_t trigger_iface_shadow_resync_exp;
 
 extern const disp_op_t *trigger_iface_exp_ops [];
 
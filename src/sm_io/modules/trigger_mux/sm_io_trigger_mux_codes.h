@@ -20,7 +20,9 @@
 #define TRIGGER_MUX_NAME_TRANSM_SRC                       "trigger_mux_transm_src"
 #define TRIGGER_MUX_OPCODE_TRANSM_OUT_SEL                 3
 #define TRIGGER_MUX_NAME_TRANSM_OUT_SEL                   "trigger_mux_transm_out_sel"
-#define TRIGGER_MUX_OPCODE_END                            4
+#define TRIGGER_MUX_OPCODE_SHADOW_RESYNC                  4
+#define TRIGGER_MUX_NAME_SHADOW_RESYNC                    "trigger_mux_shadow_resync"
+#define TRIGGER_MUX_OPCODE_END                            5
 
 /* Messaging Reply OPCODES */
 #define TRIGGER_MUX_REPLY_TYPE                            uint32_t
@@ -87,6 +87,7 @@ const disp_table_func_fp trigger_mux_exp_fp [] = {
     RW_PARAM_FUNC_NAME(trigger_mux, rcv_in_sel),
     RW_PARAM_FUNC_NAME(trigger_mux, transm_src),
     RW_PARAM_FUNC_NAME(trigger_mux, transm_out_sel),
+    smio_shadow_resync_exp,
     NULL
 };
 
@@ -154,6 +155,10 @@ const smio_ops_t trigger_mux_ops = {
 /****************** Bootstrap Operations ********************/
 /************************************************************/
 
+/* Registers of all channels */
+#define TRIGGER_MUX_SHADOW_NUM_REGS         (TRIGGER_MUX_NUM_CHAN * TRIGGER_MUX_CHAN_OFFSET / \
+                                                sizeof (uint32_t))
+
 smio_err_e trigger_mux_init (smio_t * self)
 {
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io:trigger_mux_exp] Initializing trigger_mux\n");
@@ -169,7 +174,8 @@ smio_err_e trigger_mux_init (smio_t * self)
     err = smio_set_ops (self, &trigger_mux_ops);
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO operations",
             err_smio_set_ops);
-    err = smio_set_thsafe_client_ops (self, &smio_thsafe_client_zmq_ops);
+    err = smio_set_thsafe_client_ops (self,
+            devio_get_thsafe_client_ops (smio_get_parent (self)));
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO thsafe operations",
             err_smio_set_thsafe_ops);
 
@@ -195,6 +201,12 @@ smio_err_e trigger_mux_init (smio_t * self)
     ASSERT_TEST(err == SMIO_SUCCESS, "Could not set SMIO handler",
             err_smio_set_handler);
 
+    /* All of the registers are configuration ones, only changed by us. Keep
+     * a shadow of them, so field updates don't have to read the register
+     * back from hardware first */
+    smio_shadow_setup (self, WB_TRIG_MUX_REG_CH0_CTL, TRIGGER_MUX_SHADOW_NUM_REGS,
+            NULL, 0);
+
     return err;
 
 err_smio_set_handler:
@@ -504,8 +504,9 @@ static const smpr_proto_ops_t smpr_proto_ops_bsmp = {
                                                     parameter size in bytes */
     .proto_read_dma       = NULL,               /* Read arbitrary block size data via DMA,
                                                     parameter size in bytes */
-    .proto_write_dma      = NULL                /* Write arbitrary block size data via DMA,
+    .proto_write_dma      = NULL,               /* Write arbitrary block size data via DMA,
                                                     parameter size in bytes */
+    .proto_burst          = NULL                /* Run a list of register transfers */
 };
 
 /************ Our methods implementation **********/
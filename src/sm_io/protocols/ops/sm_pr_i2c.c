@@ -37,14 +37,15 @@
     CHECK_HAL_ERR(err, SM_PR, "[sm_pr:i2c]",                    \
             smpr_err_str (err_type))
 
-#define SM_PR_I2C_MAX_TRIES                 10
-#define SM_PR_I2C_USLEEP                    1000
+/* Each byte on the bus takes 8 data bits plus the ACK bit */
+#define SM_PR_I2C_BITS_PER_BYTE             9
 
 /* Device endpoint */
 typedef struct {
     uint64_t base;              /* Core base address */
     uint32_t sys_freq;          /* System clock [Hz] */
     uint32_t i2c_freq;          /* I2C clock [Hz] */
+    uint32_t scl_freq;          /* I2C clock obtained from the prescaler [Hz] */
     uint32_t init_config;       /* I2C initial config register */
     i2c_mode_e mode;            /* I2C mode */
 } smpr_proto_i2c_t;
@@ -59,6 +60,7 @@ struct _smpr_i2c_t {
 
 static smpr_err_e _i2c_init (smpr_t *self);
 static ssize_t _i2c_check_transfer (smpr_t *self, bool ack_check);
+static int _i2c_poll_done (smpr_t *self, bool *done);
 static smpr_err_e _i2c_set_mode (smpr_t *self);
 static ssize_t _i2c_read_write_header (smpr_t *self, bool rw);
 static ssize_t _i2c_write_generic (smpr_t *self, size_t size_offs, uint64_t offs,
@@ -253,6 +255,9 @@ static smpr_err_e _i2c_init (smpr_t *self)
     float f_freq = (float) i2c_proto->sys_freq/(5.0 * (float) i2c_proto->i2c_freq) - 1.0;
     uint32_t freq_lo = ((uint16_t) f_freq) & 0xFF;
     uint32_t freq_hi = (((uint16_t) f_freq) & 0xFF00) >> 8;
+    /* The prescaler is truncated, so the actual clock may be faster than
+     * the requested one */
+    i2c_proto->scl_freq = i2c_proto->sys_freq/(5*(((uint16_t) f_freq)+1));
 
     /* Configure I2C clock register */
     DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE,
@@ -337,24 +342,12 @@ static ssize_t _i2c_check_transfer (smpr_t *self, bool ack_check)
     ASSERT_TEST(i2c_proto != NULL, "Could not get SMPR protocol handler",
             err_proto_handler, -1);
 
-    /* Check for completion */
-    uint32_t tip = 0;
-    uint32_t tries = 0;
+    /* Check for completion. Every command moves a single byte */
     RW_REPLY_TYPE rw_err = RW_OK;
-
-    while (1) {
-        rw_err = GET_PARAM(parent, sm_pr_i2c, i2c_proto->base, I2C_PROTO,
-                SR, TIP, SINGLE_BIT_PARAM, tip, NO_FMT_FUNC);
-        ASSERT_TEST(rw_err == RW_OK, "Could not get TIP parameter", err_exit, -1);
-
-        if (!tip) {
-            break;
-        }
-
-        usleep (SM_PR_I2C_USLEEP);
-        ++tries;
-        ASSERT_TEST(tries < SM_PR_I2C_MAX_TRIES, "Transfer timeout", err_exit, -1);
-    }
+    smpr_err_e wait_err = smpr_wait_completion (self, _i2c_poll_done,
+            smpr_xfer_time_us (SM_PR_I2C_BITS_PER_BYTE, i2c_proto->scl_freq),
+            SMPR_WAIT_DFLT_TIMEOUT_US);
+    ASSERT_TEST(wait_err == SMPR_SUCCESS, "Transfer timeout", err_exit, -1);
 
     DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE,
             "[sm_pr:i2c] _i2c_check_transfer: Wait completed successfully\n");
@@ -376,6 +369,27 @@ err_proto_handler:
     return err;
 }
 
+/* Check if the I2C core has finished the current command */
+static int _i2c_poll_done (smpr_t *self, bool *done)
+{
+    assert (self);
+    assert (done);
+
+    int err = 0;
+    smio_t *parent = smpr_get_parent (self);
+    smpr_proto_i2c_t *i2c_proto = smpr_get_handler (self);
+    uint32_t tip = 0;
+
+    RW_REPLY_TYPE rw_err = GET_PARAM(parent, sm_pr_i2c, i2c_proto->base, I2C_PROTO,
+            SR, TIP, SINGLE_BIT_PARAM, tip, NO_FMT_FUNC);
+    ASSERT_TEST(rw_err == RW_OK, "Could not get TIP parameter", err_exit, -1);
+
+    *done = !tip;
+
+err_exit:
+    return err;
+}
+
 static smpr_err_e _i2c_set_mode (smpr_t *self)
 {
     assert (self);
@@ -674,8 +688,9 @@ static const smpr_proto_ops_t smpr_proto_ops_i2c = {
                                                     parameter size in bytes */
     .proto_read_dma       = NULL,               /* Read arbitrary block size data via DMA,
                                                     parameter size in bytes */
-    .proto_write_dma      = NULL                /* Write arbitrary block size data via DMA,
+    .proto_write_dma      = NULL,               /* Write arbitrary block size data via DMA,
                                                     parameter size in bytes */
+    .proto_burst          = NULL                /* Run a list of register transfers */
 };
 
 /************ Our methods implementation **********/
@@ -39,14 +39,12 @@
     CHECK_HAL_ERR(err, SM_PR, "[sm_pr:spi]",                    \
             smpr_err_str (err_type))
 
-#define SM_PR_SPI_MAX_TRIES                 10
-#define SM_PR_SPI_USLEEP                    1000
-
 /* Device endpoint */
 typedef struct {
     uint64_t base;              /* Core base address */
     uint32_t sys_freq;          /* System clock [Hz] */
     uint32_t spi_freq;          /* SPI clock [Hz] */
+    uint32_t sclk_freq;         /* SPI clock obtained from the divider [Hz] */
     uint32_t init_config;       /* SPI initial config register */
     bool bidir;                 /* SPI bidirectional control enable */
 } smpr_proto_spi_t;
@@ -60,6 +58,10 @@ struct _smpr_spi_t {
 };
 
 static smpr_err_e _spi_init (smpr_t *self);
+static int _spi_poll_done (smpr_t *self, bool *done);
+static int _spi_config_xfer (smpr_t *self, size_t size);
+static size_t _spi_pack_xfer (smpr_t *self, size_t size_offs, uint64_t offs,
+        size_t size, const uint8_t *data, uint8_t *raw_data);
 static ssize_t _spi_read_write_generic (smpr_t *self, size_t size_offs, uint64_t offs,
         size_t size, uint8_t *data, spi_mode_e mode);
 static ssize_t _spi_read_write_raw (smpr_t *self, size_t size, uint8_t *data,
@@ -244,6 +246,96 @@ static ssize_t spi_write_block (smpr_t *self, size_t size_offs, uint64_t offs,
                 SPI_MODE_WRITE);
 }
 
+/* Run a list of register transfers back-to-back. SS and the character length
+ * are programmed once for the whole burst and RX is only read back for read
+ * transfers */
+static ssize_t spi_burst (smpr_t *self, size_t size_offs, size_t size,
+        smpr_xfer_t *xfers, size_t num_xfers)
+{
+    assert (self);
+    assert (xfers);
+
+    ssize_t err = 0;
+    ssize_t num_bytes = 0;
+    size_t trans_size = size_offs + size;
+    ASSERT_TEST(size > 0 && size <= sizeof (xfers->data) &&
+            trans_size*SMPR_BYTE_2_BIT /* bits */ < SPI_PROTO_CTRL_CHARLEN_MASK+1+1,
+            "Invalid size for spi burst", err_inv_size, -1);
+
+    smio_t *parent = smpr_get_parent (self);
+    smpr_proto_spi_t *spi_proto = smpr_get_handler (self);
+    ASSERT_TEST(spi_proto != NULL, "Could not get SMPR protocol handler",
+            err_proto_handler, -1);
+
+    err = _spi_config_xfer (self, trans_size);
+    ASSERT_TEST(err == 0, "Could not configure SPI transfer", err_exit, -1);
+
+    /* CTRL stays the same for the whole burst, so every transfer is started
+     * with a plain write instead of a read-modify-write */
+    uint32_t ctrl = 0;
+    num_bytes = smio_thsafe_client_read_32 (parent,
+            spi_proto->base | SPI_PROTO_REG_CTRL, &ctrl);
+    ASSERT_TEST(num_bytes != -1, "Could not get CTRL register", err_exit, -1);
+
+    uint32_t num_regs = hutils_align_value (trans_size, SMPR_WB_REG_2_BYTE)/
+        SMPR_WB_REG_2_BYTE;
+    uint32_t xfer_time_us = smpr_xfer_time_us (trans_size*SMPR_BYTE_2_BIT,
+            spi_proto->sclk_freq);
+    uint32_t read_base_addr = (spi_proto->bidir) ? SPI_PROTO_REG_RX0 : SPI_PROTO_REG_RX0_SINGLE;
+    smio_thsafe_txn_t txn;
+    size_t i;
+    uint32_t j;
+
+    for (i = 0; i < num_xfers; ++i) {
+        uint32_t raw_data [SPI_PROTO_REG_RXTX_NUM] = {0};
+        _spi_pack_xfer (self, size_offs, xfers[i].offs, size,
+                (uint8_t *) &xfers[i].data, (uint8_t *) raw_data);
+
+        /* TX registers and GO_BSY go out in a single request */
+        smio_thsafe_txn_init (&txn);
+        for (j = 0; j < num_regs; ++j) {
+            smio_thsafe_txn_write_32 (parent, &txn,
+                    (spi_proto->base | SPI_PROTO_REG_TX0) + j*SMPR_WB_REG_2_BYTE,
+                    raw_data [j]);
+        }
+        smio_thsafe_txn_write_32 (parent, &txn, spi_proto->base | SPI_PROTO_REG_CTRL,
+                ctrl | SPI_PROTO_CTRL_GO_BSY);
+        num_bytes = smio_thsafe_client_txn (parent, &txn);
+        ASSERT_TEST(num_bytes >= 0, "Could not start SPI transfer", err_exit, -1);
+
+        smpr_err_e wait_err = smpr_wait_completion (self, _spi_poll_done,
+                xfer_time_us, SMPR_WAIT_DFLT_TIMEOUT_US);
+        ASSERT_TEST(wait_err == SMPR_SUCCESS, "Transfer timeout", err_exit, -1);
+
+        if (!xfers[i].read) {
+            continue;
+        }
+
+        smio_thsafe_txn_init (&txn);
+        for (j = 0; j < num_regs; ++j) {
+            smio_thsafe_txn_read_32 (parent, &txn,
+                    (spi_proto->base | read_base_addr) + j*SMPR_WB_REG_2_BYTE,
+                    &raw_data [j]);
+        }
+        num_bytes = smio_thsafe_client_txn (parent, &txn);
+        ASSERT_TEST(num_bytes >= 0, "Could not read RX registers", err_exit, -1);
+
+        /* Received data is at the start of RX, same as in
+         * _spi_read_write_generic () */
+        xfers[i].data = 0;
+        memcpy (&xfers[i].data, raw_data, size);
+    }
+
+    DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE,
+            "[sm_pr:spi] spi_burst: %zu transfers completed\n", num_xfers);
+    err = num_xfers;
+
+err_exit:
+err_proto_handler:
+err_inv_size:
+    return err;
+}
+
 /************ Static functions **********/
 static smpr_err_e _spi_init (smpr_t *self)
 {
@@ -260,6 +352,9 @@ static smpr_err_e _spi_init (smpr_t *self)
     /* Set SPI clock */
     float f_freq = (float) spi_proto->sys_freq/(2.0 * (float) spi_proto->spi_freq) - 1.0;
     uint32_t freq = SPI_PROTO_DIVIDER_W((uint16_t) f_freq);
+    /* The divider is truncated, so the actual clock may be faster than
+     * the requested one */
+    spi_proto->sclk_freq = spi_proto->sys_freq/(2*(SPI_PROTO_DIVIDER_R(freq)+1));
 
     /* Configure SPI divider register */
     DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE,
@@ -306,44 +401,48 @@ err_proto_handler:
     return err;
 }
 
-/* Generic read/write to/from SPI */
-static ssize_t _spi_read_write_raw (smpr_t *self, size_t size, uint8_t *data,
-        spi_mode_e mode)
+/* Check if the SPI core has finished the current transfer */
+static int _spi_poll_done (smpr_t *self, bool *done)
 {
     assert (self);
+    assert (done);
 
-    ssize_t err = 0;
-    ssize_t num_bytes = 0;
-    RW_REPLY_TYPE rw_err = RW_OK;
-    ASSERT_TEST(size > 0 && size*SMPR_BYTE_2_BIT /* bits */ <
-            SPI_PROTO_CTRL_CHARLEN_MASK+1+1, "Invalid size for spi transfer",
-            err_inv_size, -1);
-
+    int err = 0;
     smio_t *parent = smpr_get_parent (self);
     smpr_proto_spi_t *spi_proto = smpr_get_handler (self);
-    ASSERT_TEST(spi_proto != NULL, "Could not get SMPR protocol handler",
-            err_proto_handler, -1);
+    uint32_t busy = 0;
 
-    uint32_t config;
-    rw_err = GET_PARAM(parent, sm_pr_spi, spi_proto->base, SPI_PROTO,
-            CTRL, /* field = NULL */, MULT_BIT_PARAM, config, NO_FMT_FUNC);
-    ASSERT_TEST(rw_err == RW_OK, "Could not get CONFIG parameter", err_exit, -1);
-    DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE,
-            "[sm_pr:spi] _spi_rw_generic: Config register = 0x%08X\n", config);
+    RW_REPLY_TYPE rw_err = GET_PARAM(parent, sm_pr_spi, spi_proto->base, SPI_PROTO,
+            CTRL, BSY, SINGLE_BIT_PARAM, busy, NO_FMT_FUNC);
+    ASSERT_TEST(rw_err == RW_OK, "Could not get BUSY parameter", err_exit, -1);
+
+    *done = !busy;
+
+err_exit:
+    return err;
+}
+
+/* Configure SS line and character length for a size bytes transfer */
+static int _spi_config_xfer (smpr_t *self, size_t size)
+{
+    assert (self);
+
+    int err = 0;
+    smio_t *parent = smpr_get_parent (self);
+    smpr_proto_spi_t *spi_proto = smpr_get_handler (self);
 
     /* Get specific parameters */
     smpr_spi_t *smpr_spi = (smpr_spi_t *) smpr_get_ops (self);
     uint32_t ss = smpr_spi_get_ss (smpr_spi);
     uint32_t charlen = size*SMPR_BYTE_2_BIT; /* in bits */
-    uint32_t size_align = hutils_align_value(size, SMPR_WB_REG_2_BYTE);
 
     /* Configure SS line */
-    rw_err = SET_PARAM(parent, sm_pr_spi, spi_proto->base, SPI_PROTO, SS, /* field = NULL */,
+    RW_REPLY_TYPE rw_err = SET_PARAM(parent, sm_pr_spi, spi_proto->base, SPI_PROTO, SS, /* field = NULL */,
             MULT_BIT_PARAM, /* value */ ss, /* min */, /* max */,
             NO_CHK_FUNC, SET_FIELD);
     ASSERT_TEST(rw_err == RW_OK, "Could not set SS parameter", err_exit, -1);
     DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE,
-            "[sm_pr:spi] _spi_rw_generic: SS register = 0x%08X\n", ss);
+            "[sm_pr:spi] _spi_config_xfer: SS register = 0x%08X\n", ss);
 
     /* Configure character length. For the opencores SPI,
      * 0 is 128-bit data word, 1 is 1 bit, 2 is 2-bit and so on */
@@ -369,9 +468,44 @@ static ssize_t _spi_read_write_raw (smpr_t *self, size_t size, uint8_t *data,
     }
     ASSERT_TEST(rw_err == RW_OK, "Could not set CHARLEN/BIDIR parameter", err_exit, -1);
     DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE,
-            "[sm_pr:spi] _spi_rw_generic: Charecter Length = 0x%08X, Bidir = 0x%08X\n",
+            "[sm_pr:spi] _spi_config_xfer: Charecter Length = 0x%08X, Bidir = 0x%08X\n",
             charlen, spi_proto->bidir);
 
+err_exit:
+    return err;
+}
+
+/* Generic read/write to/from SPI */
+static ssize_t _spi_read_write_raw (smpr_t *self, size_t size, uint8_t *data,
+        spi_mode_e mode)
+{
+    assert (self);
+
+    ssize_t err = 0;
+    ssize_t num_bytes = 0;
+    RW_REPLY_TYPE rw_err = RW_OK;
+    ASSERT_TEST(size > 0 && size*SMPR_BYTE_2_BIT /* bits */ <
+            SPI_PROTO_CTRL_CHARLEN_MASK+1+1, "Invalid size for spi transfer",
+            err_inv_size, -1);
+
+    smio_t *parent = smpr_get_parent (self);
+    smpr_proto_spi_t *spi_proto = smpr_get_handler (self);
+    ASSERT_TEST(spi_proto != NULL, "Could not get SMPR protocol handler",
+            err_proto_handler, -1);
+
+    uint32_t config;
+    rw_err = GET_PARAM(parent, sm_pr_spi, spi_proto->base, SPI_PROTO,
+            CTRL, /* field = NULL */, MULT_BIT_PARAM, config, NO_FMT_FUNC);
+    ASSERT_TEST(rw_err == RW_OK, "Could not get CONFIG parameter", err_exit, -1);
+    DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE,
+            "[sm_pr:spi] _spi_rw_generic: Config register = 0x%08X\n", config);
+
+    uint32_t size_align = hutils_align_value(size, SMPR_WB_REG_2_BYTE);
+
+    /* Configure SS line and character length */
+    err = _spi_config_xfer (self, size);
+    ASSERT_TEST(err == 0, "Could not configure SPI transfer", err_exit, -1);
+
     /* Write data to TX regs */
     if (mode == SPI_MODE_WRITE || mode == SPI_MODE_WRITE_READ) {
         /* Copy data to temp */
@@ -407,22 +541,12 @@ static ssize_t _spi_read_write_raw (smpr_t *self, size_t size, uint8_t *data,
     DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE,
             "[sm_pr:spi] _spi_rw_generic: Transfer started\n");
 
-    /* Check for completion */
-    uint32_t busy = 0;
-    uint32_t tries = 0;
-    while (1) {
-        rw_err = GET_PARAM(parent, sm_pr_spi, spi_proto->base, SPI_PROTO,
-                CTRL, BSY, SINGLE_BIT_PARAM, busy, NO_FMT_FUNC);
-        ASSERT_TEST(rw_err == RW_OK, "Could not get BUSY parameter", err_exit, -1);
-
-        if (!busy) {
-            break;
-        }
-
-        usleep (SM_PR_SPI_USLEEP);
-        ++tries;
-        ASSERT_TEST(tries < SM_PR_SPI_MAX_TRIES, "Transfer timeout", err_exit, -1);
-    }
+    /* Check for completion. The core shifts size*8 bits out at the SCLK rate,
+     * so there is no point in polling before that */
+    smpr_err_e wait_err = smpr_wait_completion (self, _spi_poll_done,
+            smpr_xfer_time_us (size*SMPR_BYTE_2_BIT, spi_proto->sclk_freq),
+            SMPR_WAIT_DFLT_TIMEOUT_US);
+    ASSERT_TEST(wait_err == SMPR_SUCCESS, "Transfer timeout", err_exit, -1);
 
     DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE,
             "[sm_pr:spi] _spi_rw_generic: Wait completed successfully\n");
@@ -465,12 +589,12 @@ err_proto_handler:
     return err;
 }
 
-static ssize_t _spi_read_write_generic (smpr_t *self, size_t size_offs, uint64_t offs,
-        size_t size, uint8_t *data, spi_mode_e mode)
+/* Lay address and data out in the order the chip expects them. Returns
+ * the number of bytes to be shifted out */
+static size_t _spi_pack_xfer (smpr_t *self, size_t size_offs, uint64_t offs,
+        size_t size, const uint8_t *data, uint8_t *raw_data)
 {
     assert (self);
-    size_t raw_size = size_offs + size;
-    uint8_t raw_data [raw_size];
 
     smpr_spi_t *smpr_spi = (smpr_spi_t *) smpr_get_ops (self);
     uint32_t addr_msb = smpr_spi_get_addr_msb (smpr_spi);
@@ -499,6 +623,19 @@ static ssize_t _spi_read_write_generic (smpr_t *self, size_t size_offs, uint64_t
         }
     }
 
+    return trans_size;
+}
+
+static ssize_t _spi_read_write_generic (smpr_t *self, size_t size_offs, uint64_t offs,
+        size_t size, uint8_t *data, spi_mode_e mode)
+{
+    assert (self);
+    size_t raw_size = size_offs + size;
+    uint8_t raw_data [raw_size];
+
+    size_t trans_size = _spi_pack_xfer (self, size_offs, offs, size, data,
+            raw_data);
+
     ssize_t err = _spi_read_write_raw (self, trans_size, raw_data, mode);
     ASSERT_TEST(err > 0 && (size_t) err == trans_size /* in bytes*/,
             "Could not write data to SPI", err_exit, -1);
@@ -530,8 +667,9 @@ static const smpr_proto_ops_t smpr_proto_ops_spi = {
                                                     parameter size in bytes */
     .proto_read_dma       = NULL,               /* Read arbitrary block size data via DMA,
                                                     parameter size in bytes */
-    .proto_write_dma      = NULL                /* Write arbitrary block size data via DMA,
+    .proto_write_dma      = NULL,               /* Write arbitrary block size data via DMA,
                                                     parameter size in bytes */
+    .proto_burst          = spi_burst           /* Run a list of register transfers */
 };
 
 /************ Our methods implementation **********/
@@ -42,6 +42,10 @@ struct _smpr_t {
     smio_t *parent;
     /* Protocol operations */
     const smpr_proto_ops_t *ops;
+
+    /* Completion wait statistics */
+    uint32_t wait_tries;                /* Polls taken by the last wait */
+    uint32_t wait_max_tries;            /* Largest number of polls of any wait */
 };
 
 static smpr_err_e _smpr_register_proto_ops (const smpr_proto_ops_t **ops,
@@ -63,6 +67,8 @@ smpr_t * smpr_new (char *name, smio_t *parent, const smpr_proto_ops_t *reg_ops,
     self->name = strdup (name);
     ASSERT_ALLOC(self->name, err_name_alloc);
     self->verbose = verbose;
+    self->wait_tries = 0;
+    self->wait_max_tries = 0;
 
     /* Initilialize SMIO parent */
     self->parent = parent;
@@ -163,6 +169,83 @@ const char *smpr_get_ops_name (smpr_t *self)
     return self->ops->proto_name;
 }
 
+uint32_t smpr_xfer_time_us (uint32_t num_bits, uint32_t clk_freq)
+{
+    if (clk_freq == 0) {
+        return 0;
+    }
+
+    return (uint32_t) (((uint64_t) num_bits * SMPR_SEC_2_USEC + clk_freq - 1) /
+            clk_freq);
+}
+
+smpr_err_e smpr_wait_completion (smpr_t *self, smpr_poll_fp poll_fp,
+        uint32_t expected_us, uint32_t timeout_us)
+{
+    assert (self);
+    assert (poll_fp);
+
+    smpr_err_e err = SMPR_SUCCESS;
+    int64_t deadline = zclock_usecs () + expected_us + timeout_us;
+    uint32_t backoff_us = 1;
+    uint32_t tries = 0;
+    bool done = false;
+
+    /* A sleep is only worth it when it is longer than the scheduler latency.
+     * Shorter transfers are over by the time the first poll goes through */
+    if (expected_us >= SMPR_WAIT_SPIN_US) {
+        usleep (expected_us);
+    }
+
+    while (1) {
+        int poll_err = poll_fp (self, &done);
+        ++tries;
+        ASSERT_TEST(poll_err == 0, "Could not poll for transfer completion",
+                err_poll, SMPR_ERR_RW_SMIO);
+
+        if (done) {
+            break;
+        }
+
+        ASSERT_TEST(zclock_usecs () < deadline, "Transfer timeout",
+                err_timeout, SMPR_ERR_TIMEOUT);
+
+        /* Each poll is a bus round-trip already, so only yield the CPU once
+         * the backoff grows past the scheduler latency */
+        if (backoff_us >= SMPR_WAIT_SPIN_US) {
+            usleep (backoff_us);
+        }
+
+        backoff_us *= 2;
+        if (backoff_us > SMPR_WAIT_MAX_BACKOFF_US) {
+            backoff_us = SMPR_WAIT_MAX_BACKOFF_US;
+        }
+    }
+
+    DBE_DEBUG (DBG_SM_PR | DBG_LVL_TRACE, "[sm_pr] Transfer completed after "
+            "%u tries, expected time = %u us\n", tries, expected_us);
+
+err_timeout:
+err_poll:
+    self->wait_tries = tries;
+    if (tries > self->wait_max_tries) {
+        self->wait_max_tries = tries;
+    }
+    return err;
+}
+
+uint32_t smpr_get_wait_tries (smpr_t *self)
+{
+    assert (self);
+    return self->wait_tries;
+}
+
+uint32_t smpr_get_wait_max_tries (smpr_t *self)
+{
+    assert (self);
+    return self->wait_max_tries;
+}
+
 /**************** Helper Functions ***************/
 
 /* Register Specific Protocol operations to smpr instance. Helper function */
@@ -242,3 +325,7 @@ ssize_t smpr_read_dma (smpr_t *self, size_t size_offs, uint64_t offs, size_t siz
 /**** Write data block via DMA from protocol function pointer, size in bytes ****/
 ssize_t smpr_write_dma (smpr_t *self, size_t size_offs, uint64_t offs, size_t size, uint32_t *data)
     SMPR_FUNC_WRAPPER (proto_write_dma, size_offs, offs, size, data)
+
+/**** Run a list of register transfers ****/
+ssize_t smpr_burst (smpr_t *self, size_t size_offs, size_t size, smpr_xfer_t *xfers, size_t num_xfers)
+    SMPR_FUNC_WRAPPER (proto_burst, size_offs, size, xfers, num_xfers)
@@ -18,7 +18,8 @@ static const char *smpr_err [SMPR_ERR_END] =
     [SMPR_ERR_RW_SMIO]          = "Could not Read/Write to/from SMIO",
     [SMPR_ERR_FUNC_NOT_IMPL]    = "Function not implemented",
     [SMPR_ERR_DUP_HANDLER]      = "Protocol handler already set",
-    [SMPR_ERR_PROTO_INFO]       = "Could not retrieve protocol information"
+    [SMPR_ERR_PROTO_INFO]       = "Could not retrieve protocol information",
+    [SMPR_ERR_TIMEOUT]          = "Transfer did not complete in time"
 };
 
 /* Convert enumeration type to string */
@@ -54,6 +54,8 @@ struct _smio_t {
     zsock_t *pipe_frontend;             /* Force zloop to interrupt and rebuild poll set. This is used to send messages */
     zsock_t *pipe_backend;              /* Force zloop to interrupt and rebuild poll set. This is used to receive messages */
     int timer_id;                       /* Timer ID */
+    int user_timer_id;                  /* Specific SMIO timer ID */
+    smio_timer_fp timer_handler;        /* Specific SMIO periodic handler */
 
     /* Specific SMIO operations dispatch table for exported operations */
     disp_table_t *exp_ops_dtable;
@@ -67,8 +69,20 @@ struct _smio_t {
      * ones available in llio, changing the llio_t self pointer to a void
      * pointer (socket to parent thread) */
     const smio_thsafe_client_ops_t *thsafe_client_ops;
+
+    /* Optional shadow of a contiguous range of 32-bit registers. Only
+     * accessed from the SMIO thread, so no locking is needed */
+    uint64_t shadow_offs;               /* Address of the first shadowed register,
+                                           base address included */
+    uint32_t shadow_num_regs;           /* Number of shadowed registers */
+    uint32_t *shadow_regs;              /* Last known register values */
+    uint8_t *shadow_flags;              /* SMIO_SHADOW_* flags for each register */
 };
 
+#define SMIO_SHADOW_VALID                  (1 << 0)   /* Shadow value matches hardware */
+#define SMIO_SHADOW_VOLATILE               (1 << 1)   /* Hardware may change it, always
+                                                         read from hardware */
+
 /* SMIO dispatch table operations */
 const disp_table_ops_t smio_disp_table_ops;
 
@@ -83,7 +97,10 @@ static char *_smio_clone_name (smio_t *self);
 static smio_err_e _smio_engine_handle_socket (smio_t *smio, void *sock,
         zloop_reader_fn handler);
 static int _smio_handle_timer (zloop_t *loop, int timer_id, void *arg);
+static int _smio_handle_user_timer (zloop_t *loop, int timer_id, void *arg);
 static int _smio_handle_pipe_backend (zloop_t *loop, zsock_t *reader, void *args);
+static void _smio_shadow_update (smio_t *self, uint64_t offs, size_t size,
+        const uint32_t *data);
 
 /* Boot new SMIO instance. Better used as a thread (CZMQ actor) init function */
 smio_t *smio_new (th_boot_args_t *args, zsock_t *pipe_mgmt,
@@ -123,6 +140,10 @@ smio_t *smio_new (th_boot_args_t *args, zsock_t *pipe_mgmt,
         _smio_handle_timer, NULL);
     ASSERT_TEST(self->timer_id != -1, "Could not create zloop timer", err_timer_alloc);
 
+    /* Specific SMIO timer is only set if requested */
+    self->user_timer_id = -1;
+    self->timer_handler = NULL;
+
     /* Set-up backend handler for forcing interrupting the zloop and rebuild
      * the poll set. This avoids having to setup a short timer to periodically
      * interrupting the loop to check for rebuilds */
@@ -131,6 +152,12 @@ smio_t *smio_new (th_boot_args_t *args, zsock_t *pipe_mgmt,
     /* Initialize SMIO base address */
     self->base = args->base;
 
+    /* Register shadow is only set if requested */
+    self->shadow_offs = 0;
+    self->shadow_num_regs = 0;
+    self->shadow_regs = NULL;
+    self->shadow_flags = NULL;
+
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io_bootstrap] Creating worker\n");
     DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "\tbroker = %s, service = %s, verbose = %d\n",
             args->broker, service, args->verbose);
@@ -171,6 +198,9 @@ smio_err_e smio_destroy (smio_t **self_p)
         smio_t *self = *self_p;
 
         mlm_client_destroy (&self->worker);
+        if (self->user_timer_id != -1) {
+            zloop_timer_end (self->loop, self->user_timer_id);
+        }
         zloop_timer_end (self->loop, self->timer_id);
         zloop_destroy (&self->loop);
         zsock_destroy (&self->pipe_backend);
@@ -182,6 +212,7 @@ smio_err_e smio_destroy (smio_t **self_p)
          * zsock_destroy (&self->pipe_mgmt);
          */
         disp_table_destroy (&self->exp_ops_dtable);
+        smio_shadow_free (self);
         self->thsafe_client_ops = NULL;
         self->ops = NULL;
         self->parent = NULL;
@@ -250,6 +281,26 @@ static int _smio_handle_timer (zloop_t *loop, int timer_id, void *arg)
     return 0;
 }
 
+/* zloop handler for specific SMIO timer */
+static int _smio_handle_user_timer (zloop_t *loop, int timer_id, void *arg)
+{
+    (void) loop;
+    (void) timer_id;
+    /* We expect a smio instance e as reference */
+    smio_t *smio = (smio_t *) arg;
+
+    if (smio->timer_handler != NULL) {
+        smio_err_e err = smio->timer_handler (smio);
+        /* Errors are not fatal. We just try again on the next period */
+        if (err != SMIO_SUCCESS) {
+            DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE,
+                    "[sm_io] timer_handler: %s\n", smio_err_str (err));
+        }
+    }
+
+    return 0;
+}
+
 /* zloop handler for CFG PIPE */
 static int _smio_handle_pipe_mgmt (zloop_t *loop, zsock_t *reader, void *args)
 {
@@ -708,6 +759,46 @@ mlm_client_t *smio_get_worker (smio_t *self)
     return self->worker;
 }
 
+const char *smio_get_service (smio_t *self)
+{
+    return self->service;
+}
+
+devio_t *smio_get_parent (smio_t *self)
+{
+    return self->parent;
+}
+
+smio_err_e smio_set_timer_handler (smio_t *self, size_t interval,
+        smio_timer_fp timer_handler)
+{
+    assert (self);
+    smio_err_e err = SMIO_SUCCESS;
+
+    /* Remove previous timer, if any */
+    if (self->user_timer_id != -1) {
+        zloop_timer_end (self->loop, self->user_timer_id);
+        self->user_timer_id = -1;
+    }
+
+    self->timer_handler = timer_handler;
+    if (timer_handler == NULL) {
+        goto err_no_handler;
+    }
+
+    self->user_timer_id = zloop_timer (self->loop, interval, SMIO_POLLER_NTIMES,
+        _smio_handle_user_timer, self);
+    ASSERT_TEST(self->user_timer_id != -1, "Could not create zloop timer",
+            err_timer_alloc, SMIO_ERR_ALLOC);
+
+    return err;
+
+err_timer_alloc:
+    self->timer_handler = NULL;
+err_no_handler:
+    return err;
+}
+
 zsock_t *smio_get_pipe_msg (smio_t *self)
 {
     return self->pipe_msg;
@@ -783,28 +874,45 @@ ssize_t smio_thsafe_raw_client_read_64 (smio_t *self, uint64_t offs, uint64_t *d
 /**** Write data to device ****/
 ssize_t smio_thsafe_client_write_16 (smio_t *self, uint64_t offs, const uint16_t *data)
 {
-    ASSERT_FUNC(thsafe_client_write_16);
-    return self->thsafe_client_ops->thsafe_client_write_16 (self, self->base | offs, data);
+    return smio_thsafe_raw_client_write_16 (self, self->base | offs, data);
 }
 
 ssize_t smio_thsafe_client_write_32 (smio_t *self, uint64_t offs, const uint32_t *data)
 {
-    ASSERT_FUNC(thsafe_client_write_32);
-    return self->thsafe_client_ops->thsafe_client_write_32 (self, self->base | offs, data);
+    return smio_thsafe_raw_client_write_32 (self, self->base | offs, data);
 }
 
 ssize_t smio_thsafe_client_write_64 (smio_t *self, uint64_t offs, const uint64_t *data)
 {
-    ASSERT_FUNC(thsafe_client_write_64);
-    return self->thsafe_client_ops->thsafe_client_write_64 (self, self->base | offs, data);
+    return smio_thsafe_raw_client_write_64 (self, self->base | offs, data);
 }
 
+/* Writes go through the raw variants, so the register shadow is kept
+ * coherent whichever one is called */
 ssize_t smio_thsafe_raw_client_write_16 (smio_t *self, uint64_t offs, const uint16_t *data)
-    SMIO_FUNC_WRAPPER (thsafe_client_write_16, offs, data)
+{
+    ASSERT_FUNC(thsafe_client_write_16);
+    ssize_t ret = self->thsafe_client_ops->thsafe_client_write_16 (self, offs, data);
+    _smio_shadow_update (self, offs, sizeof (*data), NULL);
+    return ret;
+}
+
 ssize_t smio_thsafe_raw_client_write_32 (smio_t *self, uint64_t offs, const uint32_t *data)
-    SMIO_FUNC_WRAPPER (thsafe_client_write_32, offs, data)
+{
+    ASSERT_FUNC(thsafe_client_write_32);
+    ssize_t ret = self->thsafe_client_ops->thsafe_client_write_32 (self, offs, data);
+    _smio_shadow_update (self, offs, sizeof (*data),
+            (ret == sizeof (*data))? data : NULL);
+    return ret;
+}
+
 ssize_t smio_thsafe_raw_client_write_64 (smio_t *self, uint64_t offs, const uint64_t *data)
-    SMIO_FUNC_WRAPPER (thsafe_client_write_64, offs, data)
+{
+    ASSERT_FUNC(thsafe_client_write_64);
+    ssize_t ret = self->thsafe_client_ops->thsafe_client_write_64 (self, offs, data);
+    _smio_shadow_update (self, offs, sizeof (*data), NULL);
+    return ret;
+}
 
 /**** Read data block from device function pointer, size in bytes ****/
 ssize_t smio_thsafe_client_read_block (smio_t *self, uint64_t offs, size_t size,
@@ -822,13 +930,18 @@ ssize_t smio_thsafe_raw_client_read_block (smio_t *self, uint64_t offs, size_t s
 ssize_t smio_thsafe_client_write_block (smio_t *self, uint64_t offs, size_t size,
         const uint32_t *data)
 {
-    ASSERT_FUNC(thsafe_client_write_block);
-    return self->thsafe_client_ops->thsafe_client_write_block (self, self->base | offs,
-            size, data);
+    return smio_thsafe_raw_client_write_block (self, self->base | offs, size, data);
 }
 
 ssize_t smio_thsafe_raw_client_write_block (smio_t *self, uint64_t offs, size_t size, const uint32_t *data)
-    SMIO_FUNC_WRAPPER (thsafe_client_write_block, offs, size, data)
+{
+    ASSERT_FUNC(thsafe_client_write_block);
+    ssize_t ret = self->thsafe_client_ops->thsafe_client_write_block (self, offs,
+            size, data);
+    _smio_shadow_update (self, offs, size,
+            (ret >= 0 && (size_t) ret == size)? data : NULL);
+    return ret;
+}
 
 /**** Read data block via DMA from device, size in bytes ****/
 ssize_t smio_thsafe_client_read_dma (smio_t *self, uint64_t offs, size_t size,
@@ -842,19 +955,352 @@ ssize_t smio_thsafe_client_read_dma (smio_t *self, uint64_t offs, size_t size,
 ssize_t smio_thsafe_raw_client_read_dma (smio_t *self, uint64_t offs, size_t size, uint32_t *data)
     SMIO_FUNC_WRAPPER (thsafe_client_read_dma, offs, size, data)
 
+/**** Read data block from device into a frame, size in bytes ****/
+ssize_t smio_thsafe_client_read_block_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame)
+{
+    ASSERT_FUNC(thsafe_client_read_block_frame);
+    return self->thsafe_client_ops->thsafe_client_read_block_frame (self, self->base | offs,
+            size, data_frame);
+}
+
+ssize_t smio_thsafe_raw_client_read_block_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame)
+    SMIO_FUNC_WRAPPER (thsafe_client_read_block_frame, offs, size, data_frame)
+
+/**** Read data block via DMA from device into a frame, size in bytes ****/
+ssize_t smio_thsafe_client_read_dma_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame)
+{
+    ASSERT_FUNC(thsafe_client_read_dma_frame);
+    return self->thsafe_client_ops->thsafe_client_read_dma_frame (self, self->base | offs,
+            size, data_frame);
+}
+
+ssize_t smio_thsafe_raw_client_read_dma_frame (smio_t *self, uint64_t offs, size_t size,
+        zframe_t **data_frame)
+    SMIO_FUNC_WRAPPER (thsafe_client_read_dma_frame, offs, size, data_frame)
+
 /**** Write data block via DMA from device, size in bytes ****/
 ssize_t smio_thsafe_client_write_dma (smio_t *self, uint64_t offs, size_t size,
         const uint32_t *data)
 {
-    ASSERT_FUNC(thsafe_client_write_dma);
-    return self->thsafe_client_ops->thsafe_client_write_dma (self, self->base | offs,
-            size, data);
+    return smio_thsafe_raw_client_write_dma (self, self->base | offs, size, data);
 }
 
 ssize_t smio_thsafe_raw_client_write_dma (smio_t *self, uint64_t offs, size_t size, const uint32_t *data)
-    SMIO_FUNC_WRAPPER (thsafe_client_write_dma, offs, size, data)
+{
+    ASSERT_FUNC(thsafe_client_write_dma);
+    ssize_t ret = self->thsafe_client_ops->thsafe_client_write_dma (self, offs,
+            size, data);
+    _smio_shadow_update (self, offs, size,
+            (ret >= 0 && (size_t) ret == size)? data : NULL);
+    return ret;
+}
 
 /**** Read device information function pointer ****/
 /* int smio_thsafe_raw_client_read_info (smio_t *self, llio_dev_info_t *dev_info)
     SMIO_FUNC_WRAPPER (thsafe_client_read_info, dev_info) Moved to dev_io */
 
+/**** Register transactions ****/
+void smio_thsafe_txn_init (smio_thsafe_txn_t *txn)
+{
+    assert (txn);
+    txn->num_ops = 0;
+    txn->overflow = false;
+}
+
+static smio_err_e _smio_thsafe_txn_add (smio_t *self, smio_thsafe_txn_t *txn,
+        uint32_t type, uint64_t offs, uint32_t mask, uint32_t data, uint32_t *dest)
+{
+    assert (self);
+    assert (txn);
+
+    if (txn->num_ops >= THSAFE_TXN_MAX_OPS) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io] Transaction is full. "
+                "Maximum number of operations is %u\n", THSAFE_TXN_MAX_OPS);
+        /* Callers usually check only the execution result, so make sure
+         * the dropped operation is not silently lost */
+        txn->overflow = true;
+        return SMIO_ERR_WRONG_PARAM;
+    }
+
+    smio_thsafe_txn_op_t *op = &txn->ops [txn->num_ops];
+    op->offs = self->base | offs;
+    op->type = type;
+    op->mask = mask;
+    op->data = data;
+    op->rsvd = 0;
+    txn->dest [txn->num_ops] = dest;
+    txn->num_ops++;
+
+    return SMIO_SUCCESS;
+}
+
+smio_err_e smio_thsafe_txn_read_32 (smio_t *self, smio_thsafe_txn_t *txn,
+        uint64_t offs, uint32_t *data)
+{
+    assert (data);
+    return _smio_thsafe_txn_add (self, txn, THSAFE_TXN_OP_READ_32, offs, 0, 0, data);
+}
+
+smio_err_e smio_thsafe_txn_write_32 (smio_t *self, smio_thsafe_txn_t *txn,
+        uint64_t offs, uint32_t data)
+{
+    return _smio_thsafe_txn_add (self, txn, THSAFE_TXN_OP_WRITE_32, offs, 0, data, NULL);
+}
+
+smio_err_e smio_thsafe_txn_rmw_32 (smio_t *self, smio_thsafe_txn_t *txn,
+        uint64_t offs, uint32_t mask, uint32_t data, uint32_t *old)
+{
+    return _smio_thsafe_txn_add (self, txn, THSAFE_TXN_OP_RMW_32, offs, mask, data, old);
+}
+
+ssize_t smio_thsafe_client_txn (smio_t *self, smio_thsafe_txn_t *txn)
+{
+    ASSERT_FUNC(thsafe_client_txn);
+    assert (txn);
+
+    if (txn->overflow) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_ERR, "[sm_io] Refusing to execute an "
+                "incomplete transaction\n");
+        return -1;
+    }
+
+    /* Executing the transaction overwrites the data field of RMW
+     * operations with the previous register value, so keep what was
+     * requested to update the register shadow afterwards */
+    uint32_t i;
+    uint32_t wdata [THSAFE_TXN_MAX_OPS];
+    if (self->shadow_regs != NULL) {
+        for (i = 0; i < txn->num_ops; ++i) {
+            wdata [i] = txn->ops [i].data;
+        }
+    }
+
+    ssize_t ret = self->thsafe_client_ops->thsafe_client_txn (self, txn->ops,
+            txn->num_ops);
+    if (ret < 0) {
+        /* We don't know how far the transaction went */
+        for (i = 0; i < txn->num_ops; ++i) {
+            if (txn->ops [i].type != THSAFE_TXN_OP_READ_32) {
+                _smio_shadow_update (self, txn->ops [i].offs, sizeof (uint32_t), NULL);
+            }
+        }
+        return ret;
+    }
+
+    /* Hand read values back to the caller */
+    for (i = 0; i < txn->num_ops; ++i) {
+        if (txn->dest [i] != NULL) {
+            *txn->dest [i] = txn->ops [i].data;
+        }
+    }
+
+    if (self->shadow_regs != NULL) {
+        for (i = 0; i < txn->num_ops; ++i) {
+            const smio_thsafe_txn_op_t *op = &txn->ops [i];
+            uint32_t value;
+
+            switch (op->type) {
+                case THSAFE_TXN_OP_WRITE_32:
+                    value = wdata [i];
+                    break;
+                case THSAFE_TXN_OP_RMW_32:
+                    value = (op->data & ~op->mask) | (wdata [i] & op->mask);
+                    break;
+                default:
+                    continue;
+            }
+            _smio_shadow_update (self, op->offs, sizeof (value), &value);
+        }
+    }
+
+    return ret;
+}
+
+/**** Register shadow ****/
+void smio_shadow_free (smio_t *self)
+{
+    assert (self);
+
+    free (self->shadow_regs);
+    self->shadow_regs = NULL;
+    free (self->shadow_flags);
+    self->shadow_flags = NULL;
+    self->shadow_num_regs = 0;
+    self->shadow_offs = 0;
+}
+
+/* Returns the index of the shadowed register at address offs (base
+ * address included) or -1 if it is not shadowed */
+static int64_t _smio_shadow_idx (smio_t *self, uint64_t offs)
+{
+    if (self->shadow_regs == NULL || offs < self->shadow_offs ||
+            (offs - self->shadow_offs) % sizeof (uint32_t) != 0) {
+        return -1;
+    }
+
+    uint64_t idx = (offs - self->shadow_offs) / sizeof (uint32_t);
+    return (idx < self->shadow_num_regs)? (int64_t) idx : -1;
+}
+
+/* Update the shadowed registers overlapping [offs, offs+size) with data.
+ * If data is NULL, the registers are invalidated and will be read from
+ * hardware on the next access */
+static void _smio_shadow_update (smio_t *self, uint64_t offs, size_t size,
+        const uint32_t *data)
+{
+    if (self->shadow_regs == NULL || size == 0) {
+        return;
+    }
+
+    uint64_t shadow_end = self->shadow_offs +
+        self->shadow_num_regs * sizeof (uint32_t);
+    if (offs + size <= self->shadow_offs || offs >= shadow_end) {
+        return;
+    }
+
+    /* Whole 32-bit registers are only updated for aligned accesses */
+    bool aligned = (data != NULL) &&
+        ((offs - self->shadow_offs) % sizeof (uint32_t) == 0) &&
+        (size % sizeof (uint32_t) == 0);
+
+    uint64_t addr = (offs < self->shadow_offs)? self->shadow_offs :
+        offs - (offs - self->shadow_offs) % sizeof (uint32_t);
+    for (; addr < offs + size && addr < shadow_end; addr += sizeof (uint32_t)) {
+        uint64_t idx = (addr - self->shadow_offs) / sizeof (uint32_t);
+
+        if (aligned) {
+            self->shadow_regs [idx] = data [(addr - offs) / sizeof (uint32_t)];
+            self->shadow_flags [idx] |= SMIO_SHADOW_VALID;
+        }
+        else {
+            self->shadow_flags [idx] &= ~SMIO_SHADOW_VALID;
+        }
+    }
+}
+
+smio_err_e smio_shadow_init (smio_t *self, uint64_t offs, uint32_t num_regs)
+{
+    assert (self);
+    smio_err_e err = SMIO_SUCCESS;
+
+    smio_shadow_free (self);
+    ASSERT_TEST(num_regs > 0, "Register shadow must have at least one register",
+            err_num_regs, SMIO_ERR_WRONG_PARAM);
+
+    self->shadow_regs = zmalloc (num_regs * sizeof (*self->shadow_regs));
+    ASSERT_ALLOC(self->shadow_regs, err_regs_alloc, SMIO_ERR_ALLOC);
+    self->shadow_flags = zmalloc (num_regs * sizeof (*self->shadow_flags));
+    ASSERT_ALLOC(self->shadow_flags, err_flags_alloc, SMIO_ERR_ALLOC);
+
+    /* Populate the shadow with a single block read. Registers are
+     * only marked valid afterwards, so this goes to hardware */
+    size_t size = num_regs * sizeof (uint32_t);
+    ssize_t ret = smio_thsafe_client_read_block (self, offs, size,
+            self->shadow_regs);
+    ASSERT_TEST(ret >= 0 && (size_t) ret == size, "Could not read registers "
+            "to populate the shadow", err_read_regs, SMIO_ERR_LLIO);
+
+    self->shadow_offs = self->base | offs;
+    self->shadow_num_regs = num_regs;
+    memset (self->shadow_flags, SMIO_SHADOW_VALID, num_regs);
+
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_INFO, "[sm_io] Shadowing %u registers "
+            "starting at address 0x%"PRIx64"\n", num_regs, self->shadow_offs);
+    return err;
+
+err_read_regs:
+err_flags_alloc:
+err_regs_alloc:
+    smio_shadow_free (self);
+err_num_regs:
+    return err;
+}
+
+smio_err_e smio_shadow_set_volatile (smio_t *self, uint64_t offs, uint32_t num_regs)
+{
+    assert (self);
+
+    uint32_t i;
+    for (i = 0; i < num_regs; ++i) {
+        int64_t idx = _smio_shadow_idx (self,
+                (self->base | offs) + i * sizeof (uint32_t));
+        if (idx < 0) {
+            return SMIO_ERR_WRONG_PARAM;
+        }
+        self->shadow_flags [idx] = SMIO_SHADOW_VOLATILE;
+    }
+
+    return SMIO_SUCCESS;
+}
+
+void smio_shadow_invalidate (smio_t *self)
+{
+    assert (self);
+
+    uint32_t i;
+    for (i = 0; i < self->shadow_num_regs; ++i) {
+        self->shadow_flags [i] &= ~SMIO_SHADOW_VALID;
+    }
+}
+
+void smio_shadow_setup (smio_t *self, uint64_t offs, uint32_t num_regs,
+        const smio_shadow_range_t *volatile_regs, uint32_t num_volatile)
+{
+    assert (self);
+
+    smio_err_e err = smio_shadow_init (self, offs, num_regs);
+    uint32_t i;
+    for (i = 0; i < num_volatile && err == SMIO_SUCCESS; ++i) {
+        err = smio_shadow_set_volatile (self, volatile_regs [i].offs,
+                volatile_regs [i].num_regs);
+    }
+
+    if (err != SMIO_SUCCESS) {
+        DBE_DEBUG (DBG_SM_IO | DBG_LVL_WARN, "[sm_io] %s: Could not initialize "
+                "register shadow. Registers will be read from hardware\n",
+                self->name);
+        smio_shadow_free (self);
+    }
+}
+
+int smio_shadow_resync_exp (void *owner, void *args, void *ret)
+{
+    (void) args;
+    (void) ret;
+    assert (owner);
+
+    SMIO_OWNER_TYPE *self = SMIO_EXP_OWNER(owner);
+    DBE_DEBUG (DBG_SM_IO | DBG_LVL_TRACE, "[sm_io] %s: Resyncing register "
+            "shadow\n", self->name);
+    smio_shadow_invalidate (self);
+
+    return -RW_OK;
+}
+
+ssize_t smio_thsafe_client_read_32_shadow (smio_t *self, uint64_t offs, uint32_t *data)
+{
+    assert (self);
+    assert (data);
+
+    int64_t idx = _smio_shadow_idx (self, self->base | offs);
+    if (idx < 0 || (self->shadow_flags [idx] & SMIO_SHADOW_VOLATILE)) {
+        return smio_thsafe_client_read_32 (self, offs, data);
+    }
+
+    if (self->shadow_flags [idx] & SMIO_SHADOW_VALID) {
+        *data = self->shadow_regs [idx];
+        return sizeof (*data);
+    }
+
+    ssize_t ret = smio_thsafe_client_read_32 (self, offs, data);
+    if (ret == sizeof (*data)) {
+        self->shadow_regs [idx] = *data;
+        self->shadow_flags [idx] |= SMIO_SHADOW_VALID;
+    }
+
+    return ret;
+}
+